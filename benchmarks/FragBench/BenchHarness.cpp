@@ -0,0 +1,119 @@
+#include "BenchHarness.h"
+
+#include <cstdio>
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <numeric>
+#include <thread>
+
+#include <frag/render/SimdKernels.h>
+#include <frag/memory/MemoryTracker.h>
+
+namespace fragbench {
+
+    namespace {
+        volatile uint64_t consumedValue = 0;
+
+        std::string escapeJson(std::string_view text) {
+            std::string escaped;
+            for (char c : text) {
+                if (c == '"' || c == '\\') escaped += '\\';
+                if ((unsigned char)c < 0x20) continue;
+                escaped += c;
+            }
+            return escaped;
+        }
+
+        std::string formatTime(double ns) {
+            char buffer[32];
+            if (ns >= 1e9) std::snprintf(buffer, sizeof(buffer), "%.3fs", ns / 1e9);
+            else if (ns >= 1e6) std::snprintf(buffer, sizeof(buffer), "%.3fms", ns / 1e6);
+            else if (ns >= 1e3) std::snprintf(buffer, sizeof(buffer), "%.3fus", ns / 1e3);
+            else std::snprintf(buffer, sizeof(buffer), "%.1fns", ns);
+            return buffer;
+        }
+    }
+
+    double getPercentile(const std::vector<double>& sortedSamples, double percentile) {
+        if (sortedSamples.empty()) return 0.0;
+
+        double rank = percentile / 100.0 * (double)(sortedSamples.size() - 1);
+        size_t lower = (size_t)rank;
+        size_t upper = std::min(lower + 1, sortedSamples.size() - 1);
+        double weight = rank - (double)lower;
+        return sortedSamples[lower] * (1.0 - weight) + sortedSamples[upper] * weight;
+    }
+
+    BenchResult runBenchmark(const Benchmark& benchmark, const BenchOptions& options) {
+        for (int i = 0; i < options.warmupRuns; i++) {
+            if (benchmark.setup) benchmark.setup();
+            benchmark.run();
+        }
+
+        std::vector<double> samples;
+        samples.reserve(options.repetitions);
+        for (int i = 0; i < options.repetitions; i++) {
+            if (benchmark.setup) benchmark.setup();
+
+            auto start = std::chrono::steady_clock::now();
+            benchmark.run();
+            auto end = std::chrono::steady_clock::now();
+            samples.push_back(std::chrono::duration<double, std::nano>(end - start).count());
+        }
+        std::sort(samples.begin(), samples.end());
+
+        BenchResult result;
+        result.name = benchmark.name;
+        result.itemsPerRun = benchmark.itemsPerRun;
+        result.repetitions = (int)samples.size();
+        if (samples.empty()) return result;
+
+        result.minNs = samples.front();
+        result.maxNs = samples.back();
+        result.meanNs = std::accumulate(samples.begin(), samples.end(), 0.0) / (double)samples.size();
+        result.p50Ns = getPercentile(samples, 50.0);
+        result.p90Ns = getPercentile(samples, 90.0);
+        result.p99Ns = getPercentile(samples, 99.0);
+        if (result.p50Ns > 0.0) result.itemsPerSecond = (double)benchmark.itemsPerRun * 1e9 / result.p50Ns;
+        return result;
+    }
+
+    void printResult(const BenchResult& result) {
+        // Slow benchmarks (like whole frames) would only show 0.000 in millions
+        bool inMillions = result.itemsPerSecond >= 1e5;
+        std::printf("%-48s p50 %12s  p90 %12s  p99 %12s  min %12s  %10.3f %sitems/s\n", result.name.c_str(),
+            formatTime(result.p50Ns).c_str(), formatTime(result.p90Ns).c_str(), formatTime(result.p99Ns).c_str(),
+            formatTime(result.minNs).c_str(), inMillions ? result.itemsPerSecond / 1e6 : result.itemsPerSecond, inMillions ? "M " : "");
+        std::fflush(stdout);
+    }
+
+    bool writeJson(const std::filesystem::path& path, const std::vector<BenchResult>& results) {
+        std::ofstream file(path);
+        if (!file) return false;
+
+        file << "{\n";
+        file << "  \"context\": {\n";
+        file << "    \"simd_level\": \"" << frag::getSimdLevelName(frag::getSimdLevel()) << "\",\n";
+        file << "    \"hardware_threads\": " << std::thread::hardware_concurrency() << ",\n";
+        file << "    \"memory_tracking\": " << (frag::memory_isTrackingEnabled() ? "true" : "false") << "\n";
+        file << "  },\n";
+        file << "  \"benchmarks\": [\n";
+        for (size_t i = 0; i < results.size(); i++) {
+            const BenchResult& result = results[i];
+            file << "    { \"name\": \"" << escapeJson(result.name) << "\", \"items_per_run\": " << result.itemsPerRun
+                 << ", \"repetitions\": " << result.repetitions << ", \"unit\": \"ns\""
+                 << ", \"min\": " << result.minNs << ", \"mean\": " << result.meanNs << ", \"p50\": " << result.p50Ns
+                 << ", \"p90\": " << result.p90Ns << ", \"p99\": " << result.p99Ns << ", \"max\": " << result.maxNs
+                 << ", \"items_per_second\": " << result.itemsPerSecond << " }" << (i + 1 < results.size() ? "," : "") << "\n";
+        }
+        file << "  ]\n";
+        file << "}\n";
+        return (bool)file;
+    }
+
+    void consume(uint64_t value) {
+        consumedValue = consumedValue + value;
+    }
+
+}
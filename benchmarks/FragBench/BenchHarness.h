@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <string>
+#include <memory>
+#include <vector>
+#include <functional>
+#include <filesystem>
+
+/*
+    Tiny benchmark harness of FragBench, no external library needed.
+
+    - A benchmark is a run function (the measured part) and an optional setup function that is called
+      before every run without being measured.
+    - Every benchmark is run warmupRuns times first (caches, pools, lazy init), then repetitions times.
+      Every run is one sample, the results are min / mean / p50 / p90 / p99 / max over the samples.
+    - itemsPerRun turns the samples into a throughput (items per second), e.g. messages or pixels.
+*/
+
+namespace fragbench {
+
+    struct Benchmark {
+        std::string name;               // "group/case", filtered by substring
+        uint64_t itemsPerRun = 1;
+        std::function<void()> setup;    // Optional, not measured
+        std::function<void()> run;
+    };
+
+    struct BenchOptions {
+        int warmupRuns = 3;
+        int repetitions = 30;
+        std::string filter;             // Only benchmarks whose name contains it, empty = all
+        std::filesystem::path jsonPath; // Empty = no JSON file
+    };
+
+    struct BenchResult {
+        std::string name;
+        uint64_t itemsPerRun = 0;
+        int repetitions = 0;
+        // Time per run in nanoseconds
+        double minNs = 0.0;
+        double meanNs = 0.0;
+        double p50Ns = 0.0;
+        double p90Ns = 0.0;
+        double p99Ns = 0.0;
+        double maxNs = 0.0;
+        double itemsPerSecond = 0.0;    // Based on p50
+    };
+
+    // Linear interpolation between the two closest ranks, samples have to be sorted
+    double getPercentile(const std::vector<double>& sortedSamples, double percentile);
+
+    BenchResult runBenchmark(const Benchmark& benchmark, const BenchOptions& options);
+    void printResult(const BenchResult& result);
+    bool writeJson(const std::filesystem::path& path, const std::vector<BenchResult>& results);
+
+    // Keeps the compiler from optimizing a result away
+    void consume(uint64_t value);
+
+    // State of a group of benchmarks, created by the setup of the first one that runs (so it isn't measured).
+    // So --list and --filter don't pay for the buffers, threads and engine parts of benchmarks that don't run.
+    // Benchmarks run one after another, so get() doesn't need to be thread-safe.
+    template<typename State>
+    class LazyState {
+        public:
+            State& get() {
+                if (!state) state = std::make_unique<State>();
+                return *state;
+            }
+
+        private:
+            std::unique_ptr<State> state;
+    };
+
+    // Benchmarks of the single files
+    void addLoggerBenchmarks(std::vector<Benchmark>& benchmarks);
+    void addPackageBenchmarks(std::vector<Benchmark>& benchmarks);
+    void addRenderBenchmarks(std::vector<Benchmark>& benchmarks);
+    void addFrameLoopBenchmarks(std::vector<Benchmark>& benchmarks);
+
+}
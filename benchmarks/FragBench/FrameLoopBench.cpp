@@ -0,0 +1,94 @@
+#include "BenchHarness.h"
+
+#include <algorithm>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+#include <frag/Core.h>
+
+namespace fragbench {
+
+    namespace {
+        constexpr unsigned long long FRAMES_PER_RUN = 60;
+        constexpr size_t ENTITY_COUNT = 5000;
+
+        struct Entity {
+            float x = 0.0f;
+            float y = 0.0f;
+            float velocityX = 0.0f;
+            float velocityY = 0.0f;
+            frag::Color color;
+        };
+
+        // A headless Core with the default SoftwareRenderModule, a simulation in the update callback
+        // and all entities drawn through the Renderer every frame
+        struct FrameLoopBenchState {
+            frag::Core core;
+            std::vector<Entity> entities;
+
+            FrameLoopBenchState() {
+                core.setHeadless(true);
+                core.setFrameMode(frag::FrameMode::FIXED, 60);
+                core.initRenderModule(100, 16, 9, 1280);
+
+                const frag::RenderSettings& settings = core.getRenderSettings();
+                for (size_t i = 0; i < ENTITY_COUNT; i++) {
+                    Entity entity;
+                    entity.x = (float)(i * 37 % settings.width);
+                    entity.y = (float)(i * 91 % settings.height);
+                    entity.velocityX = (float)(i % 13) * 10.0f - 60.0f;
+                    entity.velocityY = (float)(i % 7) * 10.0f - 30.0f;
+                    entity.color = { (uint8_t)(i * 5), (uint8_t)(i * 11), (uint8_t)(i * 17), (uint8_t)(i % 4 == 0 ? 140 : 255) };
+                    entities.push_back(entity);
+                }
+
+                core.setUpdateCallback([this](double deltaTime) { update((float)deltaTime); });
+                core.setRenderCallback([this](double) { render(); });
+            }
+
+            void update(float deltaTime) {
+                const frag::RenderSettings& settings = core.getRenderSettings();
+                for (Entity& entity : entities) {
+                    entity.x += entity.velocityX * deltaTime;
+                    entity.y += entity.velocityY * deltaTime;
+                    if (entity.x < 0.0f || entity.x > (float)settings.width) entity.velocityX = -entity.velocityX;
+                    if (entity.y < 0.0f || entity.y > (float)settings.height) entity.velocityY = -entity.velocityY;
+                }
+            }
+
+            void render() {
+                core.getRenderer().clear(frag::Color{ 16, 16, 24 });
+
+                // The visible entities are collected in frame scratch memory first, like a game would cull them
+                const frag::RenderSettings& settings = core.getRenderSettings();
+                std::pmr::vector<uint32_t> visible(&core.getFrameArena());
+                visible.reserve(entities.size());
+                for (uint32_t i = 0; i < entities.size(); i++) {
+                    const Entity& entity = entities[i];
+                    if (entity.x > -12.0f && entity.y > -12.0f && entity.x < (float)settings.width && entity.y < (float)settings.height) visible.push_back(i);
+                }
+
+                // Drawn back to front by y, the Renderer sorts them
+                frag::CommandBuffer& commands = core.getRenderer().getCommandBuffer();
+                for (uint32_t index : visible) {
+                    const Entity& entity = entities[index];
+                    commands.drawRect(entity.color, (int)entity.x, (int)entity.y, 12, 12, frag::DrawOrder{ 0, (uint32_t)std::max(entity.y, 0.0f), 0 });
+                }
+            }
+        };
+    }
+
+    void addFrameLoopBenchmarks(std::vector<Benchmark>& benchmarks) {
+        auto lazyState = std::make_shared<LazyState<FrameLoopBenchState>>();
+        auto createState = [lazyState]() { lazyState->get(); };
+
+        // Items are frames, so items/s is the frame rate the engine reaches without a window
+        benchmarks.push_back({ "frame_loop/headless_5k_rects_720p", FRAMES_PER_RUN, createState, [lazyState]() {
+            frag::Core& core = lazyState->get().core;
+            core.stepFrames(FRAMES_PER_RUN, 1.0 / 60.0);
+            consume(core.getFrameCount());
+        } });
+    }
+
+}
@@ -0,0 +1,93 @@
+#include "BenchHarness.h"
+
+#include <cstdio>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <frag/Log.h>
+
+namespace fragbench {
+
+    namespace {
+        constexpr uint64_t MESSAGES_PER_RUN = 200000;
+
+        // Counts the lines of the bench channel (the end of a run is when all of them arrived),
+        // everything else the engine logs goes to stderr
+        class CountingLogSink : public frag::ILogSink {
+            public:
+                void write(std::string_view lines) override {
+                    uint64_t benchLines = 0;
+                    while (!lines.empty()) {
+                        size_t end = lines.find('\n');
+                        std::string_view line = lines.substr(0, end == std::string_view::npos ? lines.size() : end + 1);
+                        lines.remove_prefix(line.size());
+
+                        if (line.find("[bench]") != std::string_view::npos) benchLines++;
+                        else std::fwrite(line.data(), 1, line.size(), stderr);
+                    }
+                    countedLines.fetch_add(benchLines, std::memory_order_release);
+                }
+                void flush() override {
+                    std::fflush(stderr);
+                }
+
+                uint64_t getCountedLines() const {
+                    return countedLines.load(std::memory_order_acquire);
+                }
+
+            private:
+                std::atomic<uint64_t> countedLines = 0;
+        };
+
+        struct LoggerBenchState {
+            std::shared_ptr<CountingLogSink> sink = std::make_shared<CountingLogSink>();
+            frag::LogChannel channel = frag::logging_registerChannel("bench");
+
+            // Only the counting sink, the console would measure the terminal instead of the logger
+            LoggerBenchState() {
+                frag::logging_clearSinks();
+                frag::logging_addSink(sink);
+                frag::logging_setBackpressurePolicy(frag::LogBackpressure::BLOCK);
+            }
+        };
+
+        // Producers log their share, the run ends once the logging thread wrote every message into the sink
+        void runProducers(LoggerBenchState& state, int producerCount, bool deferred) {
+            frag::logging_enableDeferredFormatting(deferred);
+            uint64_t target = state.sink->getCountedLines() + MESSAGES_PER_RUN;
+            uint64_t perProducer = MESSAGES_PER_RUN / producerCount;
+
+            std::vector<std::thread> producers;
+            producers.reserve(producerCount);
+            for (int i = 0; i < producerCount; i++) {
+                uint64_t count = i == 0 ? MESSAGES_PER_RUN - perProducer * (producerCount - 1) : perProducer;
+                producers.emplace_back([&state, i, count]() {
+                    for (uint64_t message = 0; message < count; message++) {
+                        frag::logInfo(state.channel, "Bench message {} of producer {}, value {:.3f}", message, i, message * 0.25);
+                    }
+                });
+            }
+            for (std::thread& producer : producers) producer.join();
+
+            while (state.sink->getCountedLines() < target) std::this_thread::yield();
+            frag::logging_enableDeferredFormatting(true);
+        }
+    }
+
+    void addLoggerBenchmarks(std::vector<Benchmark>& benchmarks) {
+        auto state = std::make_shared<LazyState<LoggerBenchState>>();
+        auto createState = [state]() { state->get(); };
+
+        for (int producerCount : { 1, 2, 4, 8 }) {
+            benchmarks.push_back({ "logger/throughput/" + std::to_string(producerCount) + "_producers", MESSAGES_PER_RUN, createState,
+                [state, producerCount]() { runProducers(state->get(), producerCount, true); } });
+        }
+        benchmarks.push_back({ "logger/throughput/4_producers_eager_format", MESSAGES_PER_RUN, createState,
+            [state]() { runProducers(state->get(), 4, false); } });
+    }
+
+}
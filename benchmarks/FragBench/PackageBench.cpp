@@ -0,0 +1,110 @@
+#include "BenchHarness.h"
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <string>
+
+#include <frag/job/JobSystem.h>
+#include <frag/package/IPackage.h>
+#include <frag/package/PackageRegistry.h>
+
+namespace fragbench {
+
+    namespace {
+        constexpr int PACKAGE_COUNT = 4;
+        constexpr int ASSETS_PER_PACKAGE = 4096;
+        constexpr size_t TOTAL_ASSETS = (size_t)PACKAGE_COUNT * ASSETS_PER_PACKAGE;
+
+        std::string getAssetName(int index) {
+            return "Asset_" + std::to_string(index);
+        }
+
+        class BenchPackage : public frag::IPackage {
+            public:
+                explicit BenchPackage(std::string name) : name(std::move(name)) {}
+
+                void setupPackage() override {
+                    rPackageName(name);
+                    for (int i = 0; i < ASSETS_PER_PACKAGE; i++) {
+                        rAsset(i % 4, getAssetName(i), "assets/" + name + "/" + std::to_string(i) + ".bin");
+                    }
+                    finishPackage();
+                }
+
+            private:
+                std::string name;
+        };
+
+        struct PackageBenchState {
+            frag::JobSystem jobSystem{ 0 };  // Only needed to load the packages, no extra threads
+            frag::PackageRegistry registry;
+            const frag::IPackage* firstPackage = nullptr;
+
+            std::vector<std::string> names;         // Of the assets of one package
+            std::vector<frag::FragHash> nameHashes; // Shuffled
+            std::vector<frag::FragHash> keys;       // Of all packages, shuffled
+            std::vector<frag::FragHash> missingKeys;
+
+            PackageBenchState() {
+                for (int i = 0; i < PACKAGE_COUNT; i++) {
+                    std::string packageName = "BenchPackage" + std::to_string(i);
+                    registry.addPackage(packageName, std::make_unique<BenchPackage>(packageName));
+                }
+                registry.loadPackages(jobSystem);
+                firstPackage = registry.getPackage(frag::fragHash("BenchPackage0"));
+
+                std::mt19937_64 random(42);
+                for (int i = 0; i < ASSETS_PER_PACKAGE; i++) {
+                    names.push_back(getAssetName(i));
+                    nameHashes.push_back(frag::fragHash(names.back()));
+                }
+                for (int i = 0; i < PACKAGE_COUNT; i++) {
+                    const frag::IPackage* package = registry.getPackage(frag::fragHash("BenchPackage" + std::to_string(i)));
+                    for (frag::FragHash nameHash : nameHashes) keys.push_back(package->getKey(nameHash));
+                }
+                for (size_t i = 0; i < keys.size(); i++) missingKeys.push_back(random() | 1);
+
+                std::shuffle(nameHashes.begin(), nameHashes.end(), random);
+                std::shuffle(keys.begin(), keys.end(), random);
+            }
+        };
+    }
+
+    void addPackageBenchmarks(std::vector<Benchmark>& benchmarks) {
+        auto lazyState = std::make_shared<LazyState<PackageBenchState>>();
+        auto createState = [lazyState]() { lazyState->get(); };
+
+        benchmarks.push_back({ "package/hash_names", ASSETS_PER_PACKAGE, createState, [lazyState]() {
+            PackageBenchState& state = lazyState->get();
+            uint64_t sum = 0;
+            for (const std::string& name : state.names) sum += frag::fragHash(name);
+            consume(sum);
+        } });
+        benchmarks.push_back({ "package/package_lookup_hit", ASSETS_PER_PACKAGE, createState, [lazyState]() {
+            PackageBenchState& state = lazyState->get();
+            uint64_t sum = 0;
+            for (frag::FragHash nameHash : state.nameHashes) sum += state.firstPackage->getAssetType(nameHash);
+            consume(sum);
+        } });
+        benchmarks.push_back({ "package/registry_lookup_hit", TOTAL_ASSETS, createState, [lazyState]() {
+            PackageBenchState& state = lazyState->get();
+            uint64_t sum = 0;
+            for (frag::FragHash key : state.keys) sum += state.registry.getAssetType(key);
+            consume(sum);
+        } });
+        benchmarks.push_back({ "package/registry_lookup_miss", TOTAL_ASSETS, createState, [lazyState]() {
+            PackageBenchState& state = lazyState->get();
+            uint64_t sum = 0;
+            for (frag::FragHash key : state.missingKeys) sum += state.registry.getAssetType(key);
+            consume(sum);
+        } });
+        benchmarks.push_back({ "package/registry_asset_path", TOTAL_ASSETS, createState, [lazyState]() {
+            PackageBenchState& state = lazyState->get();
+            uint64_t sum = 0;
+            for (frag::FragHash key : state.keys) sum += state.registry.getAssetPath(key).size();
+            consume(sum);
+        } });
+    }
+
+}
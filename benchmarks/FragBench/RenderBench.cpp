@@ -0,0 +1,122 @@
+#include "BenchHarness.h"
+
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <frag/job/JobSystem.h>
+#include <frag/render/RenderStructs.h>
+#include <frag/render/SimdKernels.h>
+#include <frag/render/modules/SoftwareRenderModule.h>
+
+namespace fragbench {
+
+    namespace {
+        constexpr size_t KERNEL_WIDTH = 1920;
+        constexpr size_t KERNEL_HEIGHT = 1080;
+        constexpr size_t KERNEL_PIXELS = KERNEL_WIDTH * KERNEL_HEIGHT;
+
+        constexpr int MODULE_WIDTH = 1280;
+        constexpr int MODULE_HEIGHT = 720;
+        constexpr size_t MODULE_RECTS = 10000;
+
+        struct KernelBenchState {
+            std::vector<uint32_t> destination = std::vector<uint32_t>(KERNEL_PIXELS, 0xFF203040);
+            std::vector<uint32_t> source = std::vector<uint32_t>(KERNEL_PIXELS);
+
+            KernelBenchState() {
+                std::mt19937 random(7);
+                for (uint32_t& pixel : source) {
+                    frag::Color color = { (uint8_t)random(), (uint8_t)random(), (uint8_t)random(), (uint8_t)random() };
+                    pixel = color.premultiplied().pack(frag::PixelFormat::BGRA8_PREMULTIPLIED);
+                }
+            }
+        };
+
+        struct ModuleBenchState {
+            frag::JobSystem jobSystem;
+            frag::SoftwareRenderModule module;
+            std::vector<frag::RectInstance> rects;
+            std::vector<frag::RectInstance> movedRects;
+            int frame = 0;
+
+            ModuleBenchState() {
+                auto result = module.init(frag::RenderSettings{ MODULE_WIDTH, MODULE_HEIGHT, 100, &jobSystem });
+                if (!result) std::fprintf(stderr, "Cannot set up the software renderer: %s\n", result.error().c_str());
+
+                std::mt19937 random(11);
+                for (size_t i = 0; i < MODULE_RECTS; i++) {
+                    frag::Color color = { (uint8_t)random(), (uint8_t)random(), (uint8_t)random(), (uint8_t)(i % 3 == 0 ? 160 : 255) };
+                    rects.push_back({ (int)(random() % MODULE_WIDTH) - 16, (int)(random() % MODULE_HEIGHT) - 16,
+                        4 + (int)(random() % 60), 4 + (int)(random() % 60), color });
+                }
+                movedRects = rects;
+            }
+
+            // Unchanged frames are skipped by the module, so every frame moves the rects a bit
+            void moveRects() {
+                frame++;
+                for (size_t i = 0; i < rects.size(); i++) {
+                    movedRects[i].x = rects[i].x + frame % 8;
+                }
+            }
+        };
+
+        void addKernelBenchmarks(std::vector<Benchmark>& benchmarks, std::shared_ptr<LazyState<KernelBenchState>> state, frag::SimdLevel level) {
+            std::string suffix = std::string("/") + frag::getSimdLevelName(level);
+            auto useLevel = [level, state]() {
+                frag::setSimdLevel(level);
+                state->get();
+            };
+            uint32_t color = frag::Color{ 200, 120, 40, 128 }.premultiplied().pack(frag::PixelFormat::BGRA8_PREMULTIPLIED);
+
+            benchmarks.push_back({ "kernels/fill_1080p" + suffix, KERNEL_PIXELS, useLevel, [state]() {
+                frag::fillSpan(state->get().destination.data(), KERNEL_PIXELS, 0xFF102030);
+            } });
+            benchmarks.push_back({ "kernels/blend_span_1080p" + suffix, KERNEL_PIXELS, useLevel, [state, color]() {
+                frag::blendSpan(state->get().destination.data(), KERNEL_PIXELS, color);
+            } });
+            benchmarks.push_back({ "kernels/blend_pixels_1080p" + suffix, KERNEL_PIXELS, useLevel, [state]() {
+                KernelBenchState& buffers = state->get();
+                frag::blendPixels(buffers.destination.data(), buffers.source.data(), KERNEL_PIXELS);
+            } });
+            benchmarks.push_back({ "kernels/gradient_1080p" + suffix, KERNEL_PIXELS, useLevel, [state, color]() {
+                uint32_t* destination = state->get().destination.data();
+                uint32_t step = (256u << 16) / KERNEL_WIDTH;
+                for (size_t y = 0; y < KERNEL_HEIGHT; y++) {
+                    frag::gradientSpan(destination + y * KERNEL_WIDTH, KERNEL_WIDTH, 0xFF000000, color, 0, step);
+                }
+            } });
+            benchmarks.push_back({ "kernels/convert_rgba_to_bgra_premul_1080p" + suffix, KERNEL_PIXELS, useLevel, [state]() {
+                KernelBenchState& buffers = state->get();
+                frag::convertPixels(buffers.destination.data(), buffers.source.data(), KERNEL_PIXELS,
+                    frag::PixelFormat::RGBA8, frag::PixelFormat::BGRA8_PREMULTIPLIED);
+            } });
+        }
+    }
+
+    void addRenderBenchmarks(std::vector<Benchmark>& benchmarks) {
+        auto kernelState = std::make_shared<LazyState<KernelBenchState>>();
+
+        // Every level the CPU supports, so the gain of the SIMD versions is visible next to the scalar reference
+        frag::SimdLevel supported = frag::getSupportedSimdLevel();
+        for (int level = 0; level <= (int)supported; level++) {
+            addKernelBenchmarks(benchmarks, kernelState, (frag::SimdLevel)level);
+        }
+
+        auto moduleState = std::make_shared<LazyState<ModuleBenchState>>();
+        auto bestLevel = [supported, moduleState]() {
+            frag::setSimdLevel(supported);
+            moduleState->get().moveRects();
+        };
+        benchmarks.push_back({ "render/software_10k_rects_720p", MODULE_RECTS, bestLevel, [moduleState]() {
+            ModuleBenchState& state = moduleState->get();
+            state.module.fillColor(frag::Color{ 20, 20, 30 });
+            state.module.fillRects(state.movedRects);
+            consume(state.module.swapBuffers());
+        } });
+    }
+
+}
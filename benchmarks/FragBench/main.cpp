@@ -0,0 +1,65 @@
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "BenchHarness.h"
+
+/*
+    FragBench - Benchmarks of the Fragmental Engine
+    Usage: FragBench [--filter <text>] [--repetitions <n>] [--warmup <n>] [--json <file>] [--list]
+
+    e.g. "FragBench --filter kernels/ --json kernels.json" only runs the render kernels and writes the results
+    into kernels.json, to compare them with the results of another build.
+*/
+
+int main(int argc, char** argv) {
+    fragbench::BenchOptions options;
+    bool listOnly = false;
+
+    for (int i = 1; i < argc; i++) {
+        std::string_view argument = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (argument == "--filter" && hasValue) options.filter = argv[++i];
+        else if (argument == "--repetitions" && hasValue) options.repetitions = std::max(1, std::atoi(argv[++i]));
+        else if (argument == "--warmup" && hasValue) options.warmupRuns = std::max(0, std::atoi(argv[++i]));
+        else if (argument == "--json" && hasValue) options.jsonPath = argv[++i];
+        else if (argument == "--list") listOnly = true;
+        else {
+            std::fprintf(stderr, "Usage: FragBench [--filter <text>] [--repetitions <n>] [--warmup <n>] [--json <file>] [--list]\n");
+            return 1;
+        }
+    }
+
+    // Only names and run functions, the state of a benchmark is created when it runs (see LazyState).
+    // The logger benchmarks go first, once they run they replace the console sink of the logger.
+    std::vector<fragbench::Benchmark> benchmarks;
+    fragbench::addLoggerBenchmarks(benchmarks);
+    fragbench::addPackageBenchmarks(benchmarks);
+    fragbench::addRenderBenchmarks(benchmarks);
+    fragbench::addFrameLoopBenchmarks(benchmarks);
+
+    std::vector<fragbench::BenchResult> results;
+    for (const fragbench::Benchmark& benchmark : benchmarks) {
+        if (!options.filter.empty() && benchmark.name.find(options.filter) == std::string::npos) continue;
+
+        if (listOnly) {
+            std::printf("%s\n", benchmark.name.c_str());
+            continue;
+        }
+        results.push_back(fragbench::runBenchmark(benchmark, options));
+        fragbench::printResult(results.back());
+    }
+
+    if (!options.jsonPath.empty() && !listOnly) {
+        if (!fragbench::writeJson(options.jsonPath, results)) {
+            std::fprintf(stderr, "Cannot write the results to '%s'.\n", options.jsonPath.string().c_str());
+            return 1;
+        }
+        std::printf("Results written to '%s'.\n", options.jsonPath.string().c_str());
+    }
+    return 0;
+}
@@ -2,8 +2,12 @@
 #include <frag/Core.h>
 #include <frag/Log.h>
 #include <frag/package/IPackage.h>
+#include <frag/asset/AssetArchive.h>
+#include <frag/profile/Profiler.h>
+#include <frag/memory/MemoryTracker.h>
 
 #include <string>
+#include <memory>
 
 #include <mutex>
 #include <thread>
@@ -11,7 +15,7 @@
 
 #include "testPackage.h"
 
-int main() {
+int main(int argc, char** argv) {
     //std::cout << "Heyyy\n" << sizeof(int) << " " << sizeof(std::mutex) << std::endl;
 
 
@@ -47,9 +51,33 @@ int main() {
     //std::cin >> lol;
 
     std::this_thread::sleep_for(std::chrono::milliseconds(1)); // Giving the logger at least a chance to start the logging thread xD
+
+    // e.g. "FragTest --pack TestPackage.fragarc" packs all assets of the TestPackage (relative to the working directory) into one archive
+    if (argc > 2 && std::string(argv[1]) == "--pack") {
+        TestPackage testPackage;
+        testPackage.setupPackage();
+        return frag::AssetArchive::pack(testPackage, ".", argv[2]) ? 0 : 1;
+    }
         
+    // e.g. "FragTest --headless" on machines without a display, stops after 5 seconds
+    // With FRAG_ENABLE_PROFILER the run is written to fragtest_trace.json
+    bool headless = argc > 1 && std::string(argv[1]) == "--headless";
+    if (headless) {
+        core.setHeadless(true);
+        core.setWallTimeLimit(5.0);
+        frag::profiling_setSummaryInterval(120);
+        frag::memory_setReportInterval(120);
+        frag::profiling_startCapture();
+    }
+
+    core.getPackageRegistry().addPackage("TestPackage", std::make_unique<TestPackage>());
+
     core.setFrameMode(frag::FrameMode::VARIABLE, 60);
     core.initAndStart("Frag Engine Test", 100, 16, 9, 1280);
 
+    if (headless) {
+        frag::profiling_exportChromeTrace("fragtest_trace.json");
+    }
+
     return 0;
 }
\ No newline at end of file
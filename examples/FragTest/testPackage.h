@@ -2,6 +2,16 @@
 
 #include <frag/package/IPackage.h>
 
+struct HealthComponent {
+    float health = 100.0f;
+    float maxHealth = 100.0f;
+};
+
+struct MovementComponent {
+    float velocityX = 0.0f;
+    float velocityY = 0.0f;
+};
+
 class TestPackage : public frag::IPackage {
 public:
     void setupPackage() override {
@@ -16,14 +26,16 @@ public:
         rAsset(0, "PlayerModel", "assets/models/player.obj");
         rAsset(1, "EnemyTexture", "assets/textures/enemy.png");
 
-        // Register Components
-        // rComponent("HealthComponent", HealthComponentClass);
-        // rComponent("MovementComponent", MovementComponentClass);
-
         // Register Scenes
         // rScene("Level1Scene", Level1SceneClass);
         // rScene("Level2Scene", Level2SceneClass);
 
         finishPackage();
     }
+
+    // Components are registered here, so the package can also be loaded from a snapshot (setupWithSnapshot)
+    void setupComponents() override {
+        rComponent<HealthComponent>("HealthComponent");
+        rComponent<MovementComponent>("MovementComponent");
+    }
 };
\ No newline at end of file
@@ -1,6 +1,16 @@
 #pragma once
 
 #include <string>
+#include <atomic>
+#include <functional>
+#include <memory>
+
+#include <frag/job/JobSystem.h>
+#include <frag/package/PackageRegistry.h>
+#include <frag/asset/AssetManager.h>
+#include <frag/render/Renderer.h>
+#include <frag/memory/LinearArena.h>
+#include <frag/memory/MemoryTracker.h>
 
 namespace frag {
 
@@ -13,23 +23,112 @@ namespace frag {
         public:
             void initAndStart(std::string gameName, int pixelPerUnit, int ratioX, int ratioY, int windowWith);
 
+            // Runs count frames right away, as fast as possible (no window, no frame pacing).
+            // Every frame simulates frameTime seconds, frameTime <= 0 uses 1 / targetFPS (or the real frame time if unlimited).
+            // Meant for servers, tests and benchmarks, does not need initAndStart.
+            void stepFrames(unsigned long long count, double frameTime = -1.0);
+            // Ends the game loop after the current frame, can be called from any thread (e.g. a signal or control thread)
+            void requestStop();
+
             // Setters
 
             // Use targetFPS < 0 for unlimited FPS. e.g.: -1
             // FIXED mode requires targetFPS > 0.
+            // FIXED: The game gets updated exactly targetFPS times per second with a constant time step.
+            // VARIABLE: One update per frame with the measured frame time, capped at targetFPS.
             void setFrameMode(FrameMode mode, int targetFPS);
 
+            // Gets called with the time step in seconds. In FIXED mode this is always 1 / targetFPS.
+            void setUpdateCallback(std::function<void(double deltaTime)> callback);
+            // alpha is how far the frame is between the last and the next fixed update (0 - 1), use it to interpolate.
+            // Always 1 in VARIABLE mode.
+            void setRenderCallback(std::function<void(double alpha)> callback);
+            // Frame times above this are clamped, so a long hitch doesn't end in an endless catch-up (spiral of death)
+            void setMaxFrameTime(double seconds);
+
+            // Headless: initAndStart runs the same game loop, but without any window (no GLFW, no display needed).
+            // Has to be set before initAndStart.
+            void setHeadless(bool headless);
+            // The game loop stops after this many frames, 0 = no limit
+            void setFrameLimit(unsigned long long maxFrames);
+            // The game loop stops after this many seconds of wall time, <= 0 = no limit
+            void setWallTimeLimit(double seconds);
+
+            // Has to be set before initAndStart, without one a SoftwareRenderModule is used
+            void setRenderModule(std::unique_ptr<IRenderModule> module);
+            // Sets up the render module (a SoftwareRenderModule if none was set) and connects it to the Renderer.
+            // initAndStart does that, call it yourself before stepFrames if the frames should be rendered.
+            bool initRenderModule(int pixelPerUnit, int ratioX, int ratioY, int windowWith);
+
+            // Amount of job threads (including the Core thread), < 0 = one per core. Has to be set before the JobSystem is used.
+            void setJobThreadCount(int threadCount);
+
+            // Getters
+
+            // Created on first use, lives as long as the Core
+            JobSystem& getJobSystem();
+            // Add packages here before initAndStart, they are loaded (in parallel) when it starts.
+            // Call loadPackages() yourself when initAndStart isn't used (e.g. stepFrames).
+            PackageRegistry& getPackageRegistry() { return packageRegistry; }
+            bool loadPackages();
+            // Created on first use (starts the I/O threads), finished assets get published at the start of every frame
+            AssetManager& getAssetManager();
+            // Scratch memory for the current frame (any thread), stays valid until the end of the next frame.
+            // Use it for temporary data instead of new/std::vector, e.g. std::pmr::vector<int> list(&core.getFrameArena());
+            LinearArena& getFrameArena() { return frameArena.getCurrent(); }
+            // Record draw commands here (from any thread), they are drawn after the render callback
+            Renderer& getRenderer() { return renderer; }
+            // nullptr until initAndStart set it up
+            IRenderModule* getRenderModule() { return renderModule.get(); }
+            const RenderSettings& getRenderSettings() const { return renderSettings; }
+            double getLastFrameTime() const { return lastFrameTime; }
+            unsigned long long getFrameCount() const { return frameCount; }
+            // False if the last frame looked exactly like the one before, it wasn't presented then
+            bool wasFramePresented() const { return framePresented; }
+            bool isHeadless() const { return headless; }
+
         private:
+            // Has to stay the first member, its leak report needs everything else to be destroyed already
+            MemoryLeakCheck memoryLeakCheck;
+
             // -- Status variables --          
             bool windowIsInitialized = false;
+            bool headless = false;
+            std::atomic<bool> stopRequested = false;    // Set by requestStop from any thread
 
             // -- General Information --
             std::string gameName;
             FrameMode frameMode = FrameMode::VARIABLE;
             int targetFPS = 60;
+            double maxFrameTime = 0.25;
+            unsigned long long frameLimit = 0;
+            double wallTimeLimit = 0.0;
+
+            // -- Jobs --
+            int jobThreadCount = -1;
+            std::unique_ptr<JobSystem> jobSystem;
+
+            // -- Packages --
+            PackageRegistry packageRegistry;
+            std::unique_ptr<AssetManager> assetManager;
+
+            // -- Rendering --
+            RenderSettings renderSettings;
+            std::unique_ptr<IRenderModule> renderModule;
+            Renderer renderer;
+
+            // -- Game Loop --
+            std::function<void(double)> updateCallback;
+            std::function<void(double)> renderCallback;
+            FrameArena frameArena;
+            double updateAccumulator = 0.0;
+            double lastFrameTime = 0.0;
+            unsigned long long frameCount = 0;
+            bool framePresented = false;
 
             int initGLFWWindow();
             void enterGameLoop();
+            void runFrame(double frameTime);
     };
     
 }
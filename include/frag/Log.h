@@ -4,252 +4,615 @@
 #include <format>
 #include <iostream>
 #include <string_view>
-#include <sstream>
 
 #include <memory>
+#include <vector>
 
 #include <thread>
 #include <mutex>
-#include <atomic>
 #include <condition_variable>
+#include <atomic>
 #include <chrono>
-
-#include <unordered_map>
+#include <algorithm>
+#include <cstring>
+
+#include <frag/log/LogLevel.h>
+#include <frag/log/LogChannel.h>
+#include <frag/log/LogRecord.h>
+#include <frag/log/LogRingBuffer.h>
+#include <frag/log/ILogSink.h>
+#include <frag/log/ConsoleLogSink.h>
+#include <frag/profile/Profiler.h>
+#include <frag/memory/MemoryTracker.h>
 
 /*
     FragLogger - A simple asynchronous logger for the Fragmental Engine
-    Uses a fixed-size stack to store log messages and a dedicated thread to process and output them.
+    Uses a preallocated lock-free ring buffer to store log messages and a dedicated thread to process and output them.
     Features:
-    - Thread-safe logging.
+    - Thread-safe logging, without any lock on the callers side.
     - Asynchronous processing to avoid blocking the main thread.
+    - Deferred formatting: the caller only copies the arguments, std::format runs on the logging thread (see LogRecord.h).
     - Log-Levels (TRACE, DEBUG, INFO, WARNING, ERROR, FATAL)
-    - Will only have an std::cout like performance impact, if there are more than STACK_SIZE logs buffered.
-        You can increase this STACK_SIZE, but keep in mind that every Item needs about 
+    - Log-Channels with their own runtime level (see LogChannel.h)
+    - Compile-time stripping of everything below FRAG_LOG_COMPILED_LEVEL (see LogLevel.h and the FRAG_LOG_* macros)
+    - Configurable queue capacity (FRAG_LOG_QUEUE_CAPACITY, or per instance via the constructor).
+    - Selectable backpressure policy for when the queue is full (see LogBackpressure).
+    - The logging thread sleeps while there is nothing to log, so an idle logger costs no CPU.
+    - Pluggable sinks (console, file with rotation, ...), lines are handed over in big batches (see ILogSink.h).
 */
 
+#ifndef FRAG_LOG_QUEUE_CAPACITY
+    #define FRAG_LOG_QUEUE_CAPACITY 1024
+#endif
+
 namespace frag {
 
-    enum class LogLevel {
-        TRACE = 6,
-        DEBUG = 5,
-        INFO = 4,
-        WARNING = 3,
-        ERROR = 2,
-        FATAL = 1,
-        NONE = 0
+    // What happens if a message gets logged while the queue is full
+    enum class LogBackpressure {
+        BLOCK,          // Wait until the logging thread made some space (no message gets lost)
+        DROP_NEWEST,    // Throw away the new message
+        DROP_OLDEST     // Throw away the oldest buffered message to make space for the new one
     };
     
     class FragLogger {
         private:
 
-            std::chrono::time_point<std::chrono::system_clock> wakeUpTime = std::chrono::system_clock::now();
+            std::chrono::steady_clock::time_point wakeUpTime = std::chrono::steady_clock::now();
 
-            std::unordered_map<LogLevel, std::string> logLevelToString = {
-                { LogLevel::TRACE, "TRACE" },
-                { LogLevel::DEBUG, "DEBUG" },
-                { LogLevel::INFO, "INFO" },
-                { LogLevel::WARNING, "WARN" },
-                { LogLevel::ERROR, "ERROR" },
-                { LogLevel::FATAL, "FATAL" }
+            // Indexed by the LogLevel value
+            static constexpr std::string_view logLevelToString[] = {
+                "", "FATAL", "ERROR", "WARN", "INFO", "DEBUG", "TRACE"
             };
-            std::unordered_map<LogLevel, std::string> logLevelToColorCode = {
-                { LogLevel::TRACE, "\e[0;30m" },   // White
-                { LogLevel::DEBUG, "\e[0;35m" },   // Cyan
-                { LogLevel::INFO, "\e[0;36m" },    // Green
-                { LogLevel::WARNING, "\033[33m" },       // Yellow
-                { LogLevel::ERROR, "\033[31m" },         // Red
-                { LogLevel::FATAL, "\e[43m\e[1;31m" },   // Magenta
-                { LogLevel::NONE, "\033[0m" }      // Reset
+            static constexpr std::string_view logLevelToColorCode[] = {
+                "\033[0m",              // NONE: Reset
+                "\e[43m\e[1;31m",       // FATAL: Magenta
+                "\033[31m",             // ERROR: Red
+                "\033[33m",             // WARNING: Yellow
+                "\e[0;36m",             // INFO: Green
+                "\e[0;35m",             // DEBUG: Cyan
+                "\e[0;30m"              // TRACE: White
             };
 
-            struct LogItem {
-                bool alive = false;
-                LogLevel level;
-                std::unique_ptr<std::string> msg;
-            };
-            
-            std::mutex writeIntoLoggerMutex;
+            LogRingBuffer<LogRecord> logQueue;
+
             std::atomic<bool> loggerThreadRunning = false;
-            size_t currentWriteIndex = 0;
-            size_t currentReadIndex = 0; // Only used for keep track which index was lastly written.
-            std::atomic<size_t> logsCounter = 0; // Counts how many logs have been written. Used for thread communication.
+            std::atomic<uint64_t> droppedLogs = 0;
+
+            // Parking of the logging thread. Producers only touch the mutex if the thread actually sleeps.
+            std::atomic<bool> loggerThreadSleeping = false;
+            std::mutex sleepMutex;
+            std::condition_variable sleepCondition;
+
+            // Parking of producers that wait for space (BLOCK policy)
+            std::atomic<uint32_t> blockedProducers = 0;
+            std::atomic<uint32_t> spaceEpoch = 0;
+
+            std::vector<std::shared_ptr<ILogSink>> sinks;
+            std::mutex sinksMutex; // Held by the logging thread while it writes a batch
+
+            // Only used by the logging thread, reused for every batch
+            static constexpr size_t BATCH_SIZE = 64 * 1024;
+            std::string messageBuffer;
+            std::string colorBatch;
+            std::string plainBatch;
+            bool batchColorized = false;
+            bool batchNeedsColor = false;
+            bool batchNeedsPlain = false;
+            bool batchHasFatal = false;
+
+            // Runtime level per channel, INHERIT_LEVEL means "use the global logLevel"
+            static constexpr int INHERIT_LEVEL = -1;
+            std::atomic<int> channelLevels[LogChannel::MAX_COUNT];
+
+            // Channel names are only written once during registration, and published by channelCount
+            static constexpr size_t CHANNEL_NAME_SIZE = 16;
+            char channelNames[LogChannel::MAX_COUNT][CHANNEL_NAME_SIZE] = {};
+            std::atomic<uint8_t> channelCount = 0;
+            std::mutex registerChannelMutex; // Registration only, never touched while logging
+
+            void setChannelName(uint8_t id, std::string_view name) {
+                size_t length = std::min(name.size(), CHANNEL_NAME_SIZE - 1);
+                std::memcpy(channelNames[id], name.data(), length);
+                channelNames[id][length] = '\0';
+            }
+
+            void wakeLoggerThread() {
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                if (loggerThreadSleeping.load(std::memory_order_relaxed)) {
+                    std::lock_guard lock(sleepMutex);
+                    sleepCondition.notify_one();
+                }
+            }
+
+            void wakeBlockedProducers() {
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                if (blockedProducers.load(std::memory_order_relaxed) > 0) {
+                    spaceEpoch.fetch_add(1, std::memory_order_release);
+                    spaceEpoch.notify_all();
+                }
+            }
+
+            // Checks which kind of lines (colored / plain) the current sinks want. sinksMutex has to be locked.
+            void prepareBatch() {
+                batchColorized = colorizedOutput.load(std::memory_order_relaxed);
+                batchNeedsColor = false;
+                batchNeedsPlain = false;
+                for (auto& sink : sinks) {
+                    if (batchColorized && sink->wantsColor()) batchNeedsColor = true;
+                    else batchNeedsPlain = true;
+                }
+            }
+
+            void appendToBatch(const LogRecord& record) {
+                messageBuffer.clear();
+                record.appendMessage(messageBuffer);
+
+                if (batchNeedsColor) formatLogMessage(record, messageBuffer, true, colorBatch);
+                if (batchNeedsPlain) formatLogMessage(record, messageBuffer, false, plainBatch);
+                if (record.level == LogLevel::FATAL) batchHasFatal = true;
+            }
+
+            // Hands the batch over to every sink. sinksMutex has to be locked.
+            void dispatchBatch() {
+                if (colorBatch.empty() && plainBatch.empty()) return;
+
+                for (auto& sink : sinks) {
+                    bool colored = batchColorized && sink->wantsColor();
+                    sink->write(colored ? colorBatch : plainBatch);
+
+                    // A fatal error is probably the last thing we log, don't let it rot in a buffer
+                    if (batchHasFatal) sink->flush();
+                }
+
+                colorBatch.clear();
+                plainBatch.clear();
+                batchHasFatal = false;
+            }
+
+            // Outputs everything that is currently in the queue, returns how many messages were written
+            size_t processQueue(uint64_t& lastReportedDrops) {
+                FRAG_PROFILE_ZONE("FragLogger::processQueue");
+                std::lock_guard lock(sinksMutex);
+                prepareBatch();
+
+                size_t written = 0;
+                while (logQueue.tryPop([this](LogRecord& record) {
+                    appendToBatch(record);
+                    record.release();
+                })) {
+                    written++;
+
+                    if (colorBatch.size() >= BATCH_SIZE || plainBatch.size() >= BATCH_SIZE) {
+                        dispatchBatch();
+                        wakeBlockedProducers();
+                    }
+                }
+
+                if (written > 0) wakeBlockedProducers();
+
+                reportDroppedLogs(lastReportedDrops);
+                dispatchBatch();
+                return written;
+            }
 
-            static constexpr size_t STACK_SIZE = 100;
-            LogItem logStack[STACK_SIZE];
+            void reportDroppedLogs(uint64_t& lastReportedDrops) {
+                uint64_t drops = droppedLogs.load(std::memory_order_relaxed);
+                if (drops == lastReportedDrops) return;
+
+                LogRecord record;
+                record.level = LogLevel::WARNING;
+                record.timestamp = std::chrono::steady_clock::now().time_since_epoch().count();
+                record.setText(std::format("FragLogger dropped {} message(s), queue is too small for the current log volume.", drops - lastReportedDrops));
+                appendToBatch(record);
+                record.release();
+
+                lastReportedDrops = drops;
+            }
+
+            // Flushes every sink whose deadline has passed, returns the next deadline
+            std::chrono::steady_clock::time_point flushDueSinks() {
+                FRAG_PROFILE_ZONE("FragLogger::flushDueSinks");
+                std::lock_guard lock(sinksMutex);
+
+                auto now = std::chrono::steady_clock::now();
+                auto nextDeadline = std::chrono::steady_clock::time_point::max();
+                for (auto& sink : sinks) {
+                    if (sink->getFlushDeadline() <= now) sink->flush();
+                    nextDeadline = std::min(nextDeadline, sink->getFlushDeadline());
+                }
+                return nextDeadline;
+            }
+
+            void flushAllSinks() {
+                std::lock_guard lock(sinksMutex);
+                for (auto& sink : sinks) sink->flush();
+            }
 
             // This thread should only run ONCE. And there should NOT be running to instances of that thread at once. Just dont do it lol
             void loggingThread() {
-                size_t lastLogCounter = 0;
-
-                //std::cout << "Starting FragLogger Thread...\n";
-                while (loggerThreadRunning) {
-                    //std::this_thread::sleep_for(std::chrono::milliseconds(100));
-
-                    if (logsCounter <= lastLogCounter) continue;; // Wait until logCounter inceases
-                    lastLogCounter++;
-                    
-                    // Logging the message and resetting the log item
-                    std::cout << *logStack[currentReadIndex].msg;
-                    
-                    logStack[currentReadIndex].alive = false;
-                    logStack[currentReadIndex].msg.reset(); // Free the memory
-
-                    currentReadIndex++;
-                    if (currentReadIndex >= STACK_SIZE) currentReadIndex = 0;
+                FRAG_PROFILE_THREAD("FragLogger");
+                MemoryTagScope memoryTag(MemoryTag::LOGGER);
+                uint64_t lastReportedDrops = 0;
+
+                while (loggerThreadRunning.load(std::memory_order_acquire)) {
+                    if (processQueue(lastReportedDrops) > 0) continue;
+
+                    // Nothing to do, go to sleep until a producer wakes us up (or a sink wants to be flushed).
+                    // The sleeping flag is set before the last empty-check, so a push in between can't get lost.
+                    auto flushDeadline = flushDueSinks();
+
+                    std::unique_lock lock(sleepMutex);
+                    loggerThreadSleeping.store(true, std::memory_order_relaxed);
+                    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+                    if (logQueue.empty() && loggerThreadRunning.load(std::memory_order_acquire)) {
+                        if (flushDeadline == std::chrono::steady_clock::time_point::max()) sleepCondition.wait(lock);
+                        else sleepCondition.wait_until(lock, flushDeadline);
+                    }
+                    loggerThreadSleeping.store(false, std::memory_order_relaxed);
                 }
-                //std::cout << "Stopping FragLogger Thread...\n";
+
+                // Make sure there are no logs left
+                processQueue(lastReportedDrops);
+                flushAllSinks();
             }
 
-            std::string formatLogMessage(const std::string& msg, LogLevel level) {
-                std::stringstream msgBuilder;
+            // Runs on the logging thread. message is the already formatted message of the record.
+            void formatLogMessage(const LogRecord& record, std::string_view message, bool colorized, std::string& out) {
+                bool colorWhole = colorWholeMessage.load(std::memory_order_relaxed);
+                int level = (int)record.level;
 
-                if (colorizedOutput && colorWholeMessage) msgBuilder << logLevelToColorCode[level];
+                if (colorized && colorWhole) out += logLevelToColorCode[level];
                 
                 // Timestamp
-                auto timeSinceStart = std::chrono::system_clock::now().time_since_epoch() - wakeUpTime.time_since_epoch();
-                int seconds = std::chrono::duration_cast<std::chrono::seconds>(timeSinceStart).count();
-                int milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(timeSinceStart).count() % 1000;
-                msgBuilder << seconds << "." << std::format("{:03}", milliseconds);
+                int64_t timeSinceStart = record.timestamp - wakeUpTime.time_since_epoch().count();
+                if (timeSinceStart < 0) timeSinceStart = 0;
+                int64_t milliseconds = timeSinceStart / 1'000'000;
+                std::format_to(std::back_inserter(out), "{}.{:03}", milliseconds / 1000, milliseconds % 1000);
 
                 // Log-Level Box
-                msgBuilder << " : [";
-                if (colorizedOutput && !colorWholeMessage) msgBuilder << logLevelToColorCode[level];
-                msgBuilder << logLevelToString[level];
-                if (colorizedOutput && !colorWholeMessage) msgBuilder << logLevelToColorCode[LogLevel::NONE];
-                msgBuilder << "]";
+                out += " : [";
+                if (colorized && !colorWhole) out += logLevelToColorCode[level];
+                out += logLevelToString[level];
+                if (colorized && !colorWhole) out += logLevelToColorCode[(int)LogLevel::NONE];
+                out += "]";
 
                 // Prefix
+                if (record.channel != LogChannel::GENERAL.id && record.channel < channelCount.load(std::memory_order_acquire)) {
+                    out += " [";
+                    out += channelNames[record.channel];
+                    out += "]";
+                }
 
                 // Message
-                msgBuilder << " " << msg;
-                if (colorizedOutput && colorWholeMessage) msgBuilder << logLevelToColorCode[LogLevel::NONE];
-                msgBuilder << "\n";
+                out += " ";
+                out += message;
+                if (colorized && colorWhole) out += logLevelToColorCode[(int)LogLevel::NONE];
+                out += "\n";
+            }
+
+            // Claims a slot for writeRecord(LogRecord&), follows the backpressure policy if the queue is full
+            template<typename Writer>
+            void pushRecord(Writer&& writeRecord) {
+                while (!logQueue.tryPush(writeRecord)) {
+                    switch (backpressure.load(std::memory_order_relaxed)) {
+                        case LogBackpressure::DROP_NEWEST:
+                            droppedLogs.fetch_add(1, std::memory_order_relaxed);
+                            wakeLoggerThread();
+                            return;
+
+                        case LogBackpressure::DROP_OLDEST:
+                            if (logQueue.tryPop([](LogRecord& record) { record.release(); })) {
+                                droppedLogs.fetch_add(1, std::memory_order_relaxed);
+                            }
+                            break;
+
+                        case LogBackpressure::BLOCK: {
+                            // Without a running logging thread nobody would ever make space again
+                            if (!loggerThreadRunning.load(std::memory_order_acquire) || std::this_thread::get_id() == loggerThread.get_id()) {
+                                droppedLogs.fetch_add(1, std::memory_order_relaxed);
+                                return;
+                            }
+
+                            blockedProducers.fetch_add(1, std::memory_order_seq_cst);
+                            uint32_t epoch = spaceEpoch.load(std::memory_order_acquire);
+                            wakeLoggerThread();
+
+                            if (!logQueue.tryPush(writeRecord)) {
+                                spaceEpoch.wait(epoch, std::memory_order_acquire);
+                                blockedProducers.fetch_sub(1, std::memory_order_relaxed);
+                                continue;
+                            }
+
+                            blockedProducers.fetch_sub(1, std::memory_order_relaxed);
+                            wakeLoggerThread();
+                            return;
+                        }
+                    }
+                }
 
-                return msgBuilder.str();
+                wakeLoggerThread();
             }
 
             std::thread loggerThread;
 
-        public:
-            FragLogger() {          
+            // The scope lives until this constructor is done, so the queue and the buffers count as logger memory
+            FragLogger(const MemoryTagScope&, size_t queueCapacity) : logQueue(queueCapacity) {
+                for (auto& channelLevel : channelLevels) channelLevel.store(INHERIT_LEVEL, std::memory_order_relaxed);
+                setChannelName(LogChannel::GENERAL.id, "general");
+                setChannelName(LogChannel::CORE.id, "core");
+                setChannelName(LogChannel::RENDER.id, "render");
+                setChannelName(LogChannel::PACKAGE.id, "package");
+                setChannelName(LogChannel::ASSET.id, "asset");
+                channelCount.store(LogChannel::BUILTIN_COUNT, std::memory_order_release);
+
+                sinks.push_back(std::make_shared<ConsoleLogSink>());
+                colorBatch.reserve(BATCH_SIZE + 4096);
+                plainBatch.reserve(BATCH_SIZE + 4096);
+
                 loggerThreadRunning = true;
                 
                 loggerThread = std::thread(&FragLogger::loggingThread, this);
-
-                std::cout << sizeof(LogItem) << "\n";
             }
+
+        public:
+            explicit FragLogger(size_t queueCapacity = FRAG_LOG_QUEUE_CAPACITY) : FragLogger(MemoryTagScope(MemoryTag::LOGGER), queueCapacity) {}
             ~FragLogger() {
-                std::cout << "Stopping logging thread, printing out last buffered messages...\n";
+                loggerThreadRunning.store(false, std::memory_order_release);
+                {
+                    std::lock_guard lock(sleepMutex);
+                    sleepCondition.notify_one();
+                }
 
-                loggerThreadRunning = false;
+                // The logging thread drains the rest of the queue and flushes every sink before it exits
                 loggerThread.join();
+            }
 
-                // Make sure there are no logs left
-                while (logStack[currentReadIndex].alive) {
-                    logStack[currentReadIndex].alive = false;
-                    std::cout << *logStack[currentReadIndex].msg;
+            std::atomic<LogLevel> logLevel = LogLevel::INFO;
+            std::atomic<bool> colorizedOutput = true;
+            std::atomic<bool> colorWholeMessage = false;
+            std::atomic<bool> deferredFormatting = true;
+            std::atomic<LogBackpressure> backpressure = LogBackpressure::BLOCK;
 
-                    currentReadIndex++;
-                    if (currentReadIndex >= STACK_SIZE) currentReadIndex = 0;
-                }
+            // Total amount of messages that got thrown away by the DROP_NEWEST / DROP_OLDEST policies
+            uint64_t getDroppedCount() const {
+                return droppedLogs.load(std::memory_order_relaxed);
+            }
+            size_t getQueueCapacity() const {
+                return logQueue.getCapacity();
             }
 
-            LogLevel logLevel = LogLevel::INFO;
-            bool colorizedOutput = true;
-            bool colorWholeMessage = false;
+            // The logger starts with a ConsoleLogSink, use clearSinks() first if you only want e.g. a file
+            void addSink(std::shared_ptr<ILogSink> sink) {
+                std::lock_guard lock(sinksMutex);
+                sinks.push_back(std::move(sink));
+            }
+            void removeSink(const std::shared_ptr<ILogSink>& sink) {
+                std::lock_guard lock(sinksMutex);
+                auto it = std::find(sinks.begin(), sinks.end(), sink);
+                if (it == sinks.end()) return;
 
-            template<typename... Args>
-            void log(std::string& msg, LogLevel level) {
-                {
-                    std::lock_guard lock(writeIntoLoggerMutex);
+                (*it)->flush();
+                sinks.erase(it);
+            }
+            void clearSinks() {
+                std::lock_guard lock(sinksMutex);
+                for (auto& sink : sinks) sink->flush();
+                sinks.clear();
+            }
 
-                    // Just making sure we don't overwrite an alive log item (very unlikely)
-                    while (logStack[currentWriteIndex].alive) {
-                        //std::cout << "LOGGING NEEDED TO WAIT dqwdij2130121euß2103ß1923ß8u34üt3r+#t34+r023ir2089r230pr293r22\n";
-                        std::this_thread::sleep_for(std::chrono::microseconds(1));
-                    }
+            bool isEnabled(LogChannel channel, LogLevel level) const {
+                int channelLevel = channelLevels[channel.id].load(std::memory_order_relaxed);
+                if (channelLevel == INHERIT_LEVEL) return level <= logLevel.load(std::memory_order_relaxed);
+                return (int)level <= channelLevel;
+            }
+
+            // Use LogLevel::NONE to mute a channel, resetChannelLogLevel to go back to the global level
+            void setChannelLogLevel(LogChannel channel, LogLevel level) {
+                channelLevels[channel.id].store((int)level, std::memory_order_relaxed);
+            }
+            void resetChannelLogLevel(LogChannel channel) {
+                channelLevels[channel.id].store(INHERIT_LEVEL, std::memory_order_relaxed);
+            }
 
-                    logStack[currentWriteIndex] = { false, LogLevel::INFO, std::make_unique<std::string>(formatLogMessage(msg, level)) };
-                    logStack[currentWriteIndex].alive = true; // Only make it alive after everthing is written to avoid race conditions
+            // Should be done during startup. Registering the same name twice returns the same channel.
+            LogChannel registerChannel(std::string_view name) {
+                std::lock_guard lock(registerChannelMutex);
 
-                    currentWriteIndex++;
-                    logsCounter++;
+                std::string_view shortName = name.substr(0, CHANNEL_NAME_SIZE - 1);
+                uint8_t count = channelCount.load(std::memory_order_acquire);
+                for (uint8_t i = 0; i < count; i++) {
+                    if (shortName == channelNames[i]) return LogChannel{ i };
+                }
 
-                    if (currentWriteIndex >= STACK_SIZE) currentWriteIndex = 0;
+                if (count >= LogChannel::MAX_COUNT) {
+                    log("Too many log channels, '" + std::string(name) + "' is logged into the general channel.", LogLevel::WARNING);
+                    return LogChannel::GENERAL;
                 }
+
+                setChannelName(count, shortName);
+                channelCount.store(count + 1, std::memory_order_release);
+                return LogChannel{ count };
+            }
+
+            template<typename... Args>
+            void log(LogLevel level, LogChannel channel, std::format_string<Args...> fmt, Args&&... args) {
+                int64_t timestamp = std::chrono::steady_clock::now().time_since_epoch().count();
+
+                if constexpr (logArgsDeferrable<Args...>) {
+                    if (deferredFormatting.load(std::memory_order_relaxed) && LogRecord::deferredSize(args...) <= LogRecord::PAYLOAD_SIZE) {
+                        pushRecord([&](LogRecord& record) {
+                            record.level = level;
+                            record.channel = channel.id;
+                            record.timestamp = timestamp;
+                            record.setDeferred(fmt.get(), args...);
+                        });
+                        return;
+                    }
+                }
+
+                // Not deferrable, format it right here. The buffer is reused so this doesn't allocate after warm-up.
+                thread_local std::string formatBuffer;
+                MemoryTagScope memoryTag(MemoryTag::LOGGER);
+                formatBuffer.clear();
+                std::format_to(std::back_inserter(formatBuffer), fmt, std::forward<Args>(args)...);
+                log(formatBuffer, level, channel, timestamp);
+            }
+
+            // Logs an already formatted message
+            void log(std::string_view msg, LogLevel level, LogChannel channel = LogChannel::GENERAL) {
+                log(msg, level, channel, std::chrono::steady_clock::now().time_since_epoch().count());
+            }
+            void log(std::string_view msg, LogLevel level, LogChannel channel, int64_t timestamp) {
+                pushRecord([&](LogRecord& record) {
+                    record.level = level;
+                    record.channel = channel.id;
+                    record.timestamp = timestamp;
+                    record.setText(msg);
+                });
             }
     };
     
     inline FragLogger fragLoggerInstance = FragLogger();
 
-    template<typename... Args>
-    inline void logInfo(std::format_string<Args...> fmt, Args&&... args){
-        if (fragLoggerInstance.logLevel < LogLevel::INFO) {
-            return;
+    // Compiles to nothing if the level is below FRAG_LOG_COMPILED_LEVEL
+    template<LogLevel level, typename... Args>
+    inline void logWithLevel(LogChannel channel, std::format_string<Args...> fmt, Args&&... args) {
+        if constexpr (logLevelCompiledIn(level)) {
+            if (!fragLoggerInstance.isEnabled(channel, level)) {
+                return;
+            }
+
+            fragLoggerInstance.log(level, channel, fmt, std::forward<Args>(args)...);
         }
+    }
 
-        std::string result = std::format(fmt, std::forward<Args>(args)...);     
-        fragLoggerInstance.log(result, LogLevel::INFO);
+    template<typename... Args>
+    inline void logInfo(std::format_string<Args...> fmt, Args&&... args){
+        logWithLevel<LogLevel::INFO>(LogChannel::GENERAL, fmt, std::forward<Args>(args)...);
+    }
+    template<typename... Args>
+    inline void logInfo(LogChannel channel, std::format_string<Args...> fmt, Args&&... args){
+        logWithLevel<LogLevel::INFO>(channel, fmt, std::forward<Args>(args)...);
     }
 
     template<typename... Args>
     inline void logTrace(std::format_string<Args...> fmt, Args&&... args){
-        if (fragLoggerInstance.logLevel < LogLevel::TRACE) {
-            return;
-        }
-
-        std::string result = std::format(fmt, std::forward<Args>(args)...);     
-        fragLoggerInstance.log(result, LogLevel::TRACE);
+        logWithLevel<LogLevel::TRACE>(LogChannel::GENERAL, fmt, std::forward<Args>(args)...);
+    }
+    template<typename... Args>
+    inline void logTrace(LogChannel channel, std::format_string<Args...> fmt, Args&&... args){
+        logWithLevel<LogLevel::TRACE>(channel, fmt, std::forward<Args>(args)...);
     }
 
     template<typename... Args>
     inline void logDebug(std::format_string<Args...> fmt, Args&&... args){
-        if (fragLoggerInstance.logLevel < LogLevel::DEBUG) {
-            return;
-        }
-
-        std::string result = std::format(fmt, std::forward<Args>(args)...);     
-        fragLoggerInstance.log(result, LogLevel::DEBUG);
+        logWithLevel<LogLevel::DEBUG>(LogChannel::GENERAL, fmt, std::forward<Args>(args)...);
+    }
+    template<typename... Args>
+    inline void logDebug(LogChannel channel, std::format_string<Args...> fmt, Args&&... args){
+        logWithLevel<LogLevel::DEBUG>(channel, fmt, std::forward<Args>(args)...);
     }
 
     template<typename... Args>
     inline void logWarn(std::format_string<Args...> fmt, Args&&... args){
-        if (fragLoggerInstance.logLevel < LogLevel::WARNING) {
-            return;
-        }
-        
-        std::string result = std::format(fmt, std::forward<Args>(args)...);     // geht nicht als string??!?!?!?!!??
-        fragLoggerInstance.log(result, LogLevel::WARNING);
+        logWithLevel<LogLevel::WARNING>(LogChannel::GENERAL, fmt, std::forward<Args>(args)...);
+    }
+    template<typename... Args>
+    inline void logWarn(LogChannel channel, std::format_string<Args...> fmt, Args&&... args){
+        logWithLevel<LogLevel::WARNING>(channel, fmt, std::forward<Args>(args)...);
     }
 
     template<typename... Args>
     inline void logError(std::format_string<Args...> fmt, Args&&... args){
-        if (fragLoggerInstance.logLevel < LogLevel::ERROR) {
-            return;
-        }
-
-        std::string result = std::format(fmt, std::forward<Args>(args)...);     
-        fragLoggerInstance.log(result, LogLevel::ERROR);
+        logWithLevel<LogLevel::ERROR>(LogChannel::GENERAL, fmt, std::forward<Args>(args)...);
+    }
+    template<typename... Args>
+    inline void logError(LogChannel channel, std::format_string<Args...> fmt, Args&&... args){
+        logWithLevel<LogLevel::ERROR>(channel, fmt, std::forward<Args>(args)...);
     }
 
     template<typename... Args>
     inline void logFatal(std::format_string<Args...> fmt, Args&&... args){
-        if (fragLoggerInstance.logLevel < LogLevel::FATAL) {
-            return;
-        }
-
-        std::string result = std::format(fmt, std::forward<Args>(args)...);     
-        fragLoggerInstance.log(result, LogLevel::FATAL);
+        logWithLevel<LogLevel::FATAL>(LogChannel::GENERAL, fmt, std::forward<Args>(args)...);
+    }
+    template<typename... Args>
+    inline void logFatal(LogChannel channel, std::format_string<Args...> fmt, Args&&... args){
+        logWithLevel<LogLevel::FATAL>(channel, fmt, std::forward<Args>(args)...);
     }
 
+    /*
+        Same as the log functions, but the whole call (including the evaluation of the arguments) is removed by the
+        preprocessor if the level is below FRAG_LOG_COMPILED_LEVEL. Use these for TRACE/DEBUG logs in hot code.
+        e.g.: FRAG_LOG_DEBUG(frag::LogChannel::RENDER, "Drawing {} rects", countRects());
+    */
+    #if FRAG_LOG_COMPILED_LEVEL_VALUE >= FRAG_LOG_LEVEL_VALUE_TRACE
+        #define FRAG_LOG_TRACE(...) ::frag::logTrace(__VA_ARGS__)
+    #else
+        #define FRAG_LOG_TRACE(...) ((void)0)
+    #endif
+    #if FRAG_LOG_COMPILED_LEVEL_VALUE >= FRAG_LOG_LEVEL_VALUE_DEBUG
+        #define FRAG_LOG_DEBUG(...) ::frag::logDebug(__VA_ARGS__)
+    #else
+        #define FRAG_LOG_DEBUG(...) ((void)0)
+    #endif
+    #if FRAG_LOG_COMPILED_LEVEL_VALUE >= FRAG_LOG_LEVEL_VALUE_INFO
+        #define FRAG_LOG_INFO(...) ::frag::logInfo(__VA_ARGS__)
+    #else
+        #define FRAG_LOG_INFO(...) ((void)0)
+    #endif
+    #if FRAG_LOG_COMPILED_LEVEL_VALUE >= FRAG_LOG_LEVEL_VALUE_WARNING
+        #define FRAG_LOG_WARN(...) ::frag::logWarn(__VA_ARGS__)
+    #else
+        #define FRAG_LOG_WARN(...) ((void)0)
+    #endif
+    #if FRAG_LOG_COMPILED_LEVEL_VALUE >= FRAG_LOG_LEVEL_VALUE_ERROR
+        #define FRAG_LOG_ERROR(...) ::frag::logError(__VA_ARGS__)
+    #else
+        #define FRAG_LOG_ERROR(...) ((void)0)
+    #endif
+    #if FRAG_LOG_COMPILED_LEVEL_VALUE >= FRAG_LOG_LEVEL_VALUE_FATAL
+        #define FRAG_LOG_FATAL(...) ::frag::logFatal(__VA_ARGS__)
+    #else
+        #define FRAG_LOG_FATAL(...) ((void)0)
+    #endif
+
     inline void logging_setLogLevel(LogLevel level) {
         fragLoggerInstance.logLevel = level;
     }
+    inline void logging_setChannelLogLevel(LogChannel channel, LogLevel level) {
+        fragLoggerInstance.setChannelLogLevel(channel, level);
+    }
+    inline void logging_resetChannelLogLevel(LogChannel channel) {
+        fragLoggerInstance.resetChannelLogLevel(channel);
+    }
+    inline LogChannel logging_registerChannel(std::string_view name) {
+        return fragLoggerInstance.registerChannel(name);
+    }
+    inline void logging_addSink(std::shared_ptr<ILogSink> sink) {
+        fragLoggerInstance.addSink(std::move(sink));
+    }
+    inline void logging_removeSink(const std::shared_ptr<ILogSink>& sink) {
+        fragLoggerInstance.removeSink(sink);
+    }
+    inline void logging_clearSinks() {
+        fragLoggerInstance.clearSinks();
+    }
     inline void logging_enableColorizedOutput(bool enabled) {
         fragLoggerInstance.colorizedOutput = enabled;
     }
     inline void logging_enableColorWholeMessage(bool enabled) {
         fragLoggerInstance.colorWholeMessage = enabled;
     }
+    inline void logging_setBackpressurePolicy(LogBackpressure policy) {
+        fragLoggerInstance.backpressure = policy;
+    }
+    // Deferred formatting is on by default, disable it if you need the message to be formatted at the call site
+    inline void logging_enableDeferredFormatting(bool enabled) {
+        fragLoggerInstance.deferredFormatting = enabled;
+    }
+    inline uint64_t logging_getDroppedCount() {
+        return fragLoggerInstance.getDroppedCount();
+    }
 
 }
\ No newline at end of file
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <filesystem>
+#include <span>
+#include <vector>
+
+#include <frag/package/FragHash.h>
+#include <frag/package/FrozenTable.h>
+#include <frag/io/MappedFile.h>
+
+namespace frag {
+
+    class IPackage;
+
+    struct AssetArchiveOptions {
+        bool compress = true;
+        // A compressed entry is only kept if it's at most this big compared to the original, otherwise it's stored as it is
+        double maxCompressionRatio = 0.9;
+    };
+
+    /*
+        AssetArchive - all assets of a package packed into one file
+        Instead of one open / read per loose asset file, the whole archive gets mapped once.
+
+        The table of contents is a FrozenTable keyed by the namespaced asset keys (IPackage::getKey), stored in the
+        file as it is in memory, so finding an asset is one probe into the mapped file. Every asset is aligned to
+        DATA_ALIGNMENT. Uncompressed assets can be used directly from the mapping (getView), compressed ones
+        (see BlockCompression.h) are decompressed by read.
+
+        pack() is the build-time packer: it reads every asset registered by a finished package from the asset directory.
+    */
+    class AssetArchive {
+        public:
+            static constexpr size_t DATA_ALIGNMENT = 64;
+
+            struct Entry {
+                uint64_t offset;        // Of the data in the archive
+                uint64_t storedSize;    // Size in the archive
+                uint64_t size;          // Uncompressed size
+                int32_t type;           // The type given to rAsset
+                uint32_t flags;
+            };
+            static constexpr uint32_t FLAG_COMPRESSED = 1;
+
+            // Writes the archive for every asset of package (which has to be finished). Returns false if an asset
+            // file is missing or the archive can't be written, a half written archive never replaces an old one.
+            static bool pack(const IPackage& package, const std::filesystem::path& assetDirectory, const std::filesystem::path& archivePath,
+                const AssetArchiveOptions& options = {});
+
+            AssetArchive() = default;
+            AssetArchive(const AssetArchive&) = delete;
+            AssetArchive& operator=(const AssetArchive&) = delete;
+
+            // Returns false (and stays closed) if the file is missing or broken
+            bool open(const std::filesystem::path& path);
+            void close();
+            bool isOpen() const {
+                return file.isOpen();
+            }
+
+            // nullptr if the archive has no asset with that key
+            const Entry* find(FragHash key) const {
+                return toc.find(key);
+            }
+            bool contains(FragHash key) const {
+                return toc.contains(key);
+            }
+            size_t getEntryCount() const {
+                return toc.size();
+            }
+            FragHash getPackageHash() const {
+                return packageHash;
+            }
+
+            // The data right in the mapping, empty for compressed entries
+            std::span<const std::byte> getView(const Entry& entry) const;
+            // Copies (or decompresses) the asset into buffer. Returns false if the entry is broken.
+            bool read(const Entry& entry, std::vector<std::byte>& buffer) const;
+
+        private:
+            MappedFile file;
+            FrozenTable<Entry> toc;
+            FragHash packageHash = 0;
+    };
+
+}
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include <frag/package/FragHash.h>
+#include <frag/asset/IAssetDecoder.h>
+
+namespace frag {
+
+    class AssetManager;
+
+    enum class AssetState : uint8_t {
+        UNLOADED,
+        QUEUED,     // Waiting for an I/O thread
+        LOADING,    // An I/O thread reads and decodes it right now
+        READY,
+        FAILED      // File missing or the decoder couldn't decode it (see the log)
+    };
+
+    enum class AssetPriority : uint8_t {
+        IMMEDIATE,  // Needed this frame, goes before everything that is prefetched
+        PREFETCH    // Needed soon (e.g. the next level), loaded when nothing immediate is waiting
+    };
+
+    namespace detail {
+        // One per asset that is loaded or requested, owned by the AssetManager
+        struct AssetRecord {
+            AssetManager* manager = nullptr;
+            FragHash key = 0;
+            int type = -1;
+            std::string path;
+
+            std::atomic<uint32_t> refCount = 0;     // Handles + queue entries
+            std::atomic<AssetState> state = AssetState::UNLOADED;
+
+            // Only change in AssetManager::update, so they are stable during a frame
+            AssetData loaded;
+            uint32_t version = 0;                   // Increased by every hot reload
+            // Written by the I/O thread, moved into loaded by update
+            AssetData result;
+
+            // The rest is protected by the mutex of the manager
+            AssetPriority priority = AssetPriority::PREFETCH;
+            bool released = false;                  // Is in the list of records without handles
+            bool cached = false;                    // Unused but still loaded, in the LRU list of the cache
+            AssetRecord* lruPrevious = nullptr;     // Towards the least recently used one
+            AssetRecord* lruNext = nullptr;
+            std::string filePath;                   // The loose file it was loaded from, empty if it came from an archive
+            bool reloadQueued = false;              // Hot reload: in a queue, the old data stays READY meanwhile
+            bool reloadLoading = false;             // Hot reload: an I/O thread loads the new version right now
+            bool reloadRequested = false;           // Hot reload: changed again while it was loading
+        };
+
+        // Drops what may be the last reference under the mutex of the manager, the record gets unloaded in the next update
+        void releaseAssetRecord(AssetRecord* record);
+    }
+
+    /*
+        Ref-counted handle to an asset of the AssetManager.
+        Getting a handle never blocks, the asset becomes ready later (at the start of a frame, see AssetManager::update).
+        Check isReady() or just use get(), which returns nullptr until then.
+        The asset stays loaded as long as at least one handle to it exists, afterwards it may stay in the cache of
+        the AssetManager until the memory budget needs the space.
+    */
+    class AssetHandle {
+        public:
+            AssetHandle() = default;
+            ~AssetHandle() {
+                reset();
+            }
+
+            AssetHandle(const AssetHandle& other) : record(other.record) {
+                if (record) record->refCount.fetch_add(1, std::memory_order_relaxed);
+            }
+            AssetHandle(AssetHandle&& other) noexcept : record(std::exchange(other.record, nullptr)) {}
+            AssetHandle& operator=(AssetHandle other) noexcept {
+                std::swap(record, other.record);
+                return *this;
+            }
+
+            void reset() {
+                detail::AssetRecord* oldRecord = std::exchange(record, nullptr);
+                if (!oldRecord) return;
+
+                // Only references that aren't the last one are dropped without the manager. Going to 0 outside of its mutex
+                // would let another thread load and release the record again (and update() free it) before we are done with it.
+                uint32_t count = oldRecord->refCount.load(std::memory_order_relaxed);
+                while (count > 1) {
+                    if (oldRecord->refCount.compare_exchange_weak(count, count - 1, std::memory_order_acq_rel, std::memory_order_relaxed)) return;
+                }
+                detail::releaseAssetRecord(oldRecord);
+            }
+
+            bool isValid() const {
+                return record != nullptr;
+            }
+            explicit operator bool() const {
+                return isValid();
+            }
+
+            AssetState getState() const {
+                return record ? record->state.load(std::memory_order_acquire) : AssetState::UNLOADED;
+            }
+            bool isReady() const {
+                return getState() == AssetState::READY;
+            }
+            bool hasFailed() const {
+                return getState() == AssetState::FAILED;
+            }
+
+            // The decoded asset, nullptr while it isn't ready. T has to be the type the decoder of the asset type creates.
+            template<typename T>
+            const T* get() const {
+                if (!isReady()) return nullptr;
+                return static_cast<const T*>(record->loaded.data.get());
+            }
+            // Memory reported by the decoder, 0 while it isn't ready
+            size_t getMemorySize() const {
+                return isReady() ? record->loaded.memorySize : 0;
+            }
+
+            // Starts at 0, increased every time a hot reload replaced the asset.
+            // Keep the version next to anything built from the asset to notice when it has to be rebuilt.
+            uint32_t getVersion() const {
+                return record ? record->version : 0;
+            }
+
+            FragHash getKey() const {
+                return record ? record->key : 0;
+            }
+            int getType() const {
+                return record ? record->type : -1;
+            }
+
+        private:
+            friend class AssetManager;
+
+            detail::AssetRecord* record = nullptr;
+
+            // Takes over a reference that was already added
+            explicit AssetHandle(detail::AssetRecord* record) : record(record) {}
+    };
+
+}
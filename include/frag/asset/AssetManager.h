@@ -0,0 +1,195 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <deque>
+#include <unordered_map>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <filesystem>
+#include <functional>
+#include <chrono>
+#include <memory_resource>
+
+#include <frag/package/FragHash.h>
+#include <frag/asset/AssetHandle.h>
+#include <frag/asset/IAssetDecoder.h>
+#include <frag/asset/AssetArchive.h>
+#include <frag/io/FileWatcher.h>
+#include <frag/memory/PoolAllocator.h>
+
+namespace frag {
+
+    class IPackage;
+    class PackageRegistry;
+
+    /*
+        AssetManager - loads the assets registered with IPackage::rAsset in the background
+        Owned by the Core (Core::getAssetManager), but can also be created on its own.
+
+        - load() only looks the asset up and queues it, it never touches the disk. The caller gets an AssetHandle right away.
+        - Own I/O threads read (map) the files and decode them with the decoder of the asset type. They are separate
+          from the JobSystem, so slow disks never block the job workers.
+        - Assets are taken from mounted archives (see AssetArchive.h) if one of them has the asset, otherwise
+          from the loose file. Both use the same rAsset names.
+        - Two queues: IMMEDIATE (needed this frame) always goes before PREFETCH. Requesting a prefetched
+          asset with IMMEDIATE moves it to the front.
+        - Finished assets are published in update() at the start of a frame, so an asset never changes in the middle
+          of a frame. update() only moves pointers around, it doesn't wait for anything.
+        - Queued assets nobody wants anymore are skipped.
+        - Once the last handle of an asset is gone, it stays loaded in a cache as long as the memory budget allows it.
+          Loading it again is a cache hit without any I/O. If the loaded assets need more memory than the budget
+          (in total or for their type), update() unloads the least recently used cached ones. Assets with handles are
+          pinned, they are never unloaded, even if that means going above the budget.
+        - Hot reload (enableHotReload): the files of loaded assets are watched. A changed asset is loaded again in the
+          background while the old version stays usable, update() swaps the new version in. Only that asset changes,
+          every handle of it sees the new version, everything else stays untouched.
+    */
+    class AssetManager {
+        public:
+            // ioThreadCount < 1 uses one thread
+            explicit AssetManager(const PackageRegistry& packageRegistry, int ioThreadCount = 2);
+            ~AssetManager();
+
+            AssetManager(const AssetManager&) = delete;
+            AssetManager& operator=(const AssetManager&) = delete;
+
+            // Relative asset paths are relative to this directory (default: the working directory)
+            void setAssetDirectory(std::filesystem::path directory);
+            // Decoder for all assets of that type, replaces the old one. Types without a decoder use RawAssetDecoder.
+            void registerDecoder(int type, std::shared_ptr<IAssetDecoder> decoder);
+            // Assets in the archive are loaded from it instead of their loose files. Archives mounted later win.
+            // Returns false if the archive can't be opened.
+            bool mountArchive(const std::filesystem::path& path);
+
+            // key is the namespaced key of the asset (IPackage::getKey / fragHashCombine(packageHash, nameHash)).
+            // Returns an empty handle if no loaded package has such an asset.
+            AssetHandle load(FragHash key, AssetPriority priority = AssetPriority::IMMEDIATE);
+            AssetHandle load(const IPackage& package, FragHash nameHash, AssetPriority priority = AssetPriority::IMMEDIATE);
+            AssetHandle prefetch(FragHash key) {
+                return load(key, AssetPriority::PREFETCH);
+            }
+
+            // Budget for the memory of all loaded assets (as reported by the decoders), cached assets are unloaded to stay below it.
+            // 0 (the default) disables the cache, assets are unloaded as soon as the last handle is gone.
+            void setMemoryBudget(size_t bytes);
+            // Additional budget for all assets of one type, 0 = only the total budget counts
+            void setTypeMemoryBudget(int type, size_t bytes);
+            // Unloads every cached asset
+            void clearCache();
+
+            // Watches the loose files of all loaded assets and reloads the ones that change (assets from archives are not watched).
+            // For development, uses inotify, so it only works on Linux for now.
+            void enableHotReload(bool enabled);
+            // A changed file is only reloaded once it didn't change for this long (editors often write in several steps)
+            void setHotReloadDebounce(std::chrono::milliseconds time);
+            // Called in update() for every asset that got a new version, e.g. to rebuild things made out of it
+            void setReloadCallback(std::function<void(const AssetHandle& asset)> callback);
+
+            struct CacheStats {
+                uint64_t hits = 0;          // load() of an asset that was still loaded
+                uint64_t misses = 0;        // load() that had to queue the asset
+                uint64_t evictions = 0;     // Cached assets unloaded because of a budget
+                uint64_t evictedMemory = 0;
+                size_t cachedCount = 0;     // Loaded, but without handles
+                size_t cachedMemory = 0;
+            };
+            CacheStats getCacheStats() const;
+            // Memory of all loaded assets of that type
+            size_t getTypeMemory(int type) const;
+
+            // Publishes finished assets and unloads unused ones, call it once per frame (the Core does that)
+            void update();
+            // Blocks until every queued asset is loaded and publishes them. For loading screens and tools, not for the game loop.
+            void waitForAll();
+
+            // Assets that are queued or loading right now
+            size_t getPendingCount() const {
+                return pendingCount.load(std::memory_order_relaxed);
+            }
+            size_t getLoadedCount() const {
+                return loadedCount.load(std::memory_order_relaxed);
+            }
+            // Sum of the memory sizes the decoders reported for all ready assets
+            size_t getLoadedMemory() const {
+                return loadedMemory.load(std::memory_order_relaxed);
+            }
+
+        private:
+            friend void detail::releaseAssetRecord(detail::AssetRecord* record);
+
+            const PackageRegistry& packageRegistry;
+            std::filesystem::path assetDirectory;
+
+            std::unordered_map<int, std::shared_ptr<IAssetDecoder>> decoders;
+            std::shared_ptr<IAssetDecoder> rawDecoder = std::make_shared<RawAssetDecoder>();
+            std::vector<std::shared_ptr<const AssetArchive>> archives;
+
+            // Protects records, the queues, decoders, archives and the fields of the records marked as such
+            mutable std::mutex mutex;
+            // Records and map nodes come and go with streamed assets, both are pooled so that doesn't hit the heap
+            ObjectPool<detail::AssetRecord> recordPool;
+            PoolResource recordMapMemory;
+            std::pmr::unordered_map<FragHash, detail::AssetRecord*> records{ &recordMapMemory };
+            std::deque<detail::AssetRecord*> queues[2];         // Indexed by AssetPriority, every entry holds a reference
+            std::vector<detail::AssetRecord*> releasedRecords;  // No references left, unloaded in update
+            std::condition_variable queueCondition;
+            std::condition_variable idleCondition;
+
+            // Filled by the I/O threads, emptied by update
+            std::mutex finishedMutex;
+            std::vector<detail::AssetRecord*> finishedRecords;
+
+            std::vector<detail::AssetRecord*> publishingRecords; // Only used by update, keeps its capacity
+
+            // -- Cache, protected by mutex --
+            size_t memoryBudget = 0;
+            std::unordered_map<int, size_t> typeMemoryBudgets;
+            std::unordered_map<int, size_t> typeMemory;
+            detail::AssetRecord* lruHead = nullptr;     // Least recently used cached asset, evicted first
+            detail::AssetRecord* lruTail = nullptr;
+            CacheStats cacheStats;
+
+            // -- Hot reload, protected by mutex --
+            std::unique_ptr<FileWatcher> fileWatcher;
+            std::chrono::milliseconds hotReloadDebounce = std::chrono::milliseconds(100);
+            std::unordered_map<std::string, std::vector<FragHash>> watchedAssets; // Normalized file path -> assets loaded from it
+            std::vector<std::filesystem::path> changedFiles;
+            std::function<void(const AssetHandle&)> reloadCallback;
+
+            std::atomic<size_t> pendingCount = 0;
+            std::atomic<size_t> loadedCount = 0;
+            std::atomic<size_t> loadedMemory = 0;
+            size_t loadingCount = 0;    // Taken by an I/O thread and not finished yet
+            bool running = true;
+            std::vector<std::thread> ioThreads;
+
+            // These expect the mutex to be locked
+            void enqueue(detail::AssetRecord* record, AssetPriority priority);
+            void dropReference(detail::AssetRecord* record);
+            void addToReleased(detail::AssetRecord* record);
+            void addToCache(detail::AssetRecord* record);
+            void removeFromCache(detail::AssetRecord* record);
+            // Moves the asset into unloadedAssets (destroyed by the caller once the mutex is unlocked) and forgets the record
+            void unloadRecord(detail::AssetRecord* record, std::vector<AssetData>& unloadedAssets);
+            void evictOverBudget(std::vector<AssetData>& unloadedAssets);
+            void watchRecord(detail::AssetRecord* record);
+            void unwatchRecord(detail::AssetRecord* record);
+            void queueReload(detail::AssetRecord* record);
+            void reloadChangedFiles(std::vector<AssetData>& unloadedAssets);
+
+            void releaseRecord(detail::AssetRecord* record);
+            // Either from the archive (if archiveEntry isn't nullptr) or from the loose file at path.
+            // buffer is reused for loose files and compressed archive entries.
+            static bool loadAsset(detail::AssetRecord& record, IAssetDecoder& decoder, const std::filesystem::path& path,
+                const AssetArchive* archive, const AssetArchive::Entry* archiveEntry, std::vector<std::byte>& buffer);
+
+            void ioThread(int threadIndex);
+    };
+
+}
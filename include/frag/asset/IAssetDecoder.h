@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+
+#include <memory>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include <frag/package/FragHash.h>
+
+namespace frag {
+
+    // The result of a decoder: the finished asset and how much memory it takes
+    struct AssetData {
+        std::shared_ptr<void> data;
+        size_t memorySize = 0;
+    };
+
+    // What a decoder gets to know about the asset it decodes
+    struct AssetDescription {
+        FragHash key = 0;           // Namespaced key (IPackage::getKey)
+        int type = -1;              // The type given to rAsset
+        std::string_view path;      // The path given to rAsset
+    };
+
+    /*
+        A decoder turns the raw bytes of an asset file into the actual asset (a texture, a sound, ...).
+        One decoder is registered per asset type (the int given to IPackage::rAsset), see AssetManager::registerDecoder.
+
+        decode runs on the I/O threads of the AssetManager, possibly for several assets at the same time,
+        so it has to be thread-safe. bytes are only valid during the call.
+    */
+    class IAssetDecoder {
+        public:
+            virtual ~IAssetDecoder() = default;
+
+            // data = nullptr if the bytes could not be decoded, the asset counts as failed then
+            virtual AssetData decode(std::span<const std::byte> bytes, const AssetDescription& asset) = 0;
+    };
+
+    // Used for every type without an own decoder, the asset is just a copy of the file (std::vector<std::byte>)
+    class RawAssetDecoder : public IAssetDecoder {
+        public:
+            AssetData decode(std::span<const std::byte> bytes, const AssetDescription&) override {
+                auto data = std::make_shared<std::vector<std::byte>>(bytes.begin(), bytes.end());
+                size_t memorySize = data->size();
+                return { std::move(data), memorySize };
+            }
+    };
+
+}
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <array>
+#include <vector>
+#include <unordered_map>
+
+#include <frag/ecs/Component.h>
+#include <frag/ecs/Entity.h>
+
+namespace frag {
+
+    /*
+        An Archetype stores all entities that have exactly the same set of components.
+        The entities are packed into fixed size chunks, and every chunk is laid out as structure of arrays:
+            [Entity 0..n] [Position 0..n] [Velocity 0..n] ...
+        Every column starts on its own cache line, so iterating over one component type only touches
+        the memory of that type.
+
+        Entities are always packed densely: every chunk is full except the last one. Removing an entity
+        moves the last entity of the archetype into the hole, so a row is just chunkIndex * capacity + index.
+
+        Archetypes are created and owned by the World, everything that changes them goes through it.
+    */
+    class Archetype {
+        public:
+            static constexpr size_t CHUNK_SIZE = 16 * 1024;
+            static constexpr size_t COLUMN_ALIGNMENT = 64;
+
+            struct Chunk {
+                std::byte* data = nullptr;
+                uint32_t count = 0;
+            };
+
+            explicit Archetype(const ComponentMask& mask);
+            ~Archetype();
+
+            Archetype(const Archetype&) = delete;
+            Archetype& operator=(const Archetype&) = delete;
+
+            const ComponentMask& getMask() const {
+                return mask;
+            }
+            // Sorted by id
+            const std::vector<ComponentId>& getComponents() const {
+                return components;
+            }
+            bool hasComponent(ComponentId id) const {
+                return mask.test(id);
+            }
+
+            size_t getEntityCount() const {
+                return entityCount;
+            }
+            uint32_t getChunkCapacity() const {
+                return chunkCapacity;
+            }
+            size_t getChunkCount() const {
+                return chunks.size();
+            }
+            const Chunk& getChunk(size_t index) const {
+                return chunks[index];
+            }
+
+            // Column of a component in a chunk, nullptr if this archetype doesn't have the component
+            void* getColumn(const Chunk& chunk, ComponentId id) const {
+                int16_t column = columnLookup[id];
+                return column < 0 ? nullptr : chunk.data + columnOffsets[column];
+            }
+            template<typename T>
+            T* getColumn(const Chunk& chunk, ComponentId id) const {
+                return static_cast<T*>(getColumn(chunk, id));
+            }
+            Entity* getEntities(const Chunk& chunk) const {
+                return reinterpret_cast<Entity*>(chunk.data);
+            }
+
+            // Pointer to the component of the entity in the given row
+            void* getComponent(uint32_t row, ComponentId id) const {
+                int16_t column = columnLookup[id];
+                if (column < 0) return nullptr;
+                const Chunk& chunk = chunks[row / chunkCapacity];
+                return chunk.data + columnOffsets[column] + (size_t)(row % chunkCapacity) * columnInfos[column]->size;
+            }
+            Entity getEntity(uint32_t row) const {
+                return getEntities(chunks[row / chunkCapacity])[row % chunkCapacity];
+            }
+
+        private:
+            friend class World;
+
+            ComponentMask mask;
+            std::vector<ComponentId> components;
+
+            std::vector<const ComponentInfo*> columnInfos;
+            std::vector<size_t> columnOffsets;
+            std::array<int16_t, MAX_COMPONENT_TYPES> columnLookup; // ComponentId -> column, -1 = not in this archetype
+
+            size_t chunkBytes = CHUNK_SIZE;
+            uint32_t chunkCapacity = 0;
+            std::vector<Chunk> chunks;
+            size_t entityCount = 0;
+
+            // Cached archetype graph, archetype with one component more / less
+            std::unordered_map<ComponentId, Archetype*> addEdges;
+            std::unordered_map<ComponentId, Archetype*> removeEdges;
+
+            // Appends a row for the entity, the components in it are not constructed yet
+            uint32_t allocateRow(Entity entity);
+            // Destroys the components in the row (if destroyComponents) and moves the last row into it.
+            // Returns the entity that got moved into the row, or an invalid entity if the row was the last one.
+            Entity removeRow(uint32_t row, bool destroyComponents);
+
+            // Computes the column layout for a given chunk capacity, returns the bytes needed
+            size_t computeLayout(uint32_t capacity);
+    };
+
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <atomic>
+#include <bitset>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <new>
+#include <utility>
+
+#include <frag/memory/MemoryTracker.h>
+
+#ifndef FRAG_ECS_MAX_COMPONENTS
+    #define FRAG_ECS_MAX_COMPONENTS 256
+#endif
+
+/*
+    Component types of the ECS.
+    Components are plain structs, there is no base class and nothing virtual. Every component type gets a
+    small ComponentId (0, 1, 2, ...) the first time it gets registered, so sets of components can be stored
+    as a bitmask and the archetype storage can index its columns with the id directly.
+
+    Packages register their components with IPackage::rComponent<T>("Name"), which also gives them their
+    "p:Package::Name" name. Types that are used without being registered get registered on first use.
+*/
+
+namespace frag {
+
+    using ComponentId = uint16_t;
+
+    inline constexpr size_t MAX_COMPONENT_TYPES = FRAG_ECS_MAX_COMPONENTS;
+    inline constexpr ComponentId INVALID_COMPONENT_ID = 0xFFFF;
+
+    using ComponentMask = std::bitset<MAX_COMPONENT_TYPES>;
+
+    // Everything the storage needs to know about a component type, without knowing the type itself
+    struct ComponentInfo {
+        std::string name;
+        size_t size = 0;
+        size_t alignment = 1;
+
+        // Moves the component from src to dst and destroys src. nullptr = trivially copyable, memcpy is enough.
+        void (*relocate)(void* dst, void* src) = nullptr;
+        // nullptr = trivially destructible
+        void (*destroy)(void* component) = nullptr;
+    };
+
+    namespace detail {
+        template<typename T>
+        struct ComponentTypeId {
+            static inline std::atomic<ComponentId> id = INVALID_COMPONENT_ID;
+        };
+
+        // Registers the type behind slot, unless another thread was faster. Returns the id of the type.
+        ComponentId registerComponentType(std::atomic<ComponentId>& slot, ComponentInfo&& info);
+
+        template<typename T>
+        ComponentInfo makeComponentInfo(std::string_view name) {
+            static_assert(std::is_nothrow_move_constructible_v<T>, "Components have to be nothrow move constructible, they get moved around in memory");
+            static_assert(std::is_nothrow_destructible_v<T>, "Components have to be nothrow destructible");
+            static_assert(alignof(T) <= 64, "Components can be aligned to at most 64 bytes");
+
+            ComponentInfo info;
+            info.name = std::string(name);
+            info.size = sizeof(T);
+            info.alignment = alignof(T);
+
+            if constexpr (!std::is_trivially_copyable_v<T>) {
+                info.relocate = [](void* dst, void* src) {
+                    T* source = std::launder(static_cast<T*>(src));
+                    new (dst) T(std::move(*source));
+                    source->~T();
+                };
+            }
+            if constexpr (!std::is_trivially_destructible_v<T>) {
+                info.destroy = [](void* component) { std::launder(static_cast<T*>(component))->~T(); };
+            }
+            return info;
+        }
+    }
+
+    // Registers T under the given name. Registering the same type again keeps the first id and name.
+    template<typename T>
+    ComponentId registerComponent(std::string_view name) {
+        using Type = std::remove_cv_t<T>;
+        std::atomic<ComponentId>& slot = detail::ComponentTypeId<Type>::id;
+
+        ComponentId id = slot.load(std::memory_order_acquire);
+        if (id != INVALID_COMPONENT_ID) return id;
+
+        MemoryTagScope memoryTag(MemoryTag::GLOBAL); // The registry is never cleared
+        return detail::registerComponentType(slot, detail::makeComponentInfo<Type>(name));
+    }
+
+    // Id of T, registers T with a generic name if nobody did that yet
+    template<typename T>
+    ComponentId getComponentId() {
+        using Type = std::remove_cv_t<T>;
+
+        ComponentId id = detail::ComponentTypeId<Type>::id.load(std::memory_order_acquire);
+        if (id != INVALID_COMPONENT_ID) [[likely]] return id;
+        return registerComponent<Type>("unnamed");
+    }
+
+    const ComponentInfo& getComponentInfo(ComponentId id);
+    size_t getComponentTypeCount();
+
+    // Id of the component type registered under that name, INVALID_COMPONENT_ID if there is none
+    ComponentId findComponentId(std::string_view name);
+
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+
+namespace frag {
+
+    /*
+        An Entity is just a handle into a World, all data lives in its components.
+        The generation gets increased every time the index is reused, so handles of destroyed entities
+        can be detected instead of silently pointing to a new entity.
+    */
+    struct Entity {
+        static constexpr uint32_t INVALID_INDEX = 0xFFFFFFFF;
+
+        uint32_t index = INVALID_INDEX;
+        uint32_t generation = 0;
+
+        bool isValid() const {
+            return index != INVALID_INDEX;
+        }
+
+        bool operator==(const Entity&) const = default;
+    };
+
+}
+
+template<>
+struct std::hash<frag::Entity> {
+    size_t operator()(const frag::Entity& entity) const noexcept {
+        return std::hash<uint64_t>()(((uint64_t)entity.generation << 32) | entity.index);
+    }
+};
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <array>
+#include <vector>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include <frag/ecs/Archetype.h>
+#include <frag/job/JobSystem.h>
+
+namespace frag {
+
+    /*
+        Query<Ts...> - iterates over every entity that has (at least) the components Ts.
+        Created with World::query<Ts...>(). Use const T for components that are only read.
+
+        The matching archetypes are cached in the query and only new archetypes get checked on the next
+        run, so keep the query around instead of creating it every frame.
+        Iteration goes chunk by chunk over the raw columns, so the loop body gets plain arrays.
+
+        Don't add/remove components or entities of the World while a query runs over it.
+    */
+    template<typename... Ts>
+    class Query {
+        public:
+            static_assert(sizeof...(Ts) > 0, "A query needs at least one component");
+
+            explicit Query(const std::vector<std::unique_ptr<Archetype>>& archetypes)
+                : archetypes(&archetypes), ids{ getComponentId<Ts>()... } {
+                for (ComponentId id : ids) required.set(id);
+            }
+
+            // function(Ts&...) or function(Entity, Ts&...), once for every entity
+            template<typename F>
+            void forEach(F&& function) {
+                update();
+                for (Archetype* archetype : matched) {
+                    for (size_t i = 0; i < archetype->getChunkCount(); i++) {
+                        runChunk(*archetype, archetype->getChunk(i), function);
+                    }
+                }
+            }
+
+            // Same as forEach, but the chunks are spread over the workers of the JobSystem.
+            // Returns once every entity is done. function gets called from multiple threads at the same time.
+            template<typename F>
+            void parallelForEach(JobSystem& jobSystem, F&& function) {
+                update();
+                collectChunks();
+                jobSystem.parallelFor(chunkList.size(), 1, [this, &function](size_t begin, size_t end) {
+                    for (size_t i = begin; i < end; i++) {
+                        runChunk(*chunkList[i].first, chunkList[i].first->getChunk(chunkList[i].second), function);
+                    }
+                });
+            }
+
+            // function(uint32_t count, const Entity* entities, Ts* columns...), once for every chunk.
+            // For loops that want to work on the arrays themselves (e.g. SIMD).
+            template<typename F>
+            void forEachChunk(F&& function) {
+                update();
+                for (Archetype* archetype : matched) {
+                    for (size_t i = 0; i < archetype->getChunkCount(); i++) {
+                        const Archetype::Chunk& chunk = archetype->getChunk(i);
+                        if (chunk.count == 0) continue;
+                        invokeChunk(*archetype, chunk, function, std::index_sequence_for<Ts...>());
+                    }
+                }
+            }
+
+            size_t count() {
+                update();
+                size_t total = 0;
+                for (Archetype* archetype : matched) total += archetype->getEntityCount();
+                return total;
+            }
+
+        private:
+            const std::vector<std::unique_ptr<Archetype>>* archetypes;
+            std::array<ComponentId, sizeof...(Ts)> ids;
+            ComponentMask required;
+
+            std::vector<Archetype*> matched;
+            size_t checkedArchetypes = 0;
+
+            std::vector<std::pair<Archetype*, size_t>> chunkList; // Reused by parallelForEach
+
+            void update() {
+                // Archetypes are never removed, so only the new ones have to be checked
+                for (; checkedArchetypes < archetypes->size(); checkedArchetypes++) {
+                    Archetype* archetype = (*archetypes)[checkedArchetypes].get();
+                    if ((archetype->getMask() & required) == required) matched.push_back(archetype);
+                }
+            }
+
+            void collectChunks() {
+                chunkList.clear();
+                for (Archetype* archetype : matched) {
+                    for (size_t i = 0; i < archetype->getChunkCount(); i++) {
+                        if (archetype->getChunk(i).count > 0) chunkList.emplace_back(archetype, i);
+                    }
+                }
+            }
+
+            template<typename F, size_t... I>
+            void invokeChunk(const Archetype& archetype, const Archetype::Chunk& chunk, F& function, std::index_sequence<I...>) const {
+                function(chunk.count, (const Entity*)archetype.getEntities(chunk), archetype.getColumn<Ts>(chunk, ids[I])...);
+            }
+
+            template<typename F>
+            void runChunk(const Archetype& archetype, const Archetype::Chunk& chunk, F& function) const {
+                runChunk(archetype, chunk, function, std::index_sequence_for<Ts...>());
+            }
+
+            template<typename F, size_t... I>
+            void runChunk(const Archetype& archetype, const Archetype::Chunk& chunk, F& function, std::index_sequence<I...>) const {
+                std::tuple<Ts*...> columns = { archetype.getColumn<Ts>(chunk, ids[I])... };
+
+                if constexpr (std::is_invocable_v<F&, Entity, Ts&...>) {
+                    const Entity* entities = archetype.getEntities(chunk);
+                    for (uint32_t row = 0; row < chunk.count; row++) {
+                        function(entities[row], std::get<I>(columns)[row]...);
+                    }
+                }
+                else {
+                    static_assert(std::is_invocable_v<F&, Ts&...>, "Query function has to take (Ts&...) or (Entity, Ts&...)");
+                    for (uint32_t row = 0; row < chunk.count; row++) {
+                        function(std::get<I>(columns)[row]...);
+                    }
+                }
+            }
+    };
+
+}
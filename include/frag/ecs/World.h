@@ -0,0 +1,155 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include <type_traits>
+#include <utility>
+#include <new>
+
+#include <frag/Log.h>
+#include <frag/ecs/Component.h>
+#include <frag/ecs/Entity.h>
+#include <frag/ecs/Archetype.h>
+#include <frag/ecs/Query.h>
+
+/*
+    World - Entity/Component storage of the Fragmental Engine
+    Entities with the same set of components share an Archetype, which stores them in SoA chunks
+    (see Archetype.h). Adding or removing a component moves the entity to another archetype, so do that
+    on spawn/despawn and state changes, not every frame.
+
+    The World is not thread safe. Queries can run in parallel (Query::parallelForEach), but nothing may
+    change the structure of the World while they do.
+*/
+
+namespace frag {
+
+    class World {
+        public:
+            World();
+            ~World();
+
+            World(const World&) = delete;
+            World& operator=(const World&) = delete;
+
+            // Entity without any components
+            Entity createEntity();
+
+            // Entity with the given components, e.g. createEntity(Position{ 0, 0 }, Velocity{ 1, 0 })
+            template<typename... Ts>
+            Entity createEntity(Ts&&... components) {
+                if constexpr (sizeof...(Ts) == 0) {
+                    return createEntity();
+                }
+                else {
+                    ComponentMask mask;
+                    (mask.set(getComponentId<std::decay_t<Ts>>()), ...);
+                    if (mask.count() != sizeof...(Ts)) {
+                        logError(LogChannel::CORE, "createEntity got the same component type more than once.");
+                        return Entity();
+                    }
+
+                    Archetype* archetype = getOrCreateArchetype(mask);
+                    Entity entity = allocateEntity();
+                    uint32_t row = archetype->allocateRow(entity);
+                    (new (archetype->getComponent(row, getComponentId<std::decay_t<Ts>>())) std::decay_t<Ts>(std::forward<Ts>(components)), ...);
+
+                    EntityRecord& record = records[entity.index];
+                    record.archetype = archetype;
+                    record.row = row;
+                    return entity;
+                }
+            }
+
+            void destroyEntity(Entity entity);
+            bool isAlive(Entity entity) const {
+                return entity.index < records.size() && records[entity.index].generation == entity.generation && records[entity.index].archetype;
+            }
+
+            // Adds T (constructed from args) to the entity, or replaces it if the entity already has one
+            template<typename T, typename... Args>
+            T* addComponent(Entity entity, Args&&... args) {
+                if (!isAlive(entity)) {
+                    logWarn(LogChannel::CORE, "addComponent on a dead entity ({}:{})", entity.index, entity.generation);
+                    return nullptr;
+                }
+
+                ComponentId id = getComponentId<T>();
+                EntityRecord& record = records[entity.index];
+                if (record.archetype->hasComponent(id)) {
+                    T* component = static_cast<T*>(record.archetype->getComponent(record.row, id));
+                    *component = T(std::forward<Args>(args)...);
+                    return component;
+                }
+
+                moveEntity(entity, getArchetypeWith(record.archetype, id));
+                return new (record.archetype->getComponent(record.row, id)) T(std::forward<Args>(args)...);
+            }
+
+            template<typename T>
+            void removeComponent(Entity entity) {
+                if (!isAlive(entity)) return;
+
+                ComponentId id = getComponentId<T>();
+                EntityRecord& record = records[entity.index];
+                if (!record.archetype->hasComponent(id)) return;
+
+                moveEntity(entity, getArchetypeWithout(record.archetype, id));
+            }
+
+            template<typename T>
+            bool hasComponent(Entity entity) const {
+                return isAlive(entity) && records[entity.index].archetype->hasComponent(getComponentId<T>());
+            }
+
+            // nullptr if the entity is dead or doesn't have T. Only valid until the next structural change.
+            template<typename T>
+            T* getComponent(Entity entity) {
+                if (!isAlive(entity)) return nullptr;
+                const EntityRecord& record = records[entity.index];
+                return static_cast<T*>(record.archetype->getComponent(record.row, getComponentId<T>()));
+            }
+
+            template<typename... Ts>
+            Query<Ts...> query() const {
+                return Query<Ts...>(archetypes);
+            }
+
+            size_t getEntityCount() const {
+                return aliveEntities;
+            }
+            size_t getArchetypeCount() const {
+                return archetypes.size();
+            }
+
+        private:
+            struct EntityRecord {
+                Archetype* archetype = nullptr; // nullptr = free
+                uint32_t row = 0;
+                uint32_t generation = 0;
+            };
+
+            std::vector<EntityRecord> records;   // Indexed by Entity::index
+            std::vector<uint32_t> freeIndices;
+            size_t aliveEntities = 0;
+
+            std::vector<std::unique_ptr<Archetype>> archetypes; // Never shrinks, queries rely on that
+            std::unordered_map<ComponentMask, Archetype*> archetypeLookup;
+            Archetype* emptyArchetype = nullptr;
+
+            Entity allocateEntity();
+
+            Archetype* getOrCreateArchetype(const ComponentMask& mask);
+            Archetype* getArchetypeWith(Archetype* archetype, ComponentId id);
+            Archetype* getArchetypeWithout(Archetype* archetype, ComponentId id);
+
+            // Moves the entity into target. Components both archetypes have are moved over, the ones target
+            // doesn't have are destroyed, and the ones only target has are left unconstructed for the caller.
+            void moveEntity(Entity entity, Archetype* target);
+    };
+
+}
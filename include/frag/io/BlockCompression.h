@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstddef>
+
+#include <span>
+#include <vector>
+
+namespace frag {
+
+    /*
+        Small LZ77 block compressor in the style of LZ4 (same token / literal / offset / match layout).
+        Made for asset data: compression is fast enough for a packer, decompression is a few simple copies.
+        There is no frame or header, the caller has to store the uncompressed size itself.
+    */
+
+    // Worst case size of compressBlock for inputSize bytes (incompressible data grows a tiny bit)
+    constexpr size_t getMaxCompressedSize(size_t inputSize) {
+        return inputSize + inputSize / 255 + 16;
+    }
+
+    // Replaces the content of output with the compressed input
+    void compressBlock(std::span<const std::byte> input, std::vector<std::byte>& output);
+
+    // output has to be exactly the uncompressed size. Returns false if input is broken, never reads or writes out of bounds.
+    bool decompressBlock(std::span<const std::byte> input, std::span<std::byte> output);
+
+}
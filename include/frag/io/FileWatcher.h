@@ -0,0 +1,66 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace frag {
+
+    /*
+        Watches files for changes on a background thread (inotify on Linux, other platforms are not supported yet).
+        The directories of the files are watched instead of the files themselves, so files that get replaced
+        (most editors write a new file and rename it) are still noticed.
+
+        Changes are debounced: a file only shows up in collectChanges once it didn't change for the debounce time,
+        so a file that is written in several steps is reported once, after the last step.
+    */
+    class FileWatcher {
+        public:
+            FileWatcher() = default;
+            ~FileWatcher();
+
+            FileWatcher(const FileWatcher&) = delete;
+            FileWatcher& operator=(const FileWatcher&) = delete;
+
+            // Returns false if watching is not possible (not supported or no inotify instance left)
+            bool start();
+            void stop();
+            bool isRunning() const {
+                return running.load(std::memory_order_relaxed);
+            }
+
+            // Can be called before and after start
+            void watchFile(const std::filesystem::path& path);
+            void unwatchFile(const std::filesystem::path& path);
+            void setDebounceTime(std::chrono::milliseconds time);
+
+            // Appends every file whose last change is at least the debounce time ago, each file only once per change
+            void collectChanges(std::vector<std::filesystem::path>& changedFiles);
+
+            // The form paths are reported in (absolute and normalized)
+            static std::filesystem::path normalizePath(const std::filesystem::path& path);
+
+        private:
+            std::mutex mutex;
+            std::unordered_set<std::string> watchedFiles;
+            std::unordered_map<std::string, int> directoryWatches;          // Directory -> watch descriptor
+            std::unordered_map<int, std::string> watchedDirectories;        // Watch descriptor -> directory
+            std::unordered_map<std::string, std::chrono::steady_clock::time_point> pendingChanges; // File -> time of the last change
+            std::chrono::milliseconds debounceTime = std::chrono::milliseconds(100);
+
+            std::atomic<bool> running = false;
+            std::thread watchThread;
+            int inotifyHandle = -1;
+            int wakeHandle = -1;    // eventfd that wakes the thread up for stop()
+
+            void addDirectoryWatch(const std::string& directory);
+            void watchThreadLoop();
+    };
+
+}
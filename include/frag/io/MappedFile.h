@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <filesystem>
+#include <span>
+
+namespace frag {
+
+    /*
+        Read-only memory mapped file.
+        The OS pages the file in on demand and shares the pages between processes, so opening even a big
+        file is cheap and nothing gets copied. The data stays valid until close() or the destructor.
+    */
+    class MappedFile {
+        public:
+            MappedFile() = default;
+            ~MappedFile();
+
+            MappedFile(MappedFile&& other) noexcept;
+            MappedFile& operator=(MappedFile&& other) noexcept;
+            MappedFile(const MappedFile&) = delete;
+            MappedFile& operator=(const MappedFile&) = delete;
+
+            // Returns false if the file cannot be opened or mapped (an empty file counts as opened)
+            bool open(const std::filesystem::path& path);
+            void close();
+
+            bool isOpen() const {
+                return opened;
+            }
+            const std::byte* getData() const {
+                return data;
+            }
+            size_t getSize() const {
+                return size;
+            }
+            std::span<const std::byte> getBytes() const {
+                return std::span<const std::byte>(data, size);
+            }
+
+        private:
+            const std::byte* data = nullptr;
+            size_t size = 0;
+            bool opened = false;
+
+            #if defined(_WIN32)
+                void* fileHandle = nullptr;
+                void* mappingHandle = nullptr;
+            #endif
+    };
+
+}
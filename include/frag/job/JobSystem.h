@@ -0,0 +1,194 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <algorithm>
+#include <type_traits>
+#include <new>
+
+#include <frag/job/WorkStealingDeque.h>
+
+/*
+    JobSystem - Work-stealing task scheduler of the Fragmental Engine
+    Owned by the Core (Core::getJobSystem), but can also be created on its own.
+
+    - One worker thread per core. The thread that creates the JobSystem counts as one of them, it executes
+      jobs while it waits for a JobCounter. A thread can own several JobSystems at once (up to 8), destroy a
+      JobSystem on the thread that created it.
+    - Every thread has its own deque: new jobs go to the local deque, idle workers steal from the others.
+    - JobCounters track how many jobs are still running. wait() executes other jobs instead of blocking,
+      runAfter() starts a job only once another counter reached zero.
+    - Jobs are stored in pooled Job objects with inline storage for the lambda, so submitting a job
+      doesn't touch the heap after warm-up.
+    - Idle workers sleep, an idle JobSystem costs no CPU.
+*/
+
+namespace frag {
+
+    struct Job;
+    struct JobPool;
+
+    class JobCounter {
+        public:
+            JobCounter() = default;
+            JobCounter(const JobCounter&) = delete;
+            JobCounter& operator=(const JobCounter&) = delete;
+
+            // Also waits for the thread that finished the last job to let go of the counter,
+            // after that the counter may be destroyed or reused
+            bool isDone() const {
+                return value.load(std::memory_order_acquire) == 0 && !waitingJobsLocked.load(std::memory_order_acquire);
+            }
+
+        private:
+            friend class JobSystem;
+
+            std::atomic<int> value = 0;
+
+            // Jobs that were started with runAfter(this), protected by a tiny spinlock.
+            // The lock is also held while a job decreases value, see isDone()
+            std::atomic<bool> waitingJobsLocked = false;
+            Job* waitingJobs = nullptr;
+
+            void lockWaitingJobs() {
+                while (waitingJobsLocked.exchange(true, std::memory_order_acquire)) std::this_thread::yield();
+            }
+            void unlockWaitingJobs() {
+                waitingJobsLocked.store(false, std::memory_order_release);
+            }
+    };
+
+    struct Job {
+        static constexpr size_t STORAGE_SIZE = 64;
+
+        void (*execute)(Job& job) = nullptr;
+        void (*destroy)(Job& job) = nullptr;
+        JobCounter* counter = nullptr;
+        Job* next = nullptr;        // Free list / waiting list
+        JobPool* pool = nullptr;    // nullptr = allocated with new (submitted from a foreign thread)
+
+        alignas(std::max_align_t) std::byte storage[STORAGE_SIZE];
+    };
+
+    class JobSystem {
+        public:
+            // workerCount < 0: one thread per core (including the creating thread)
+            explicit JobSystem(int workerCount = -1);
+            ~JobSystem();
+
+            JobSystem(const JobSystem&) = delete;
+            JobSystem& operator=(const JobSystem&) = delete;
+
+            // function gets executed on any worker. The counter (optional) is increased now and decreased once the job is done.
+            // The function has to fit into Job::STORAGE_SIZE, capture by reference or a pointer if it doesn't.
+            template<typename F>
+            void run(F&& function, JobCounter* counter = nullptr) {
+                submit(createJob(std::forward<F>(function), counter));
+            }
+
+            // Like run, but the job only starts once dependency is done
+            template<typename F>
+            void runAfter(JobCounter& dependency, F&& function, JobCounter* counter = nullptr) {
+                Job* job = createJob(std::forward<F>(function), counter);
+
+                dependency.lockWaitingJobs();
+                if (dependency.value.load(std::memory_order_acquire) == 0) {
+                    dependency.unlockWaitingJobs();
+                    submit(job);
+                    return;
+                }
+                job->next = dependency.waitingJobs;
+                dependency.waitingJobs = job;
+                dependency.unlockWaitingJobs();
+            }
+
+            // Executes other jobs until the counter reaches zero
+            void wait(JobCounter& counter);
+
+            // Calls function(begin, end) for chunks of [0, count) on all workers, returns once every chunk is done.
+            // Chunks are at least minChunkSize big, the calling thread takes the first chunk itself.
+            template<typename F>
+            void parallelFor(size_t count, size_t minChunkSize, F&& function) {
+                if (count == 0) return;
+                if (minChunkSize == 0) minChunkSize = 1;
+
+                size_t maxChunks = (size_t)getThreadCount() * 4;
+                size_t chunkSize = std::max(minChunkSize, (count + maxChunks - 1) / maxChunks);
+                if (chunkSize >= count) {
+                    function((size_t)0, count);
+                    return;
+                }
+
+                JobCounter counter;
+                for (size_t begin = chunkSize; begin < count; begin += chunkSize) {
+                    size_t end = std::min(count, begin + chunkSize);
+                    run([&function, begin, end]() { function(begin, end); }, &counter);
+                }
+                function((size_t)0, chunkSize);
+                wait(counter);
+            }
+
+            // Worker threads + the owning thread
+            unsigned getThreadCount() const {
+                return (unsigned)queues.size();
+            }
+
+            // Index of the calling thread in this JobSystem (0 = owner), -1 for foreign threads
+            int getCurrentThreadIndex() const;
+
+        private:
+            static constexpr size_t QUEUE_CAPACITY = 4096;
+
+            std::vector<std::unique_ptr<WorkStealingDeque<Job>>> queues; // [0] = owner thread
+            std::vector<std::unique_ptr<JobPool>> pools;
+            std::vector<std::thread> workers;
+            uint64_t systemId = 0;          // Unique for the whole process, threads find their index in this JobSystem by it
+
+            // Jobs submitted by threads that don't belong to this JobSystem
+            std::mutex foreignJobsMutex;
+            std::deque<Job*> foreignJobs;
+
+            std::atomic<bool> running = false;
+            std::atomic<int64_t> queuedJobs = 0;
+
+            std::atomic<int> sleepingWorkers = 0;
+            std::mutex sleepMutex;
+            std::condition_variable sleepCondition;
+
+            template<typename F>
+            Job* createJob(F&& function, JobCounter* counter) {
+                using Function = std::decay_t<F>;
+                static_assert(sizeof(Function) <= Job::STORAGE_SIZE, "Job function is too big, capture by reference or a pointer instead");
+                static_assert(alignof(Function) <= alignof(std::max_align_t), "Job function is over-aligned");
+
+                Job* job = allocateJob();
+                new (job->storage) Function(std::forward<F>(function));
+                job->execute = [](Job& job) { (*std::launder(reinterpret_cast<Function*>(job.storage)))(); };
+                job->destroy = [](Job& job) { std::launder(reinterpret_cast<Function*>(job.storage))->~Function(); };
+                job->counter = counter;
+                job->next = nullptr;
+
+                if (counter) counter->value.fetch_add(1, std::memory_order_relaxed);
+                return job;
+            }
+
+            Job* allocateJob();
+            void freeJob(Job* job);
+
+            void submit(Job* job);
+            void execute(Job* job);
+            Job* findJob(int threadIndex);
+            void wakeWorker();
+
+            void workerThread(int threadIndex);
+    };
+
+}
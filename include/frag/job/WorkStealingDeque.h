@@ -0,0 +1,88 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+
+namespace frag {
+
+    /*
+        Chase-Lev work-stealing deque (fixed size, C11 memory model version by Le et al.).
+        Only the owning thread may push() and pop() (LIFO end), every other thread may steal() (FIFO end).
+        Stores plain pointers, the deque never owns them.
+    */
+    template<typename T>
+    class WorkStealingDeque {
+        public:
+            explicit WorkStealingDeque(size_t requestedCapacity) {
+                capacity = 2;
+                while (capacity < requestedCapacity) capacity <<= 1;
+                mask = capacity - 1;
+                items = std::make_unique<std::atomic<T*>[]>(capacity);
+            }
+
+            WorkStealingDeque(const WorkStealingDeque&) = delete;
+            WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+            // Owner only. Returns false if the deque is full.
+            bool push(T* item) {
+                int64_t b = bottom.load(std::memory_order_relaxed);
+                int64_t t = top.load(std::memory_order_acquire);
+                if (b - t >= (int64_t)capacity) return false;
+
+                items[b & mask].store(item, std::memory_order_relaxed);
+                bottom.store(b + 1, std::memory_order_release); // Publishes the item to steal()
+                return true;
+            }
+
+            // Owner only
+            T* pop() {
+                int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+                bottom.store(b, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                int64_t t = top.load(std::memory_order_relaxed);
+
+                if (t > b) {
+                    // Empty
+                    bottom.store(b + 1, std::memory_order_relaxed);
+                    return nullptr;
+                }
+
+                T* item = items[b & mask].load(std::memory_order_relaxed);
+                if (t == b) {
+                    // Last item, race against the thieves
+                    if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) item = nullptr;
+                    bottom.store(b + 1, std::memory_order_relaxed);
+                }
+                return item;
+            }
+
+            // Any thread
+            T* steal() {
+                int64_t t = top.load(std::memory_order_acquire);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                int64_t b = bottom.load(std::memory_order_acquire);
+                if (t >= b) return nullptr;
+
+                T* item = items[t & mask].load(std::memory_order_relaxed);
+                if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) return nullptr;
+                return item;
+            }
+
+            bool empty() const {
+                return bottom.load(std::memory_order_relaxed) <= top.load(std::memory_order_relaxed);
+            }
+
+        private:
+            static constexpr size_t CACHE_LINE_SIZE = 64;
+
+            size_t capacity;
+            size_t mask;
+            std::unique_ptr<std::atomic<T*>[]> items;
+
+            alignas(CACHE_LINE_SIZE) std::atomic<int64_t> top = 0;
+            alignas(CACHE_LINE_SIZE) std::atomic<int64_t> bottom = 0;
+    };
+
+}
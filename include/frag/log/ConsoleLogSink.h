@@ -0,0 +1,23 @@
+#pragma once
+
+#include <iostream>
+
+#include <frag/log/ILogSink.h>
+
+namespace frag {
+
+    // Default sink of the FragLogger, one stream write per batch
+    class ConsoleLogSink : public ILogSink {
+        public:
+            void write(std::string_view lines) override {
+                std::cout.write(lines.data(), lines.size());
+            }
+            void flush() override {
+                std::cout.flush();
+            }
+            bool wantsColor() const override {
+                return true;
+            }
+    };
+
+}
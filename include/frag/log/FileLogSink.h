@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstdio>
+#include <cstdint>
+
+#include <string>
+#include <string_view>
+#include <filesystem>
+#include <chrono>
+
+#include <frag/log/ILogSink.h>
+
+namespace frag {
+
+    /*
+        Writes the log into a file.
+        Lines are collected in a buffer and written with one big write once flushThreshold bytes are
+        buffered or flushInterval has passed, so the file costs one syscall per batch instead of one per line.
+
+        Rotation: Once the file would grow over maxFileSize, it gets renamed to name.1.ext (name.1.ext to name.2.ext, ...)
+        and a new file is started. Only maxRotatedFiles old files are kept. Rotation only happens between lines.
+
+        If the file can't be opened (or reopened after a rotation), the lines are dropped and counted in getBytesDropped().
+        Lines that couldn't be written are tried again with the next flush, up to flushThreshold bytes.
+    */
+    class FileLogSink : public ILogSink {
+        public:
+            struct Settings {
+                size_t maxFileSize = 64 * 1024 * 1024;
+                int maxRotatedFiles = 5;
+                size_t flushThreshold = 256 * 1024;
+                std::chrono::milliseconds flushInterval = std::chrono::milliseconds(1000);
+            };
+
+            explicit FileLogSink(std::filesystem::path path);
+            FileLogSink(std::filesystem::path path, Settings settings);
+            ~FileLogSink() override;
+
+            FileLogSink(const FileLogSink&) = delete;
+            FileLogSink& operator=(const FileLogSink&) = delete;
+
+            void write(std::string_view lines) override;
+            void flush() override;
+            std::chrono::steady_clock::time_point getFlushDeadline() const override;
+
+            bool isOpen() const {
+                return file != nullptr;
+            }
+            uint64_t getBytesWritten() const {
+                return totalBytesWritten;
+            }
+            uint64_t getBytesDropped() const {
+                return droppedBytes;
+            }
+
+        private:
+            std::filesystem::path path;
+            Settings settings;
+
+            std::FILE* file = nullptr;
+            size_t currentFileSize = 0;
+            uint64_t totalBytesWritten = 0;
+            uint64_t droppedBytes = 0;
+            bool writeFailing = false;      // Reported once until a write works again
+
+            std::string buffer;
+            std::chrono::steady_clock::time_point firstBufferedTime;
+
+            void openFile();
+            void rotate();
+            std::filesystem::path getRotatedPath(int index) const;
+    };
+
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <string_view>
+#include <chrono>
+
+namespace frag {
+
+    /*
+        A LogSink is an output target of the FragLogger (console, file, ...).
+        All methods are only called from the logging thread, so a sink doesn't need to be thread-safe itself.
+
+        The logger hands over whole batches of finished, newline terminated lines. A sink is free to
+        buffer them, but everything has to be written out once flush() gets called.
+    */
+    class ILogSink {
+        public:
+            virtual ~ILogSink() = default;
+
+            virtual void write(std::string_view lines) = 0;
+            virtual void flush() = 0;
+
+            // Latest point in time the sink wants to be flushed, max() if nothing is buffered.
+            // The logging thread wakes up for this, even if no new messages arrive.
+            virtual std::chrono::steady_clock::time_point getFlushDeadline() const {
+                return std::chrono::steady_clock::time_point::max();
+            }
+
+            // If true, the lines contain the ANSI color codes (when colorized output is enabled)
+            virtual bool wantsColor() const {
+                return false;
+            }
+    };
+
+}
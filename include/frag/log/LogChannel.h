@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdint>
+
+#ifndef FRAG_LOG_MAX_CHANNELS
+    #define FRAG_LOG_MAX_CHANNELS 32
+#endif
+
+namespace frag {
+
+    /*
+        A LogChannel groups log messages of one subsystem. Every channel has its own runtime log level,
+        so e.g. TRACE can be enabled for the renderer only, without flooding the queue with everything else.
+        Channels that never got an own level just use the global one (logging_setLogLevel).
+
+        The engine channels are predefined, own channels can be created with logging_registerChannel("name").
+    */
+    struct LogChannel {
+        uint8_t id = 0;
+
+        static const LogChannel GENERAL;
+        static const LogChannel CORE;
+        static const LogChannel RENDER;
+        static const LogChannel PACKAGE;
+        static const LogChannel ASSET;
+
+        static constexpr uint8_t BUILTIN_COUNT = 5;
+        static constexpr uint8_t MAX_COUNT = FRAG_LOG_MAX_CHANNELS;
+    };
+
+    inline constexpr LogChannel LogChannel::GENERAL = { 0 };
+    inline constexpr LogChannel LogChannel::CORE = { 1 };
+    inline constexpr LogChannel LogChannel::RENDER = { 2 };
+    inline constexpr LogChannel LogChannel::PACKAGE = { 3 };
+    inline constexpr LogChannel LogChannel::ASSET = { 4 };
+
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+/*
+    FRAG_LOG_COMPILED_LEVEL is the lowest level that gets compiled in at all (set by the CMake option of the same name).
+    Every log call below it is removed at compile time. The FRAG_LOG_* macros in Log.h even remove the
+    arguments, so nothing of the call is evaluated.
+*/
+#define FRAG_LOG_LEVEL_VALUE_TRACE 6
+#define FRAG_LOG_LEVEL_VALUE_DEBUG 5
+#define FRAG_LOG_LEVEL_VALUE_INFO 4
+#define FRAG_LOG_LEVEL_VALUE_WARNING 3
+#define FRAG_LOG_LEVEL_VALUE_ERROR 2
+#define FRAG_LOG_LEVEL_VALUE_FATAL 1
+#define FRAG_LOG_LEVEL_VALUE_NONE 0
+
+#define FRAG_LOG_LEVEL_VALUE_CONCAT(name) FRAG_LOG_LEVEL_VALUE_##name
+#define FRAG_LOG_LEVEL_VALUE(name) FRAG_LOG_LEVEL_VALUE_CONCAT(name)
+
+#ifndef FRAG_LOG_COMPILED_LEVEL
+    #define FRAG_LOG_COMPILED_LEVEL TRACE
+#endif
+
+#define FRAG_LOG_COMPILED_LEVEL_VALUE FRAG_LOG_LEVEL_VALUE(FRAG_LOG_COMPILED_LEVEL)
+
+namespace frag {
+
+    enum class LogLevel {
+        TRACE = 6,
+        DEBUG = 5,
+        INFO = 4,
+        WARNING = 3,
+        ERROR = 2,
+        FATAL = 1,
+        NONE = 0
+    };
+
+    inline constexpr LogLevel compiledLogLevel = (LogLevel)FRAG_LOG_COMPILED_LEVEL_VALUE;
+
+    constexpr bool logLevelCompiledIn(LogLevel level) {
+        return level <= compiledLogLevel;
+    }
+
+}
@@ -0,0 +1,198 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include <string>
+#include <string_view>
+#include <format>
+#include <tuple>
+#include <type_traits>
+
+#include <frag/log/LogLevel.h>
+#include <frag/log/LogChannel.h>
+#include <frag/memory/MemoryTracker.h>
+
+/*
+    LogRecord - One slot of the FragLogger queue.
+    A record does NOT contain the finished log line. In deferred mode it only holds the format string,
+    the level, a timestamp and a binary copy of the arguments, the actual std::format call happens on
+    the logging thread. That way a log call on the game thread is just a few memcpy's into a
+    preallocated slot.
+
+    Deferred arguments:
+    - Arithmetic types (int, float, bool, char, ...) and void pointers are copied as they are.
+    - Strings (std::string, std::string_view, const char*) are copied into the payload as bytes.
+    - Own trivially copyable types can opt in with DeferrableLogArg<T> (needs a std::formatter and a default constructor).
+    Everything else (or too many arguments for the payload) gets formatted on the callers thread instead.
+*/
+
+#ifndef FRAG_LOG_PAYLOAD_SIZE
+    #define FRAG_LOG_PAYLOAD_SIZE 192
+#endif
+
+namespace frag {
+
+    // Specialize this with value = true to allow deferred formatting for your own trivially copyable types
+    template<typename T>
+    struct DeferrableLogArg : std::false_type {};
+
+    template<typename T>
+    struct LogArgCodec {
+        static constexpr bool deferrable = false;
+    };
+
+    template<typename T>
+        requires (std::is_arithmetic_v<T> || std::is_same_v<T, void*> || std::is_same_v<T, const void*> ||
+                  std::is_same_v<T, std::nullptr_t> || DeferrableLogArg<T>::value)
+    struct LogArgCodec<T> {
+        static_assert(std::is_trivially_copyable_v<T>, "Deferred log arguments must be trivially copyable");
+
+        static constexpr bool deferrable = true;
+        using Stored = T;
+
+        static size_t encodedSize(const T&) {
+            return sizeof(T);
+        }
+        static std::byte* encode(std::byte* out, const T& value) {
+            std::memcpy(out, &value, sizeof(T));
+            return out + sizeof(T);
+        }
+        static const std::byte* decode(const std::byte* in, Stored& value) {
+            std::memcpy(&value, in, sizeof(T));
+            return in + sizeof(T);
+        }
+    };
+
+    template<typename T>
+        requires (std::is_same_v<T, std::string> || std::is_same_v<T, std::string_view> ||
+                  std::is_same_v<T, const char*> || std::is_same_v<T, char*>)
+    struct LogArgCodec<T> {
+        static constexpr bool deferrable = true;
+        using Stored = std::string_view;
+
+        static std::string_view view(const T& value) {
+            return std::string_view(value);
+        }
+        static size_t encodedSize(const T& value) {
+            return sizeof(uint32_t) + view(value).size();
+        }
+        static std::byte* encode(std::byte* out, const T& value) {
+            std::string_view str = view(value);
+            uint32_t length = (uint32_t)str.size();
+            std::memcpy(out, &length, sizeof(length));
+            std::memcpy(out + sizeof(length), str.data(), length);
+            return out + sizeof(length) + length;
+        }
+        static const std::byte* decode(const std::byte* in, Stored& value) {
+            uint32_t length;
+            std::memcpy(&length, in, sizeof(length));
+            value = std::string_view((const char*)in + sizeof(length), length);
+            return in + sizeof(length) + length;
+        }
+    };
+
+    template<typename... Args>
+    inline constexpr bool logArgsDeferrable = (LogArgCodec<std::decay_t<Args>>::deferrable && ...);
+
+    struct LogRecord {
+        enum class Kind : uint8_t {
+            DEFERRED,   // payload = encoded arguments, formatted by formatArgs on the logging thread
+            TEXT,       // payload = already formatted message
+            HEAP_TEXT   // payload = std::string*, for messages that didn't fit into the payload
+        };
+        using FormatFn = void (*)(std::string_view fmt, const std::byte* payload, std::string& out);
+
+        Kind kind = Kind::TEXT;
+        LogLevel level = LogLevel::INFO;
+        uint8_t channel = 0;
+        uint16_t payloadSize = 0;
+        uint32_t fmtLength = 0;
+        const char* fmt = nullptr;
+        FormatFn formatArgs = nullptr;
+        int64_t timestamp = 0; // steady_clock nanoseconds
+
+        alignas(8) std::byte payload[FRAG_LOG_PAYLOAD_SIZE];
+
+        static constexpr size_t PAYLOAD_SIZE = FRAG_LOG_PAYLOAD_SIZE;
+
+        // Instantiated once per argument-type-combination, runs on the logging thread
+        template<typename... Ts>
+        static void formatDeferred(std::string_view fmt, const std::byte* payload, std::string& out) {
+            std::tuple<typename LogArgCodec<Ts>::Stored...> values;
+
+            std::apply([&](auto&... value) {
+                const std::byte* in = payload;
+                ((in = LogArgCodec<Ts>::decode(in, value)), ...);
+                (void)in;
+
+                std::vformat_to(std::back_inserter(out), fmt, std::make_format_args(value...));
+            }, values);
+        }
+
+        template<typename... Args>
+        static size_t deferredSize(Args&&... args) {
+            return (size_t(0) + ... + LogArgCodec<std::decay_t<Args>>::encodedSize(args));
+        }
+
+        // Caller has to make sure deferredSize(args...) <= PAYLOAD_SIZE
+        template<typename... Args>
+        void setDeferred(std::string_view format, Args&&... args) {
+            std::byte* out = payload;
+            ((out = LogArgCodec<std::decay_t<Args>>::encode(out, args)), ...);
+
+            kind = Kind::DEFERRED;
+            payloadSize = (uint16_t)(out - payload);
+            fmt = format.data();
+            fmtLength = (uint32_t)format.size();
+            formatArgs = &formatDeferred<std::decay_t<Args>...>;
+        }
+
+        void setText(std::string_view text) {
+            if (text.size() <= PAYLOAD_SIZE) {
+                std::memcpy(payload, text.data(), text.size());
+                kind = Kind::TEXT;
+                payloadSize = (uint16_t)text.size();
+                return;
+            }
+
+            // Rare case, a message that is longer than a whole slot
+            MemoryTagScope memoryTag(MemoryTag::LOGGER);
+            std::string* heapText = new std::string(text);
+            std::memcpy(payload, &heapText, sizeof(heapText));
+            kind = Kind::HEAP_TEXT;
+            payloadSize = sizeof(heapText);
+        }
+
+        // Appends only the message itself (without timestamp or level)
+        void appendMessage(std::string& out) const {
+            switch (kind) {
+                case Kind::DEFERRED:
+                    formatArgs(std::string_view(fmt, fmtLength), payload, out);
+                    break;
+                case Kind::TEXT:
+                    out.append((const char*)payload, payloadSize);
+                    break;
+                case Kind::HEAP_TEXT: {
+                    std::string* heapText;
+                    std::memcpy(&heapText, payload, sizeof(heapText));
+                    out.append(*heapText);
+                    break;
+                }
+            }
+        }
+
+        // Has to be called once the record is consumed or thrown away
+        void release() {
+            if (kind == Kind::HEAP_TEXT) {
+                std::string* heapText;
+                std::memcpy(&heapText, payload, sizeof(heapText));
+                delete heapText;
+            }
+            kind = Kind::TEXT;
+            payloadSize = 0;
+        }
+    };
+
+}
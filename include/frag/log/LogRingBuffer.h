@@ -0,0 +1,122 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+
+namespace frag {
+
+    /*
+        LogRingBuffer - Bounded lock-free queue used by the FragLogger.
+        Based on Dmitry Vyukov's bounded MPMC queue: every slot carries a sequence number that tells
+        producers and consumers whether the slot is free to write or ready to read, so there is no lock
+        and no "alive" flag that has to be polled.
+
+        All slots are allocated once in the constructor. Values are written and read in place through a
+        callback, so nothing gets copied or moved around besides what the callback does itself.
+
+        The FragLogger only has one real consumer (the logging thread), but producers are allowed to pop
+        as well (used by the DROP_OLDEST policy), that's why both sides are CAS based.
+    */
+    template<typename T>
+    class LogRingBuffer {
+        public:
+            // Capacity gets rounded up to the next power of two (minimum 2)
+            explicit LogRingBuffer(size_t requestedCapacity) {
+                capacity = 2;
+                while (capacity < requestedCapacity) capacity <<= 1;
+                mask = capacity - 1;
+
+                slots = std::make_unique<Slot[]>(capacity);
+                for (size_t i = 0; i < capacity; i++) {
+                    slots[i].sequence.store(i, std::memory_order_relaxed);
+                }
+            }
+
+            LogRingBuffer(const LogRingBuffer&) = delete;
+            LogRingBuffer& operator=(const LogRingBuffer&) = delete;
+
+            // Calls write(T&) on a free slot. Returns false if the buffer is full.
+            template<typename Writer>
+            bool tryPush(Writer&& write) {
+                size_t pos = enqueuePos.load(std::memory_order_relaxed);
+                Slot* slot;
+
+                while (true) {
+                    slot = &slots[pos & mask];
+                    size_t seq = slot->sequence.load(std::memory_order_acquire);
+                    intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+
+                    if (diff == 0) {
+                        if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+                    }
+                    else if (diff < 0) {
+                        return false; // Full
+                    }
+                    else {
+                        pos = enqueuePos.load(std::memory_order_relaxed);
+                    }
+                }
+
+                write(slot->value);
+                slot->sequence.store(pos + 1, std::memory_order_release);
+                return true;
+            }
+
+            // Calls read(T&) on the oldest ready slot. Returns false if the buffer is empty.
+            template<typename Reader>
+            bool tryPop(Reader&& read) {
+                size_t pos = dequeuePos.load(std::memory_order_relaxed);
+                Slot* slot;
+
+                while (true) {
+                    slot = &slots[pos & mask];
+                    size_t seq = slot->sequence.load(std::memory_order_acquire);
+                    intptr_t diff = (intptr_t)seq - (intptr_t)(pos + 1);
+
+                    if (diff == 0) {
+                        if (dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+                    }
+                    else if (diff < 0) {
+                        return false; // Empty
+                    }
+                    else {
+                        pos = dequeuePos.load(std::memory_order_relaxed);
+                    }
+                }
+
+                read(slot->value);
+                slot->sequence.store(pos + mask + 1, std::memory_order_release);
+                return true;
+            }
+
+            // Only a snapshot, can already be outdated when it returns
+            bool empty() const {
+                size_t pos = dequeuePos.load(std::memory_order_relaxed);
+                size_t seq = slots[pos & mask].sequence.load(std::memory_order_acquire);
+                return (intptr_t)seq - (intptr_t)(pos + 1) < 0;
+            }
+
+            size_t getCapacity() const {
+                return capacity;
+            }
+
+        private:
+            static constexpr size_t CACHE_LINE_SIZE = 64;
+
+            struct Slot {
+                std::atomic<size_t> sequence;
+                T value;
+            };
+
+            size_t capacity;
+            size_t mask;
+            std::unique_ptr<Slot[]> slots;
+
+            // Producers and the consumer hammer on different positions, keep them on different cache lines
+            alignas(CACHE_LINE_SIZE) std::atomic<size_t> enqueuePos = 0;
+            alignas(CACHE_LINE_SIZE) std::atomic<size_t> dequeuePos = 0;
+    };
+
+}
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <atomic>
+#include <mutex>
+#include <memory_resource>
+#include <new>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+namespace frag {
+
+    /*
+        Bump allocator: every allocation just moves an offset forward, everything is freed at once with reset().
+        Meant for data that only lives for a short, known time (a frame, a loading step), see FrameArena.
+
+        - Allocating is thread-safe and lock-free as long as the current chunk has space, only adding a new chunk locks.
+        - When a chunk is full a new one is added. reset() merges all chunks into one big enough for everything,
+          so after the first frames the arena never touches the upstream resource again.
+        - deallocate does nothing and destructors are never run, only put trivially destructible data in here
+          (or use it through std::pmr containers that are gone before the reset).
+        - It is a std::pmr::memory_resource, so std::pmr containers can use it directly:
+          std::pmr::vector<int> list(&arena);
+    */
+    class LinearArena : public std::pmr::memory_resource {
+        public:
+            static constexpr size_t DEFAULT_CHUNK_SIZE = 256 * 1024;
+
+            explicit LinearArena(size_t chunkSize = DEFAULT_CHUNK_SIZE, std::pmr::memory_resource* upstream = std::pmr::new_delete_resource());
+            ~LinearArena() override;
+
+            LinearArena(const LinearArena&) = delete;
+            LinearArena& operator=(const LinearArena&) = delete;
+
+            template<typename T, typename... Args>
+            T* create(Args&&... args) {
+                static_assert(std::is_trivially_destructible_v<T>, "The arena never runs destructors.");
+                return new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+            }
+            // Not initialized (like new T[count] for trivial types)
+            template<typename T>
+            std::span<T> allocateArray(size_t count) {
+                static_assert(std::is_trivially_destructible_v<T>, "The arena never runs destructors.");
+                if (count == 0) return {};
+                return std::span<T>(new (allocate(sizeof(T) * count, alignof(T))) T[count], count);
+            }
+
+            // Frees everything at once. Not thread-safe, nobody may allocate from the arena meanwhile.
+            void reset();
+
+            // Bytes handed out since the last reset (including alignment padding)
+            size_t getUsedBytes() const;
+            // Size of all chunks
+            size_t getCapacity() const;
+            // Most bytes that were used between two resets
+            size_t getPeakBytes() const {
+                return peakBytes;
+            }
+            // Chunks added since the arena was created, stops growing once the arena is big enough
+            size_t getChunkAllocationCount() const {
+                return chunkAllocationCount.load(std::memory_order_relaxed);
+            }
+
+        private:
+            // Header in front of the memory of every chunk
+            struct alignas(std::max_align_t) Chunk {
+                Chunk* previous = nullptr;
+                size_t capacity = 0;
+                std::atomic<size_t> used = 0;
+
+                std::byte* getData() {
+                    return reinterpret_cast<std::byte*>(this + 1);
+                }
+            };
+
+            std::pmr::memory_resource* upstream;
+            size_t chunkSize;
+
+            std::atomic<Chunk*> current = nullptr;  // The newest chunk, the older ones are only kept to be freed
+            std::mutex growMutex;
+            size_t peakBytes = 0;
+            std::atomic<size_t> chunkAllocationCount = 0;
+
+            void* do_allocate(size_t bytes, size_t alignment) override;
+            void do_deallocate(void*, size_t, size_t) override {}
+            bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+                return this == &other;
+            }
+
+            // Tries to bump the offset of the chunk, nullptr if it doesn't fit
+            static void* allocateFrom(Chunk* chunk, size_t bytes, size_t alignment);
+            Chunk* addChunk(size_t minCapacity);
+            void freeChunks(Chunk* chunk);
+    };
+
+    /*
+        Two LinearArenas that take turns, one per frame. Core::getFrameArena returns the one of the current frame.
+        Memory from it stays valid until the end of the next frame, so jobs that are started in one frame and
+        finished in the next can keep using it. beginFrame() switches and resets the arena from two frames ago.
+    */
+    class FrameArena {
+        public:
+            explicit FrameArena(size_t chunkSize = LinearArena::DEFAULT_CHUNK_SIZE) : arenas{ LinearArena(chunkSize), LinearArena(chunkSize) } {}
+
+            void beginFrame() {
+                currentIndex ^= 1;
+                arenas[currentIndex].reset();
+            }
+
+            LinearArena& getCurrent() {
+                return arenas[currentIndex];
+            }
+            LinearArena& getPrevious() {
+                return arenas[currentIndex ^ 1];
+            }
+
+        private:
+            LinearArena arenas[2];
+            int currentIndex = 0;
+    };
+
+}
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <array>
+#include <utility>
+
+/*
+    MemoryTracker - Counts the heap memory of the Fragmental Engine per subsystem
+    Only exists if the engine is built with FRAG_ENABLE_MEMORY_TRACKING (defines FRAG_MEMORY_TRACKING=1, ON by default).
+    Without it the memory_* functions return nothing and MemoryTagScope does nothing.
+
+    - The engine replaces the global operator new / delete. Every allocation gets a small header with its size and
+      the MemoryTag of the thread that made it, so the memory is also counted right when another thread frees it.
+    - The tag of a thread is set with MemoryTagScope. Engine subsystems set theirs, everything else counts as USER.
+    - Every thread counts into its own counters (no locks, no read-modify-write atomics), they are only added up
+      at the end of a frame (memory_endFrame, Core does that) or when the stats are read.
+    - memory_setReportInterval logs one line with all tags every few frames.
+    - Core logs a leak report when it is destroyed (see MemoryLeakCheck).
+*/
+
+#ifndef FRAG_MEMORY_TRACKING
+    #define FRAG_MEMORY_TRACKING 0
+#endif
+
+namespace frag {
+
+    enum class MemoryTag : uint8_t {
+        USER,       // Everything that isn't inside a MemoryTagScope
+        CORE,       // Core itself and the JobSystem
+        LOGGER,
+        GLOBAL,     // Engine state that lives as long as the process (profiler, component registry)
+        PACKAGE,
+        ASSET,
+        RENDER,
+        COUNT
+    };
+    inline constexpr size_t MEMORY_TAG_COUNT = (size_t)MemoryTag::COUNT;
+
+    const char* getMemoryTagName(MemoryTag tag);
+
+    struct MemoryTagStats {
+        size_t liveBytes = 0;           // Allocated and not freed yet
+        size_t peakBytes = 0;           // Highest liveBytes seen at the end of a frame (or when the stats were read)
+        size_t liveAllocations = 0;
+        uint64_t totalAllocations = 0;  // Since the start of the process
+        uint64_t frameAllocations = 0;  // During the last finished frame
+        size_t frameBytes = 0;          // Allocated during the last finished frame
+    };
+    using MemorySnapshot = std::array<MemoryTagStats, MEMORY_TAG_COUNT>;
+
+#if FRAG_MEMORY_TRACKING
+
+    namespace detail {
+        inline thread_local MemoryTag currentMemoryTag = MemoryTag::USER;
+    }
+
+    // Everything the current thread allocates while it exists counts for tag
+    class MemoryTagScope {
+        public:
+            explicit MemoryTagScope(MemoryTag tag) : previousTag(std::exchange(detail::currentMemoryTag, tag)) {}
+            ~MemoryTagScope() {
+                detail::currentMemoryTag = previousTag;
+            }
+
+            MemoryTagScope(const MemoryTagScope&) = delete;
+            MemoryTagScope& operator=(const MemoryTagScope&) = delete;
+
+        private:
+            MemoryTag previousTag;
+    };
+
+    /*
+        Takes a snapshot when it is created and logs every tag that holds more memory when it is destroyed.
+        Core has one as its first member, so the report comes after everything else of the Core is gone.
+        The logger and the GLOBAL state live longer than any Core, their tags are left out.
+    */
+    class MemoryLeakCheck {
+        public:
+            MemoryLeakCheck();
+            ~MemoryLeakCheck();
+
+            MemoryLeakCheck(const MemoryLeakCheck&) = delete;
+            MemoryLeakCheck& operator=(const MemoryLeakCheck&) = delete;
+
+        private:
+            MemorySnapshot baseline;
+    };
+
+    constexpr bool memory_isTrackingEnabled() { return true; }
+
+    MemoryTagStats memory_getStats(MemoryTag tag);
+    MemorySnapshot memory_getAllStats();
+
+    // Closes the frame for the per frame counts and the peaks, Core calls it at the end of every frame
+    void memory_endFrame();
+    // Logs one line with all tags every frames frames, 0 = never
+    void memory_setReportInterval(uint32_t frames);
+    void memory_logReport();
+
+#else
+
+    class MemoryTagScope {
+        public:
+            explicit MemoryTagScope(MemoryTag) {}
+    };
+
+    class MemoryLeakCheck {};
+
+    constexpr bool memory_isTrackingEnabled() { return false; }
+
+    inline MemoryTagStats memory_getStats(MemoryTag) { return {}; }
+    inline MemorySnapshot memory_getAllStats() { return {}; }
+
+    inline void memory_endFrame() {}
+    inline void memory_setReportInterval(uint32_t) {}
+    inline void memory_logReport() {}
+
+#endif
+
+}
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <memory>
+#include <mutex>
+#include <memory_resource>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace frag {
+
+    /*
+        Hands out blocks of one fixed size. Freed blocks go to a free list and are reused right away,
+        new memory is only taken from the upstream resource (blocksPerChunk blocks at once) when the list is empty.
+        The chunks are given back when the pool is destroyed, so the pool only grows to the most blocks used at once.
+        Thread-safe, the lock is only held for a few instructions.
+    */
+    class FixedBlockPool {
+        public:
+            explicit FixedBlockPool(size_t blockSize, size_t blockAlignment = alignof(std::max_align_t), size_t blocksPerChunk = 64,
+                std::pmr::memory_resource* upstream = std::pmr::new_delete_resource());
+            ~FixedBlockPool();
+
+            FixedBlockPool(const FixedBlockPool&) = delete;
+            FixedBlockPool& operator=(const FixedBlockPool&) = delete;
+
+            void* allocate();
+            // block has to come from this pool
+            void deallocate(void* block);
+
+            size_t getBlockSize() const {
+                return blockSize;
+            }
+            // Blocks that are allocated right now
+            size_t getUsedBlocks() const;
+            // Blocks in all chunks, used or not
+            size_t getCapacity() const;
+
+        private:
+            struct FreeBlock {
+                FreeBlock* next;
+            };
+
+            std::pmr::memory_resource* upstream;
+            size_t blockSize;
+            size_t blockAlignment;
+            size_t blocksPerChunk;
+
+            mutable std::mutex mutex;
+            FreeBlock* freeList = nullptr;
+            std::vector<void*> chunks;
+            size_t usedBlocks = 0;
+
+            // Expects the mutex to be locked
+            void addChunk();
+    };
+
+    /*
+        FixedBlockPool for objects of one type, for objects that are created and destroyed all the time
+        (e.g. the records of streamed assets). create/destroy instead of new/delete.
+    */
+    template<typename T>
+    class ObjectPool {
+        public:
+            explicit ObjectPool(size_t objectsPerChunk = 64, std::pmr::memory_resource* upstream = std::pmr::new_delete_resource())
+                : pool(sizeof(T), alignof(T), objectsPerChunk, upstream) {}
+
+            template<typename... Args>
+            T* create(Args&&... args) {
+                void* memory = pool.allocate();
+                try {
+                    return new (memory) T(std::forward<Args>(args)...);
+                }
+                catch (...) {
+                    pool.deallocate(memory);
+                    throw;
+                }
+            }
+            void destroy(T* object) {
+                if (!object) return;
+                object->~T();
+                pool.deallocate(object);
+            }
+
+            size_t getUsedCount() const {
+                return pool.getUsedBlocks();
+            }
+
+        private:
+            FixedBlockPool pool;
+    };
+
+    /*
+        std::pmr::memory_resource on top of FixedBlockPools, one per size class (16, 32, 64, 128 and 256 bytes).
+        Bigger allocations (or ones with a bigger alignment) go to the upstream resource.
+        Give it to node based std::pmr containers (maps, lists) whose nodes come and go every frame:
+        std::pmr::unordered_map<FragHash, int> map(&poolResource);
+    */
+    class PoolResource : public std::pmr::memory_resource {
+        public:
+            static constexpr size_t MIN_BLOCK_SIZE = 16;
+            static constexpr size_t MAX_BLOCK_SIZE = 256;
+
+            explicit PoolResource(size_t blocksPerChunk = 64, std::pmr::memory_resource* upstream = std::pmr::new_delete_resource());
+
+            PoolResource(const PoolResource&) = delete;
+            PoolResource& operator=(const PoolResource&) = delete;
+
+            // Blocks of all size classes that are allocated right now (without the ones of the upstream resource)
+            size_t getUsedBlocks() const;
+
+        private:
+            static constexpr size_t CLASS_COUNT = 5;
+
+            std::pmr::memory_resource* upstream;
+            std::unique_ptr<FixedBlockPool> pools[CLASS_COUNT];
+
+            void* do_allocate(size_t bytes, size_t alignment) override;
+            void do_deallocate(void* memory, size_t bytes, size_t alignment) override;
+            bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+                return this == &other;
+            }
+
+            // -1 if the allocation goes to the upstream resource
+            static int getSizeClass(size_t bytes, size_t alignment);
+    };
+
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+/*
+    Stable 64bit string hashes for every key of the engine (packages, game states, assets, components...).
+    Unlike std::hash these are the same on every compiler, standard library and platform, so they can be
+    written into save files and asset archives.
+
+    "Name"_fh hashes at compile time (FNV-1a). Keys inside a package are namespaced by combining the package
+    hash with the key hash, that's just a few multiplications and no string hashing at all:
+
+        constexpr FragHash MAIN_MENU = fragHashCombine("TestPackage"_fh, "MainMenuState"_fh);
+        package.hasGameState("MainMenuState"_fh); // same key
+*/
+
+namespace frag {
+
+    using FragHash = std::uint64_t;
+
+    inline constexpr FragHash FRAG_HASH_OFFSET_BASIS = 14695981039346656037ull;
+    inline constexpr FragHash FRAG_HASH_PRIME = 1099511628211ull;
+
+    // Continues a hash with more text, fragHashAppend(fragHash("ab"), "cd") == fragHash("abcd")
+    constexpr FragHash fragHashAppend(FragHash hash, std::string_view text) {
+        for (char c : text) {
+            hash ^= (FragHash)(unsigned char)c;
+            hash *= FRAG_HASH_PRIME;
+        }
+        return hash;
+    }
+
+    constexpr FragHash fragHash(std::string_view text) {
+        return fragHashAppend(FRAG_HASH_OFFSET_BASIS, text);
+    }
+
+    // Namespaces keyHash by packageHash. Not symmetric, so (a, b) and (b, a) are different keys.
+    constexpr FragHash fragHashCombine(FragHash packageHash, FragHash keyHash) {
+        FragHash hash = packageHash ^ (keyHash + 0x9E3779B97F4A7C15ull + (packageHash << 6) + (packageHash >> 2));
+
+        // Finalizer of MurmurHash3, spreads the bits of both inputs over the whole result
+        hash ^= hash >> 33;
+        hash *= 0xFF51AFD7ED558CCDull;
+        hash ^= hash >> 33;
+        hash *= 0xC4CEB9FE1A85EC53ull;
+        hash ^= hash >> 33;
+        return hash;
+    }
+
+    inline namespace literals {
+        consteval FragHash operator""_fh(const char* text, std::size_t length) {
+            return fragHash(std::string_view(text, length));
+        }
+    }
+
+}
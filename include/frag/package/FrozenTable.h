@@ -0,0 +1,247 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <span>
+#include <algorithm>
+#include <type_traits>
+
+#if defined(_MSC_VER)
+    #include <intrin.h>
+#endif
+
+#include <frag/package/FragHash.h>
+
+namespace frag {
+
+    /*
+        All names of a frozen package in one contiguous buffer.
+        Tables only store a StringRef (offset + length) instead of a std::string per entry.
+        Can also be a view of memory owned by someone else (e.g. a mapped package snapshot).
+    */
+    class StringArena {
+        public:
+            struct StringRef {
+                uint32_t offset = 0;
+                uint32_t length = 0;
+            };
+
+            StringRef add(std::string_view text) {
+                if (storage.data() != view.data()) {
+                    storage.assign(view);
+                }
+                StringRef ref = { (uint32_t)storage.size(), (uint32_t)text.size() };
+                storage.append(text);
+                storage.push_back('\0'); // So names can be handed to C APIs as well
+                view = storage;
+                return ref;
+            }
+
+            std::string_view get(StringRef ref) const {
+                return view.substr(ref.offset, ref.length);
+            }
+            bool isValid(StringRef ref) const {
+                return ref.offset <= view.size() && ref.length <= view.size() - ref.offset;
+            }
+
+            // Uses the given memory instead of an own buffer, it has to outlive the arena
+            void setView(std::string_view data) {
+                storage.clear();
+                storage.shrink_to_fit();
+                view = data;
+            }
+
+            std::string_view getData() const {
+                return view;
+            }
+            size_t getSize() const {
+                return view.size();
+            }
+            void shrinkToFit() {
+                storage.shrink_to_fit();
+                view = storage;
+            }
+
+        private:
+            std::string storage;
+            std::string_view view;
+    };
+
+    /*
+        FrozenTable - immutable FragHash -> Value table for finished packages.
+
+        The entries are stored in one sorted array, and a minimal-ish perfect hash (hash and displace)
+        maps every key to its entry: the key picks a bucket, the seed of that bucket picks the slot.
+        The seeds are searched at build time so that no two keys share a slot, so a lookup is always
+        exactly one probe, without chains, tombstones or pointer chasing.
+
+        Value has to be trivially copyable, names go into a StringArena. That way the arrays can be written
+        into a file as they are and used directly from a mapped file again (setView).
+    */
+    template<typename Value>
+    class FrozenTable {
+        public:
+            static_assert(std::is_trivially_copyable_v<Value>, "FrozenTable values have to be trivially copyable");
+
+            struct Entry {
+                FragHash key;
+                Value value;
+            };
+
+            FrozenTable() = default;
+            FrozenTable(const FrozenTable&) = delete; // The spans would point into the other table
+            FrozenTable& operator=(const FrozenTable&) = delete;
+
+            // Keys have to be unique. Returns false (and stays empty) if that's not the case.
+            bool build(std::vector<Entry> newEntries) {
+                clear();
+                if (newEntries.empty()) return true;
+
+                std::sort(newEntries.begin(), newEntries.end(), [](const Entry& a, const Entry& b) { return a.key < b.key; });
+                for (size_t i = 1; i < newEntries.size(); i++) {
+                    if (newEntries[i].key == newEntries[i - 1].key) return false;
+                }
+
+                // About 80% load, grows if the seed search fails (practically never happens)
+                size_t slotCount = newEntries.size() + newEntries.size() / 4 + 1;
+                while (!buildSeeds(newEntries, slotCount)) slotCount *= 2;
+
+                ownedEntries = std::move(newEntries);
+                entries = ownedEntries;
+                seeds = ownedSeeds;
+                slots = ownedSlots;
+                return true;
+            }
+
+            // Uses arrays from getEntries/getSeeds/getSlots of another table, that memory has to outlive this table.
+            // The arrays are checked so a broken file can't cause out of bounds reads. Returns false (and stays empty) if they are broken.
+            bool setView(std::span<const Entry> newEntries, std::span<const uint32_t> newSeeds, std::span<const uint32_t> newSlots) {
+                clear();
+                if (newEntries.empty()) return newSeeds.empty() && newSlots.empty();
+                if (newSeeds.empty() || newSlots.size() < newEntries.size()) return false;
+
+                size_t used = 0;
+                for (uint32_t index : newSlots) {
+                    if (index == EMPTY_SLOT) continue;
+                    if (index >= newEntries.size()) return false;
+                    used++;
+                }
+                if (used != newEntries.size()) return false;
+
+                entries = newEntries;
+                seeds = newSeeds;
+                slots = newSlots;
+                return true;
+            }
+
+            void clear() {
+                ownedEntries.clear();
+                ownedSeeds.clear();
+                ownedSlots.clear();
+                entries = {};
+                seeds = {};
+                slots = {};
+            }
+
+            const Value* find(FragHash key) const {
+                if (entries.empty()) return nullptr;
+
+                uint32_t seed = seeds[reduce(fragHashCombine(key, BUCKET_SEED), seeds.size())];
+                uint32_t index = slots[reduce(fragHashCombine(key, seed), slots.size())];
+                if (index == EMPTY_SLOT || entries[index].key != key) return nullptr;
+                return &entries[index].value;
+            }
+            bool contains(FragHash key) const {
+                return find(key) != nullptr;
+            }
+
+            size_t size() const {
+                return entries.size();
+            }
+            // Sorted by key
+            std::span<const Entry> getEntries() const {
+                return entries;
+            }
+            std::span<const uint32_t> getSeeds() const {
+                return seeds;
+            }
+            std::span<const uint32_t> getSlots() const {
+                return slots;
+            }
+            size_t getMemoryUsage() const {
+                return entries.size_bytes() + seeds.size_bytes() + slots.size_bytes();
+            }
+
+        private:
+            static constexpr uint32_t EMPTY_SLOT = 0xFFFFFFFF;
+            static constexpr uint32_t MAX_SEED_TRIES = 1u << 16;
+            static constexpr FragHash BUCKET_SEED = ~0ull; // Keys don't have to be well mixed (e.g. plain FNV-1a), so they get mixed once more
+
+            // Either point into the owned vectors or into memory of someone else (setView)
+            std::span<const Entry> entries;
+            std::span<const uint32_t> seeds;   // One per bucket
+            std::span<const uint32_t> slots;   // Slot -> index in entries
+
+            std::vector<Entry> ownedEntries;
+            std::vector<uint32_t> ownedSeeds;
+            std::vector<uint32_t> ownedSlots;
+
+            // Maps a hash to [0, range) without a division
+            static size_t reduce(FragHash hash, size_t range) {
+                #if defined(_MSC_VER)
+                    return (size_t)__umulh(hash, (uint64_t)range);
+                #else
+                    return (size_t)(((unsigned __int128)hash * range) >> 64);
+                #endif
+            }
+
+            bool buildSeeds(const std::vector<Entry>& sortedEntries, size_t slotCount) {
+                size_t bucketCount = std::max<size_t>(sortedEntries.size() / 2, 1);
+
+                std::vector<std::vector<uint32_t>> buckets(bucketCount);
+                for (uint32_t i = 0; i < sortedEntries.size(); i++) {
+                    buckets[reduce(fragHashCombine(sortedEntries[i].key, BUCKET_SEED), bucketCount)].push_back(i);
+                }
+
+                // Biggest buckets first, they are the hardest to place
+                std::vector<uint32_t> order(bucketCount);
+                for (uint32_t i = 0; i < bucketCount; i++) order[i] = i;
+                std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return buckets[a].size() > buckets[b].size(); });
+
+                ownedSeeds.assign(bucketCount, 0);
+                ownedSlots.assign(slotCount, EMPTY_SLOT);
+                std::vector<size_t> candidateSlots;
+
+                for (uint32_t bucketIndex : order) {
+                    const std::vector<uint32_t>& bucket = buckets[bucketIndex];
+                    if (bucket.empty()) break;
+
+                    bool placed = false;
+                    for (uint32_t seed = 0; seed < MAX_SEED_TRIES && !placed; seed++) {
+                        candidateSlots.clear();
+                        placed = true;
+                        for (uint32_t entryIndex : bucket) {
+                            size_t slot = reduce(fragHashCombine(sortedEntries[entryIndex].key, seed), slotCount);
+                            if (ownedSlots[slot] != EMPTY_SLOT || std::find(candidateSlots.begin(), candidateSlots.end(), slot) != candidateSlots.end()) {
+                                placed = false;
+                                break;
+                            }
+                            candidateSlots.push_back(slot);
+                        }
+
+                        if (placed) {
+                            ownedSeeds[bucketIndex] = seed;
+                            for (size_t i = 0; i < bucket.size(); i++) ownedSlots[candidateSlots[i]] = bucket[i];
+                        }
+                    }
+                    if (!placed) return false;
+                }
+                return true;
+            }
+    };
+
+}
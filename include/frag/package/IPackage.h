@@ -11,22 +11,37 @@
 #include <functional>
 
 #include <frag/Log.h>
+#include <frag/profile/Profiler.h>
+#include <frag/ecs/Component.h>
+#include <frag/package/FragHash.h>
+#include <frag/package/FrozenTable.h>
+#include <frag/io/MappedFile.h>
 
 namespace frag {
 
     /*
         The Package Interface is basically the core of every Package.
         Every Component, Asset, GameState or Scene belongs to an Package.
-        Every string-key used in the Package is stored as a 64bit-hash to speed up lookups.
-        If you should ever get a hash-collision (which is very unlikely), just change the name a bit :P
+        Every string-key used in the Package is stored as a 64bit-hash to speed up lookups (see FragHash.h).
+        The hashes are stable, so they can be stored in save files.
+        If you should ever get a hash-collision (which is very unlikely), it gets logged as an error and the
+        second name is ignored, just change the name a bit :P
 
         Once a Package is setup, it cannot be changed anymore.
-        A Package is read only after setup.
+        A Package is read only after setup: finishPackage() freezes every registry into a flat FrozenTable
+        (one probe per lookup), the names into one StringArena, and frees the setup maps.
 
         Every String-Key will be renamed to packageName::keyName to avoid conflicts between Packages, so
-        you dont have to worry about that.
+        you dont have to worry about that. The key hash is fragHashCombine(packageHash, "keyName"_fh),
+        so lookups with a "keyName"_fh literal don't hash any strings at runtime.
+
+        A finished Package can be saved as a binary snapshot (saveSnapshot). Loading it again (loadSnapshot)
+        maps the file and uses the tables in it directly, without running setupPackage at all.
+        setupWithSnapshot does all of that: load the snapshot, or setup and write a new one if that fails.
     */
     class IPackage {
+        friend class PackageRegistry;
+
         public:
             virtual ~IPackage() = default;
 
@@ -38,68 +53,148 @@ namespace frag {
                 - Register Scenes
             */
             virtual void setupPackage() = 0;
+            /*
+                Register Components here instead of in setupPackage, if the package should be loadable from a snapshot.
+                Component types only exist in code, so this still runs when the rest comes from the snapshot.
+                finishPackage calls it.
+            */
+            virtual void setupComponents() {}
+            // Increase this when setupPackage registers something else, old snapshots are rebuilt then
+            virtual uint64_t getSnapshotVersion() const {
+                return 0;
+            }
+
             // Call This after setupPackage to finish the package
             void finishPackage() {
+                FRAG_PROFILE_ZONE("IPackage::finishPackage");
+
                 if (packageIsSetup) {
-                    logWarn("Package {} is already setup, cannot finish it again.", packageName);
+                    logWarn(LogChannel::PACKAGE, "Package {} is already setup, cannot finish it again.", packageName);
                     return;
                 }
                 if (!packageNameSet) {
-                    logWarn("Package name is not set yet, cannot finish package.");
+                    logWarn(LogChannel::PACKAGE, "Package name is not set yet, cannot finish package.");
                     return;
                 }
-                
-                packageHash = 0;
-                packageAsString = toString();
+
+                setupComponents();
+                freezeRegistries();
                 packageIsSetup = true;
             }
 
+            // Writes the finished package into a snapshot file. Returns false if it couldn't be written.
+            bool saveSnapshot(const std::filesystem::path& path) const;
+            // Sets the package up from a snapshot instead of setupPackage. Returns false (and leaves the package untouched)
+            // if the file is missing, broken, from another format/snapshot version or a component type is missing.
+            bool loadSnapshot(const std::filesystem::path& path);
+            // loadSnapshot, or setupPackage + finishPackage + saveSnapshot if there is no valid snapshot
+            void setupWithSnapshot(const std::filesystem::path& path);
+
             // Setup Methods
             void rPackageName(std::string_view name) {
                 if (packageIsSetup) {
-                    logWarn("Package {} is already setup, cannot set package name to '{}'", packageName, name);
+                    logWarn(LogChannel::PACKAGE, "Package {} is already setup, cannot set package name to '{}'", packageName, name);
                     return;
                 }
                 if (packageNameSet) {
-                    logWarn("Package name already set to '{}', cannot set it again to '{}'", packageName, name);
+                    logWarn(LogChannel::PACKAGE, "Package name already set to '{}', cannot set it again to '{}'", packageName, name);
                     return;
                 }
 
                 packageName = "p:" + std::string(name);
+                packageHash = fragHash(name);
                 packageNameSet = true;
             }
             
             void rGameState(std::string_view name) {
-                std::hash<std::string> stringHash;
-                std::string nameAsString = std::string(name);
-                registeredGameStates.insert({stringHash(nameAsString), nameAsString});
+                if (!canRegister("game state", name)) return;
+
+                FragHash key = getKey(fragHash(name));
+                std::string fullName = packageName + "::" + std::string(name);
+                if (!isKeyFree(registeredGameStates, key, fullName, "game state")) return;
+                registeredGameStates.insert({key, fullName});
+            };
+            void rAsset(int type, std::string_view name, std::filesystem::path assetPath) {
+                if (!canRegister("asset", name)) return;
+
+                FragHash key = getKey(fragHash(name));
+                std::string fullName = packageName + "::" + std::string(name);
+                if (!isKeyFree(registeredAssets, key, fullName, "asset")) return;
+                registeredAssets.insert({key, {type, fullName, std::move(assetPath)}});
             };
-            void rAsset(int type, std::string_view name, std::filesystem::path assetPath) {};
 
-            class IComponent;
+            /*
+                Components are plain structs, no base class needed (see ecs/Component.h).
+                The data itself lives in a World, this just gives T its compact ComponentId and its name.
+            */
             template<typename T>
-            void rComponent(std::string_view name, T componentClass) {
-                if (packageIsSetup) {
-                    logWarn("Package {} is already setup, cannot register component '{}'", packageName, name);
+            void rComponent(std::string_view name) {
+                if (loadingSnapshot) {
+                    // The component table comes from the snapshot, only the type has to be known
+                    registerComponent<T>(packageName + "::" + std::string(name));
                     return;
                 }
+                if (!canRegister("component", name)) return;
 
-                static_assert(std::is_base_of<IPackage::IComponent, T>::value, "T must be derived from IPackage::IComponent"); // Change that later to the actual Component base class
+                FragHash key = getKey(fragHash(name));
+                std::string fullName = packageName + "::" + std::string(name);
+                if (!isKeyFree(registeredComponents, key, fullName, "component")) return;
+                ComponentId id = registerComponent<T>(fullName);
+                registeredComponents.insert({key, {fullName, id}});
             }
 
             // Get Methods
             std::string getPackageName() {
                 return packageName;
             }
-            std::uint64_t getPackageHash() {
-                return 0;
+            // fragHash of the name given to rPackageName, e.g. "TestPackage"_fh
+            FragHash getPackageHash() const {
+                return packageHash;
+            }
+            bool isSetup() const {
+                return packageIsSetup;
+            }
+            // Namespaced key of a name in this package, e.g. getKey("MainMenuState"_fh)
+            FragHash getKey(FragHash nameHash) const {
+                return fragHashCombine(packageHash, nameHash);
+            }
+
+            // Lookups, only work after finishPackage
+            bool hasGameState(FragHash nameHash) const {
+                return frozenGameStates.contains(getKey(nameHash));
+            }
+            bool hasAsset(FragHash nameHash) const {
+                return frozenAssets.contains(getKey(nameHash));
+            }
+            // -1 if the package has no asset with that name
+            int getAssetType(FragHash nameHash) const {
+                const frozenAsset* asset = frozenAssets.find(getKey(nameHash));
+                return asset ? asset->type : -1;
+            }
+            // Empty if the package has no asset with that name
+            std::string_view getAssetPath(FragHash nameHash) const {
+                const frozenAsset* asset = frozenAssets.find(getKey(nameHash));
+                return asset ? stringArena.get(asset->path) : std::string_view();
+            }
+            // INVALID_COMPONENT_ID if the package has no component with that name
+            ComponentId getComponentId(FragHash nameHash) const {
+                const frozenComponent* component = frozenComponents.find(getKey(nameHash));
+                return component ? component->id : INVALID_COMPONENT_ID;
+            }
+            // Calls function(key, type, path) for every asset, only works after finishPackage
+            template<typename F>
+            void forEachAsset(F&& function) const {
+                for (const auto& entry : frozenAssets.getEntries()) {
+                    function(entry.key, entry.value.type, stringArena.get(entry.value.path));
+                }
             }
             std::string getPackageAsString() {
                 if (!packageIsSetup) {
-                    packageAsString = "Package not setup yet.";
-                    return packageAsString;
+                    return "Package not setup yet.";
                 }
 
+                // Only generated when somebody actually wants it
+                if (packageAsString.empty()) packageAsString = toString();
                 return packageAsString;
             }
 
@@ -109,26 +204,89 @@ namespace frag {
 
         private:
             std::string packageName;
-            uint64_t packageHash;
+            FragHash packageHash = 0;
 
             std::string packageAsString;
 
             bool packageIsSetup = false;
             bool packageNameSet = false;
+            bool loadingSnapshot = false;
 
-            std::unordered_map<std::uint64_t, std::string> registeredGameStates; // Game States are stored in hashes
+            std::unordered_map<FragHash, std::string> registeredGameStates; // Game States are stored in hashes
 
             struct assetInfo {
                 int type;
                 std::string name;
                 std::filesystem::path path;
             };
-            std::unordered_map<std::uint64_t, assetInfo> registeredAssets; // Assets-Names are stored in hashes
+            std::unordered_map<FragHash, assetInfo> registeredAssets; // Assets-Names are stored in hashes
+
+            struct componentInfo {
+                std::string name;
+                ComponentId id;
+            };
+            std::unordered_map<FragHash, componentInfo> registeredComponents;
+
+            // Built by finishPackage out of the registered* maps above
+            struct frozenGameState {
+                StringArena::StringRef name;
+            };
+            struct frozenAsset {
+                int type;
+                StringArena::StringRef name;
+                StringArena::StringRef path;
+            };
+            struct frozenComponent {
+                StringArena::StringRef name;
+                ComponentId id;
+            };
+            StringArena stringArena;
+            StringArena::StringRef packageNameRef;
+            FrozenTable<frozenGameState> frozenGameStates;
+            FrozenTable<frozenAsset> frozenAssets;
+            FrozenTable<frozenComponent> frozenComponents;
+
+            MappedFile snapshotFile; // Backs stringArena and the frozen tables if the package was loaded from a snapshot
 
 
 
             // Methods
 
+            bool canRegister(std::string_view what, std::string_view name) {
+                if (packageIsSetup || loadingSnapshot) {
+                    logWarn(LogChannel::PACKAGE, "Package {} is already setup, cannot register {} '{}'", packageName, what, name);
+                    return false;
+                }
+                if (!packageNameSet) {
+                    logWarn(LogChannel::PACKAGE, "Package name is not set yet, cannot register {} '{}'", what, name);
+                    return false;
+                }
+                return true;
+            }
+
+            static std::string_view nameOf(const std::string& gameState) { return gameState; }
+            static std::string_view nameOf(const assetInfo& asset) { return asset.name; }
+            static std::string_view nameOf(const componentInfo& component) { return component.name; }
+
+            // Logs duplicates and hash collisions
+            template<typename Map>
+            bool isKeyFree(const Map& registry, FragHash key, std::string_view fullName, std::string_view what) {
+                auto it = registry.find(key);
+                if (it == registry.end()) return true;
+
+                if (nameOf(it->second) == fullName) {
+                    logWarn(LogChannel::PACKAGE, "The {} '{}' is already registered.", what, fullName);
+                }
+                else {
+                    logError(LogChannel::PACKAGE, "Hash collision between the {}s '{}' and '{}' ({}), '{}' is ignored. Please rename one of them.",
+                        what, nameOf(it->second), fullName, key, fullName);
+                }
+                return false;
+            }
+
+            // Moves the registered* maps into the frozen tables
+            void freezeRegistries();
+
             /*
                 Includes Formatting
             */
@@ -138,16 +296,22 @@ namespace frag {
                 ss << "Package: " << packageName << "\n";
                 ss << "Package Hash: " << packageHash << "\n";
                 ss << "GameStates: " << "\n";
-                for (auto state : registeredGameStates) {
-                    ss << "\t- Hash: " << state.first << "\n";
-                    ss << "\t  Name: " << state.second << "\n";
+                for (const auto& state : frozenGameStates.getEntries()) {
+                    ss << "\t- Hash: " << state.key << "\n";
+                    ss << "\t  Name: " << stringArena.get(state.value.name) << "\n";
                 }
                 ss << "Assets: " << "\n";
-                for (auto asset : registeredAssets) {
-                    ss << "\t- Hash: " << asset.first << "\n";
-                    ss << "\t  Name: " << asset.second.name << "\n";
-                    ss << "\t  Type: " << asset.second.type << "\n";
-                    ss << "\t  Path: " << asset.second.path.string() << "\n";
+                for (const auto& asset : frozenAssets.getEntries()) {
+                    ss << "\t- Hash: " << asset.key << "\n";
+                    ss << "\t  Name: " << stringArena.get(asset.value.name) << "\n";
+                    ss << "\t  Type: " << asset.value.type << "\n";
+                    ss << "\t  Path: " << stringArena.get(asset.value.path) << "\n";
+                }
+                ss << "Components: " << "\n";
+                for (const auto& component : frozenComponents.getEntries()) {
+                    ss << "\t- Hash: " << component.key << "\n";
+                    ss << "\t  Name: " << stringArena.get(component.value.name) << "\n";
+                    ss << "\t  Id: " << component.value.id << "\n";
                 }
 
                 return ss.str();
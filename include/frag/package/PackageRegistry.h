@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <filesystem>
+
+#include <frag/package/IPackage.h>
+#include <frag/package/FragHash.h>
+#include <frag/package/FrozenTable.h>
+#include <frag/job/JobSystem.h>
+
+namespace frag {
+
+    /*
+        PackageRegistry - the set of all packages of the game (owned by the Core)
+
+        Packages are added with the names of the packages they depend on. loadPackages then sets them up:
+        every package only after all of its dependencies, but everything that doesn't depend on each other
+        at the same time on the JobSystem. So startup scales with the core count instead of the package count.
+        Packages with missing or cyclic dependencies are skipped (and logged), the rest still loads.
+
+        Afterwards the frozen tables of all packages are merged into one global index, so a namespaced key
+        (IPackage::getKey / fragHashCombine(packageHash, nameHash)) can be looked up without knowing the package.
+    */
+    class PackageRegistry {
+        public:
+            PackageRegistry() = default;
+            PackageRegistry(const PackageRegistry&) = delete;
+            PackageRegistry& operator=(const PackageRegistry&) = delete;
+
+            // name has to be the name the package gives to rPackageName, dependencies are names of other packages.
+            // Has to be called before loadPackages.
+            void addPackage(std::string_view name, std::unique_ptr<IPackage> package, std::vector<std::string> dependencies = {});
+
+            // If set, packages are loaded from / saved to snapshots in this directory (IPackage::setupWithSnapshot)
+            void setSnapshotDirectory(std::filesystem::path directory);
+
+            // Sets up all packages and builds the global index. Returns false if at least one package could not be loaded.
+            bool loadPackages(JobSystem& jobSystem);
+            bool isLoaded() const {
+                return loaded;
+            }
+
+            // nullptr if there is no loaded package with that hash ("Name"_fh)
+            IPackage* getPackage(FragHash packageHash) const;
+            size_t getPackageCount() const {
+                return packages.size();
+            }
+
+            // Global index, only filled after loadPackages. Keys are namespaced keys (IPackage::getKey).
+            // The package the key belongs to, nullptr if there is none
+            IPackage* getGameStateOwner(FragHash key) const;
+            IPackage* getAssetOwner(FragHash key) const;
+            // -1 / empty / INVALID_COMPONENT_ID if there is no such key
+            int getAssetType(FragHash key) const;
+            std::string_view getAssetPath(FragHash key) const;
+            ComponentId getComponentId(FragHash key) const;
+
+        private:
+            struct PackageSlot {
+                std::string name;
+                FragHash hash = 0;
+                std::unique_ptr<IPackage> package;
+                std::vector<std::string> dependencyNames;
+
+                std::vector<size_t> dependents;       // Packages that wait for this one
+                std::atomic<int> remainingDependencies = 0;
+                std::atomic<bool> failed = false;
+                bool loaded = false;
+            };
+
+            // Where an entry of the global index lives
+            struct IndexEntry {
+                uint32_t packageIndex;
+                uint32_t entryIndex; // Index in the frozen table of the package
+            };
+
+            std::vector<std::unique_ptr<PackageSlot>> packages;
+            std::filesystem::path snapshotDirectory;
+            bool loaded = false;
+
+            FrozenTable<IndexEntry> gameStateIndex;
+            FrozenTable<IndexEntry> assetIndex;
+            FrozenTable<IndexEntry> componentIndex;
+
+            bool resolveDependencies();
+            void startPackage(size_t index, JobSystem& jobSystem, JobCounter& counter);
+            void setupPackage(size_t index, JobSystem& jobSystem, JobCounter& counter);
+            void startDependents(size_t index, JobSystem& jobSystem, JobCounter& counter);
+            void buildIndex();
+    };
+
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+#include <string>
+#include <vector>
+#include <filesystem>
+
+/*
+    Profiler - Frame profiler of the Fragmental Engine
+    Only exists if the engine is built with FRAG_ENABLE_PROFILER (defines FRAG_PROFILING=1).
+    Without it every FRAG_PROFILE_* macro is empty and the profiling_* functions do nothing.
+
+    - FRAG_PROFILE_ZONE("name") measures the rest of the current scope. The name has to be a string literal (or live forever).
+    - FRAG_PROFILE_FRAME() marks the end of a frame, Core does that for you.
+    - Every thread writes its zones into an own lock-free buffer, they are collected at the end of each frame.
+    - Per zone the time per frame is tracked over the last frames (min / avg / p99 / max).
+    - profiling_startCapture / profiling_exportChromeTrace write every zone into a Chrome trace JSON
+      (open it in chrome://tracing or ui.perfetto.dev).
+*/
+
+#ifndef FRAG_PROFILING
+    #define FRAG_PROFILING 0
+#endif
+
+namespace frag {
+
+    struct ProfileZoneSummary {
+        std::string name;
+        double minMs = 0.0;         // Time per frame, over the tracked frames
+        double avgMs = 0.0;
+        double p99Ms = 0.0;
+        double maxMs = 0.0;
+        double avgCallsPerFrame = 0.0;
+    };
+
+#if FRAG_PROFILING
+
+    int64_t profiling_now();
+    void profiling_recordZone(const char* name, int64_t start, int64_t end);
+
+    class ProfileZone {
+        public:
+            explicit ProfileZone(const char* name) : name(name), start(profiling_now()) {}
+            ~ProfileZone() {
+                profiling_recordZone(name, start, profiling_now());
+            }
+
+            ProfileZone(const ProfileZone&) = delete;
+            ProfileZone& operator=(const ProfileZone&) = delete;
+
+        private:
+            const char* name;
+            int64_t start;
+    };
+
+    void profiling_endFrame();
+    void profiling_setThreadName(const char* name);
+
+    void profiling_startCapture();
+    void profiling_stopCapture();
+    bool profiling_exportChromeTrace(const std::filesystem::path& path);
+
+    std::vector<ProfileZoneSummary> profiling_getZoneSummaries();
+    // Logs the zone summaries every frames frames, 0 = never
+    void profiling_setSummaryInterval(uint32_t frames);
+
+    #define FRAG_PROFILE_CONCAT_INNER(a, b) a##b
+    #define FRAG_PROFILE_CONCAT(a, b) FRAG_PROFILE_CONCAT_INNER(a, b)
+
+    #define FRAG_PROFILE_ZONE(name) ::frag::ProfileZone FRAG_PROFILE_CONCAT(fragProfileZone, __LINE__)(name)
+    #define FRAG_PROFILE_FRAME() ::frag::profiling_endFrame()
+    #define FRAG_PROFILE_THREAD(name) ::frag::profiling_setThreadName(name)
+
+#else
+
+    inline void profiling_startCapture() {}
+    inline void profiling_stopCapture() {}
+    inline bool profiling_exportChromeTrace(const std::filesystem::path&) { return false; }
+
+    inline std::vector<ProfileZoneSummary> profiling_getZoneSummaries() { return {}; }
+    inline void profiling_setSummaryInterval(uint32_t) {}
+
+    #define FRAG_PROFILE_ZONE(name) ((void)0)
+    #define FRAG_PROFILE_FRAME() ((void)0)
+    #define FRAG_PROFILE_THREAD(name) ((void)0)
+
+#endif
+
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <algorithm>
+#include <span>
+#include <vector>
+
+#include <frag/render/RenderStructs.h>
+#include <frag/memory/MemoryTracker.h>
+
+namespace frag {
+
+    // Where a draw command ends up in the frame: lower layers first, inside a layer lower depth first (back to front).
+    // Commands with the same layer and depth are grouped by material, so they can be drawn as one batch.
+    struct DrawOrder {
+        uint8_t layer = 0;
+        uint32_t depth = 0;     // Only the lower 24 bits are used, larger values are clamped
+        uint16_t material = 0;
+    };
+
+    struct RenderCommand {
+        // layer (8 bit) | depth (24 bit) | material (16 bit) | 16 unused bits, see makeSortKey
+        uint64_t sortKey = 0;
+        RectInstance rect;
+    };
+
+    /*
+        Linear list of the draw commands of one frame, recorded by one thread.
+        Recording only appends to a vector (no virtual call, no lock), the Renderer sorts and draws everything at the end
+        of the frame. The memory is kept when the buffer is cleared, after the first frames recording doesn't allocate.
+        Get one per thread with Renderer::getCommandBuffer.
+    */
+    class CommandBuffer {
+        public:
+            static constexpr uint32_t MAX_DEPTH = (1u << 24) - 1;
+
+            void drawRect(Color color, int x, int y, int w, int h, DrawOrder order = {}) {
+                if (w <= 0 || h <= 0) return;
+                if (commands.size() == commands.capacity()) grow();
+                commands.push_back({ makeSortKey(order), RectInstance{ x, y, w, h, color } });
+            }
+
+            void clear() {
+                commands.clear();
+            }
+            size_t size() const {
+                return commands.size();
+            }
+            bool isEmpty() const {
+                return commands.empty();
+            }
+            std::span<const RenderCommand> getCommands() const {
+                return commands;
+            }
+
+            static uint64_t makeSortKey(DrawOrder order) {
+                return (uint64_t)order.layer << 56 | (uint64_t)std::min(order.depth, MAX_DEPTH) << 32 | (uint64_t)order.material << 16;
+            }
+            static uint16_t getMaterial(uint64_t sortKey) {
+                return (uint16_t)(sortKey >> 16);
+            }
+
+        private:
+            std::vector<RenderCommand> commands;
+
+            // Recording happens on game threads, the memory still belongs to the renderer
+            void grow() {
+                MemoryTagScope memoryTag(MemoryTag::RENDER);
+                commands.reserve(std::max<size_t>(commands.capacity() * 2, 256));
+            }
+    };
+
+}
@@ -1,20 +1,43 @@
 #pragma once
 
 #include <expected>
+#include <span>
 #include <string>
 
-#include <RenderStructs.h>
+#include <frag/render/RenderStructs.h>
 
 namespace frag {
 
+    /*
+        Backend that actually puts pixels somewhere (CPU framebuffer, OpenGL, ...).
+        All calls come from the thread that renders (the Core thread), a module doesn't need to be thread-safe.
+        Everything is drawn into the back buffer, swapBuffers() makes it the visible frame.
+    */
     class IRenderModule {
         public:
             virtual ~IRenderModule() = default;
-            virtual std::expected<void, std::string> init();
+            virtual std::expected<void, std::string> init(const RenderSettings& settings) = 0;
             
-            virtual void swapBuffers();
-            virtual void fillColor(const Color);
-            virtual void fillRect(Color color, int x, int y, int w, int h);
+            // Returns false if the frame is the same as the visible one, nothing was presented then
+            virtual bool swapBuffers() = 0;
+            virtual void fillColor(const Color color) = 0;
+            // Parts outside of the framebuffer are clipped away. Translucent colors are blended over what is there (source-over).
+            virtual void fillRect(Color color, int x, int y, int w, int h) = 0;
+            // A whole batch in one call, in order. Modules should override it, this one is just one virtual call per rect.
+            virtual void fillRects(std::span<const RectInstance> rects) {
+                for (const RectInstance& rect : rects) fillRect(rect.color, rect.x, rect.y, rect.w, rect.h);
+            }
+            // Horizontal gradient from the left to the right color, replaces the pixels instead of blending.
+            // Modules should override it, this one draws every column as its own rect.
+            virtual void fillGradientRect(Color left, Color right, int x, int y, int w, int h) {
+                for (int i = 0; i < w; i++) {
+                    uint32_t weight = w > 1 ? (uint32_t)((long long)i * 256 / (w - 1)) : 0;
+                    auto mix = [weight](uint8_t from, uint8_t to) {
+                        return (uint8_t)((from * (256 - weight) + to * weight + 128) >> 8);
+                    };
+                    fillRect(Color{ mix(left.r, right.r), mix(left.g, right.g), mix(left.b, right.b), mix(left.a, right.a) }, x + i, y, 1, h);
+                }
+            }
     };
 
-}
\ No newline at end of file
+}
@@ -1,13 +1,108 @@
 #pragma once
 
+#include <cstdint>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+
 namespace frag {
 
+    class JobSystem;
+
+    // Layout of a 32 bit pixel. The name is the byte order in memory (like the GPU formats), so on a little endian
+    // machine a BGRA8 pixel read as uint32_t is 0xAARRGGBB. Alpha is always the last byte.
+    enum class PixelFormat : uint8_t {
+        RGBA8,
+        BGRA8,
+        RGBA8_PREMULTIPLIED,    // Color channels already multiplied by alpha, what blending works with
+        BGRA8_PREMULTIPLIED
+    };
+
+    constexpr bool isPremultiplied(PixelFormat format) {
+        return format == PixelFormat::RGBA8_PREMULTIPLIED || format == PixelFormat::BGRA8_PREMULTIPLIED;
+    }
+    constexpr bool isBlueFirst(PixelFormat format) {
+        return format == PixelFormat::BGRA8 || format == PixelFormat::BGRA8_PREMULTIPLIED;
+    }
+
+    // x * y / 255, rounded to nearest. Exact for all 8 bit values, the SIMD kernels compute the same.
+    constexpr uint8_t multiplyColorChannel(uint8_t x, uint8_t y) {
+        uint32_t product = (uint32_t)x * y + 128;
+        return (uint8_t)((product + (product >> 8)) >> 8);
+    }
+
+    /*
+        8 bit per channel color with straight (not premultiplied) alpha, 4 bytes in RGBA order.
+        Default alpha is 255 (opaque), Color{ 255, 0, 0 } is red.
+        pack() turns it into a pixel of any PixelFormat, unpack() back.
+    */
     struct Color {
-        // Values from 0 -255
-        char r = 0;
-        char g = 0;
-        char b = 0;
-        char a = 0;
+        uint8_t r = 0;
+        uint8_t g = 0;
+        uint8_t b = 0;
+        uint8_t a = 255;
+
+        // 0xRRGGBBAA, e.g. Color::fromHex(0xFF8000FF) is opaque orange
+        static constexpr Color fromHex(uint32_t rgba) {
+            return Color{ (uint8_t)(rgba >> 24), (uint8_t)(rgba >> 16), (uint8_t)(rgba >> 8), (uint8_t)rgba };
+        }
+
+        constexpr bool isOpaque() const {
+            return a == 255;
+        }
+
+        constexpr Color premultiplied() const {
+            return Color{ multiplyColorChannel(r, a), multiplyColorChannel(g, a), multiplyColorChannel(b, a), a };
+        }
+        // Undoes premultiplied(), as far as the precision allows. Fully transparent colors become transparent black.
+        constexpr Color unpremultiplied() const {
+            if (a == 0) return Color{ 0, 0, 0, 0 };
+            auto divide = [this](uint8_t channel) {
+                return (uint8_t)std::min<uint32_t>(255, ((uint32_t)channel * 255 + a / 2) / a);
+            };
+            return Color{ divide(r), divide(g), divide(b), a };
+        }
+
+        constexpr uint32_t pack(PixelFormat format) const {
+            Color color = isPremultiplied(format) ? premultiplied() : *this;
+            std::array<uint8_t, 4> bytes = isBlueFirst(format)
+                ? std::array<uint8_t, 4>{ color.b, color.g, color.r, color.a }
+                : std::array<uint8_t, 4>{ color.r, color.g, color.b, color.a };
+            return std::bit_cast<uint32_t>(bytes);
+        }
+        static constexpr Color unpack(uint32_t pixel, PixelFormat format) {
+            std::array<uint8_t, 4> bytes = std::bit_cast<std::array<uint8_t, 4>>(pixel);
+            Color color = isBlueFirst(format) ? Color{ bytes[2], bytes[1], bytes[0], bytes[3] } : Color{ bytes[0], bytes[1], bytes[2], bytes[3] };
+            return isPremultiplied(format) ? color.unpremultiplied() : color;
+        }
+
+        constexpr bool operator==(const Color&) const = default;
+    };
+    static_assert(sizeof(Color) == 4, "Color has to be exactly one 32 bit pixel");
+
+    struct Rect {
+        int x = 0;
+        int y = 0;
+        int w = 0;
+        int h = 0;
+    };
+
+    // One filled rectangle, what fillRects gets a whole batch of
+    struct RectInstance {
+        int x = 0;
+        int y = 0;
+        int w = 0;
+        int h = 0;
+        Color color;
+    };
+
+    // What a render module gets set up with, Core::initAndStart fills it in
+    struct RenderSettings {
+        int width = 0;          // Framebuffer size in pixels
+        int height = 0;
+        int pixelPerUnit = 0;   // Pixels per world unit
+        JobSystem* jobSystem = nullptr;  // Modules may render in parallel with it, nullptr = only on the calling thread
     };
 
-}
\ No newline at end of file
+}
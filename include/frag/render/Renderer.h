@@ -1,12 +1,87 @@
 #pragma once
 
-#include <IRenderModule.h>
+#include <cstddef>
+#include <cstdint>
+
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <frag/render/IRenderModule.h>
+#include <frag/render/CommandBuffer.h>
 
 namespace frag {
 
+    struct RenderStats {
+        size_t commandCount = 0;        // Draw commands of the last submitted frame
+        size_t batchCount = 0;          // fillRects calls they were merged into
+        size_t commandBufferCount = 0;  // Threads that have recorded so far
+    };
+
+    /*
+        Collects the draw commands of a frame and hands them to the render module at the end of it.
+        Every thread records into its own CommandBuffer, so game code and jobs can draw in parallel without locks.
+        submit() (called by the Core after the render callback) merges all buffers, radix sorts them by their
+        DrawOrder and draws runs of the same material with one fillRects call each, instead of one virtual call per rect.
+
+        Commands of the same DrawOrder keep the order they were recorded in (per thread, threads in the order they first recorded).
+        Recording has to be finished before submit() is called, e.g. wait for the jobs that draw inside the render callback.
+    */
     class Renderer {
         public:
-            void setRenderModule(const IRenderModule* module);
+            Renderer();
+            ~Renderer();
+
+            Renderer(const Renderer&) = delete;
+            Renderer& operator=(const Renderer&) = delete;
+
+            void setRenderModule(IRenderModule* module);
+            IRenderModule* getRenderModule() const { return module; }
+
+            // The buffer of the calling thread, created on its first call
+            CommandBuffer& getCommandBuffer();
+            void drawRect(Color color, int x, int y, int w, int h, DrawOrder order = {}) {
+                getCommandBuffer().drawRect(color, x, y, w, h, order);
+            }
+            // Fills the whole frame before any command is drawn, only call it from the rendering thread
+            void clear(Color color);
+
+            // Draws everything that was recorded and empties the buffers. Without a module the commands are just dropped.
+            void submit();
+
+            const RenderStats& getLastFrameStats() const { return stats; }
+
+        private:
+            struct SortItem {
+                uint64_t key;
+                uint32_t bufferIndex;
+                uint32_t commandIndex;
+            };
+
+            struct ThreadCommandBuffer {
+                std::thread::id thread;
+                std::unique_ptr<CommandBuffer> buffer;
+            };
+
+            uint64_t id;    // Unique over all renderers, for the thread local buffer lookup
+            IRenderModule* module = nullptr;
+
+            std::mutex bufferMutex;
+            std::vector<ThreadCommandBuffer> commandBuffers;
+
+            bool clearRequested = false;
+            Color clearColor;
+
+            // Kept between frames, so a steady frame doesn't allocate
+            std::vector<SortItem> sortItems;
+            std::vector<SortItem> sortScratch;
+            std::vector<RectInstance> sortedRects;
+
+            RenderStats stats;
+
+            CommandBuffer& findCommandBuffer();
+            static void radixSort(std::vector<SortItem>& items, std::vector<SortItem>& scratch);
     };
 
-}
\ No newline at end of file
+}
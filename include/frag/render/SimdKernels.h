@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <frag/render/RenderStructs.h>
+
+/*
+    Pixel kernels of the software renderer, every kernel exists as scalar, SSE2 and AVX2 version.
+    The best version the CPU supports is picked at runtime (the engine doesn't have to be compiled with -mavx2),
+    all versions produce exactly the same pixels, so the result doesn't depend on the machine.
+    The scalar versions are the reference, setSimdLevel(SimdLevel::SCALAR) to compare against them.
+    Building without FRAG_ENABLE_SIMD (FRAG_SIMD=0) or for a non x86 CPU leaves only the scalar versions.
+
+    Blending works on premultiplied pixels. The kernels only look at the byte order in memory with alpha last,
+    so they work for RGBA8 and BGRA8 alike.
+*/
+
+#ifndef FRAG_SIMD
+    #define FRAG_SIMD 1
+#endif
+
+namespace frag {
+
+    enum class SimdLevel : uint8_t {
+        SCALAR,
+        SSE2,
+        AVX2
+    };
+
+    // Best level of this CPU (and build)
+    SimdLevel getSupportedSimdLevel();
+    // Level that is used right now
+    SimdLevel getSimdLevel();
+    // Forces a lower level, e.g. SCALAR to compare against. Clamped to the supported level.
+    // Not thread-safe, only call it while nothing renders.
+    void setSimdLevel(SimdLevel level);
+    const char* getSimdLevelName(SimdLevel level);
+
+    // Sets count pixels starting at destination to value
+    void fillSpan(uint32_t* destination, size_t count, uint32_t value);
+
+    // Source-over: destination = color + destination * (255 - alpha of color) / 255, per channel
+    void blendSpan(uint32_t* destination, size_t count, uint32_t premultipliedColor);
+    // Same with a different (premultiplied) source pixel for every destination pixel
+    void blendPixels(uint32_t* destination, const uint32_t* source, size_t count);
+
+    // Pixel i becomes (from * (256 - w) + to * w + 128) / 256 per channel, with w = (position + i * step) >> 16.
+    // So position and step are 16.16 fixed point weights from 0 to 256, the last pixel must not go above 256.
+    // Interpolate premultiplied colors, otherwise translucent ends bleed their color into the rest.
+    void gradientSpan(uint32_t* destination, size_t count, uint32_t from, uint32_t to, uint32_t position, uint32_t step);
+
+    // Converts count pixels, destination may be the same as source.
+    // Unpremultiplying has no SIMD version, it is only needed for reading pixels back.
+    void convertPixels(uint32_t* destination, const uint32_t* source, size_t count, PixelFormat from, PixelFormat to);
+    // Swaps the first and third byte (RGBA8 <-> BGRA8)
+    void swapRedBlue(uint32_t* destination, const uint32_t* source, size_t count);
+    void premultiplyPixels(uint32_t* destination, const uint32_t* source, size_t count);
+    void unpremultiplyPixels(uint32_t* destination, const uint32_t* source, size_t count);
+
+}
@@ -1,6 +1,6 @@
 #pragma once
 
-#include <IRenderModule.h>
+#include <frag/render/IRenderModule.h>
 
 namespace frag {
 
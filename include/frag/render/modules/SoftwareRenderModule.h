@@ -0,0 +1,140 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <memory>
+#include <vector>
+
+#include <frag/package/FragHash.h>
+#include <frag/render/IRenderModule.h>
+
+namespace frag {
+
+    /*
+        Render module that draws on the CPU into a 32 bit framebuffer, works without any GPU or display
+        (headless runs, tests, servers).
+        Pixels are premultiplied BGRA8 (0xAARRGGBB when read as uint32_t on little endian machines).
+        Translucent fills are blended over the pixels (source-over), fillColor and gradients replace them.
+        The spans are drawn with the SIMD kernels (see SimdKernels.h), the result is the same on every machine,
+        so frames can be compared bit by bit in tests.
+
+        Every row starts 64 byte aligned, getPitch() is the row length in pixels including the padding.
+        After swapBuffers the back buffer contains an older frame, clear it if the whole frame isn't drawn again.
+
+        Fills are not drawn right away, they are sorted into 64x64 pixel tiles first. flush() (swapBuffers does it)
+        then draws all tiles in parallel on the JobSystem of the RenderSettings. Every tile is drawn by one thread
+        in the order the fills came in, so no locks are needed and the result is the same for any thread count.
+        A tile stays in the cache while all its fills are drawn, and fills that cover a whole tile throw away
+        everything that was queued for it before.
+
+        Every tile keeps a hash of what it shows in each of the two buffers. Tiles whose fills end up with the
+        same content as before are not drawn again (or just copied over from the other buffer), and if the whole
+        frame is the same as the visible one, swapBuffers doesn't swap at all and returns false.
+        getDamageRects() are the regions that changed with the last swap, a presenter only has to update those.
+        A frame without any fills counts as unchanged.
+    */
+    class SoftwareRenderModule : public IRenderModule {
+        public:
+            static constexpr size_t ROW_ALIGNMENT = 64;  // In bytes
+            static constexpr int TILE_SIZE = 64;         // In pixels
+            static constexpr PixelFormat PIXEL_FORMAT = PixelFormat::BGRA8_PREMULTIPLIED;
+
+            std::expected<void, std::string> init(const RenderSettings& settings) override;
+
+            bool swapBuffers() override;
+            void fillColor(const Color color) override;
+            void fillRect(Color color, int x, int y, int w, int h) override;
+            void fillRects(std::span<const RectInstance> rects) override;
+            void fillGradientRect(Color left, Color right, int x, int y, int w, int h) override;
+            // Draws everything that is queued into the back buffer
+            void flush();
+
+            int getWidth() const { return settings.width; }
+            int getHeight() const { return settings.height; }
+            int getPitch() const { return pitch; }
+            const RenderSettings& getSettings() const { return settings; }
+            unsigned long long getPresentedFrameCount() const { return presentedFrames; }
+            // Merged from the changed tiles, empty if the last swapBuffers didn't present anything
+            std::span<const Rect> getDamageRects() const { return damageRects; }
+
+            // The last finished frame (the one swapBuffers made visible)
+            const uint32_t* getFrontBuffer() const { return frontBuffer.get(); }
+            // The frame that is drawn right now, flushes first. Pixels written here directly are not noticed by the change tracking.
+            uint32_t* getBackBuffer();
+            uint32_t getPixel(int x, int y) const { return frontBuffer[(size_t)y * pitch + x]; }
+            Color getColor(int x, int y) const { return Color::unpack(getPixel(x, y), PIXEL_FORMAT); }
+
+            static uint32_t packColor(Color color) {
+                return color.pack(PIXEL_FORMAT);
+            }
+
+        private:
+            struct AlignedDeleter {
+                void operator()(uint32_t* pixels) const;
+            };
+            using PixelBuffer = std::unique_ptr<uint32_t[], AlignedDeleter>;
+
+            enum class OpType : uint8_t {
+                FILL,       // Opaque, just overwrites
+                BLEND,
+                GRADIENT
+            };
+
+            // A fill, already clipped to the framebuffer
+            struct TileOp {
+                int left;
+                int top;
+                int right;
+                int bottom;
+                OpType type;
+                uint32_t value;             // Premultiplied pixel, the left color of a gradient
+                uint32_t endValue = 0;      // Right color of a gradient
+                int gradientLeft = 0;       // Where the unclipped gradient starts
+                uint32_t gradientStep = 0;  // Weight step per pixel, see gradientSpan
+            };
+
+            struct Tile {
+                std::vector<uint32_t> ops;  // Indices into tileOps, in drawing order
+                bool cleared = false;       // Gets filled with clearValue before the ops
+                uint32_t clearValue = 0;
+                FragHash content = 0;       // Hash of what the tile shows once everything queued is drawn
+                FragHash bufferContent[2] = {}; // Hash of what the tile shows in each buffer right now
+            };
+
+            // Tile columns [first, end) in a row of changed tiles, part of damageRects[rect]
+            struct DamageRun {
+                int first;
+                int end;
+                size_t rect;
+            };
+
+            RenderSettings settings;
+            int pitch = 0;
+            PixelBuffer frontBuffer;
+            PixelBuffer backBuffer;
+            int backIndex = 0;              // Which bufferContent of the tiles belongs to the back buffer
+            unsigned long long presentedFrames = 0;
+
+            int tileColumns = 0;
+            int tileRows = 0;
+            std::vector<Tile> tiles;
+            std::vector<TileOp> tileOps;    // Kept between frames, so a steady frame doesn't allocate
+            bool hasQueuedWork = false;
+            bool hasFrameWork = false;      // Something was filled since the last swap
+
+            std::vector<Rect> damageRects;
+            std::vector<DamageRun> damageRuns;
+            std::vector<DamageRun> previousDamageRuns;
+
+            // Clips the rect to the framebuffer, false if nothing is left of it
+            bool clipRect(int x, int y, int w, int h, TileOp& op) const;
+            static FragHash hashOpBounds(const TileOp& op, uint32_t value);
+            void queueRect(Color color, int x, int y, int w, int h);
+            void queueOp(const TileOp& op, FragHash opHash);
+            void drawTile(Tile& tile, int column, int row);
+            void collectDamageRects();
+            static PixelBuffer allocatePixels(size_t count);
+    };
+
+}
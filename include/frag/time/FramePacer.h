@@ -0,0 +1,46 @@
+#pragma once
+
+#include <chrono>
+
+namespace frag {
+
+    /*
+        Waits until the next frame is due.
+        Plain sleep_for is way too coarse for frame pacing (it easily oversleeps by 1ms or more), and spinning
+        the whole time burns a core. So the FramePacer sleeps in small steps while there is enough time left,
+        and only spins for the last bit. How long "enough" is, gets learned from how much the OS actually
+        oversleeps on this machine.
+
+        Frame deadlines are advanced by exactly one frame time, so small errors don't add up over time.
+        If a frame is late by more than one whole frame, the pacer resyncs instead of rushing to catch up.
+    */
+    class FramePacer {
+        public:
+            using Clock = std::chrono::steady_clock;
+
+            // targetFPS <= 0 means unlimited, waitForNextFrame returns immediately then
+            void setTargetFPS(int targetFPS);
+            void reset();
+
+            void waitForNextFrame();
+
+            // Estimated time the OS oversleeps on a short sleep, only for debugging/stats
+            double getSleepOvershootEstimate() const {
+                return sleepOvershootMean + sleepOvershootDeviation;
+            }
+
+        private:
+            Clock::duration frameTime = Clock::duration::zero();
+            Clock::time_point nextFrame = Clock::time_point::min();
+
+            // Running estimate of the oversleep in seconds (Welford), starts pessimistic
+            double sleepOvershootMean = 0.002;
+            double sleepOvershootDeviation = 0.0;
+            double sleepOvershootM2 = 0.0;
+            long long sleepSamples = 0;
+
+            void preciseWaitUntil(Clock::time_point deadline);
+            void addSleepSample(double overshoot);
+    };
+
+}
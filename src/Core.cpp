@@ -3,6 +3,12 @@
 #include <iostream>
 
 #include <frag/Log.h>
+#include <frag/time/FramePacer.h>
+#include <frag/profile/Profiler.h>
+#include <frag/render/modules/SoftwareRenderModule.h>
+
+#include <chrono>
+#include <algorithm>
 
 #include <GLFW/glfw3.h>
 
@@ -12,28 +18,66 @@ namespace frag {
     // -- Public Methods Implementation --
     // ------------------------------------
 
-    static bool instanceIsRunning = false; 
+    static std::atomic<bool> instanceIsRunning = false;
     void Core::initAndStart(std::string gameName, int pixelPerUnit, int ratioX, int ratioY, int windowWith) {
-        logInfo("Starting Core instance for game '{}'", gameName);
+        logInfo(LogChannel::CORE, "Starting Core instance for game '{}'", gameName);
 
-        if (instanceIsRunning) {
-            logError("Core instance is already running, cannot start another instance.");
+        // Checked and set in one step, two threads starting a Core at once can't both get through
+        if (instanceIsRunning.exchange(true, std::memory_order_acq_rel)) {
+            logError(LogChannel::CORE, "Core instance is already running, cannot start another instance.");
             return;
         }
 
         this->gameName = gameName;
+        stopRequested.store(false, std::memory_order_relaxed);
+
+        getJobSystem();
+        if (!packageRegistry.isLoaded()) loadPackages();
+
+        if (!initRenderModule(pixelPerUnit, ratioX, ratioY, windowWith)) {
+            instanceIsRunning.store(false, std::memory_order_release);
+            return;
+        }
+
+        if (headless) {
+            logInfo(LogChannel::CORE, "Running headless, no window will be created.");
+        }
+        else if (initGLFWWindow() != 0) {
+            instanceIsRunning.store(false, std::memory_order_release);
+            return;
+        }
 
-        initGLFWWindow();
         enterGameLoop();
 
-        instanceIsRunning = true;
+        instanceIsRunning.store(false, std::memory_order_release);
+    }
+
+    void Core::stepFrames(unsigned long long count, double frameTime) {
+        if (frameTime <= 0.0 && targetFPS > 0) frameTime = 1.0 / targetFPS;
+        bool measureFrameTime = frameTime <= 0.0;
+
+        auto lastFrameStart = std::chrono::steady_clock::now();
+        for (unsigned long long i = 0; i < count && !stopRequested.load(std::memory_order_acquire); i++) {
+            if (measureFrameTime) {
+                auto frameStart = std::chrono::steady_clock::now();
+                runFrame(std::chrono::duration<double>(frameStart - lastFrameStart).count());
+                lastFrameStart = frameStart;
+            }
+            else {
+                runFrame(frameTime);
+            }
+        }
+    }
+
+    void Core::requestStop() {
+        stopRequested.store(true, std::memory_order_release);
     }
 
     void Core::setFrameMode(FrameMode mode, int targetFPS) {
-        logDebug("Setting frame mode...");
+        FRAG_LOG_DEBUG(LogChannel::CORE, "Setting frame mode...");
 
         if (mode == FrameMode::FIXED && targetFPS <= 0) {
-            logError("Cannot set FIXED frame mode with non-positive targetFPS ({}).", targetFPS);
+            logError(LogChannel::CORE, "Cannot set FIXED frame mode with non-positive targetFPS ({}).", targetFPS);
             return;
         }
 
@@ -41,6 +85,103 @@ namespace frag {
         this->targetFPS = targetFPS;
     }
 
+    void Core::setUpdateCallback(std::function<void(double deltaTime)> callback) {
+        this->updateCallback = std::move(callback);
+    }
+
+    void Core::setRenderCallback(std::function<void(double alpha)> callback) {
+        this->renderCallback = std::move(callback);
+    }
+
+    void Core::setHeadless(bool headless) {
+        if (instanceIsRunning.load(std::memory_order_acquire)) {
+            logError(LogChannel::CORE, "Cannot change headless mode while the Core instance is running.");
+            return;
+        }
+
+        this->headless = headless;
+    }
+
+    void Core::setFrameLimit(unsigned long long maxFrames) {
+        this->frameLimit = maxFrames;
+    }
+
+    void Core::setWallTimeLimit(double seconds) {
+        this->wallTimeLimit = seconds;
+    }
+
+    void Core::setRenderModule(std::unique_ptr<IRenderModule> module) {
+        if (instanceIsRunning.load(std::memory_order_acquire)) {
+            logError(LogChannel::CORE, "Cannot change the render module while the Core instance is running.");
+            return;
+        }
+
+        renderer.setRenderModule(nullptr);
+        this->renderModule = std::move(module);
+    }
+
+    bool Core::initRenderModule(int pixelPerUnit, int ratioX, int ratioY, int windowWith) {
+        MemoryTagScope memoryTag(MemoryTag::RENDER);
+
+        if (ratioX <= 0 || ratioY <= 0 || windowWith <= 0) {
+            logFatal(LogChannel::CORE, "Invalid window size: ratio {}:{}, width {}.", ratioX, ratioY, windowWith);
+            return false;
+        }
+
+        renderSettings.width = windowWith;
+        renderSettings.height = (int)((long long)windowWith * ratioY / ratioX);
+        renderSettings.pixelPerUnit = pixelPerUnit;
+        renderSettings.jobSystem = &getJobSystem();
+
+        if (!renderModule) renderModule = std::make_unique<SoftwareRenderModule>();
+
+        auto result = renderModule->init(renderSettings);
+        if (!result) {
+            logFatal(LogChannel::CORE, "Failed to initialize the render module: {}", result.error());
+            return false;
+        }
+        renderer.setRenderModule(renderModule.get());
+        return true;
+    }
+
+    void Core::setJobThreadCount(int threadCount) {
+        if (jobSystem) {
+            logError(LogChannel::CORE, "JobSystem is already running, cannot change the amount of job threads.");
+            return;
+        }
+
+        this->jobThreadCount = threadCount;
+    }
+
+    JobSystem& Core::getJobSystem() {
+        if (!jobSystem) {
+            MemoryTagScope memoryTag(MemoryTag::CORE);
+            jobSystem = std::make_unique<JobSystem>(jobThreadCount < 0 ? -1 : std::max(jobThreadCount - 1, 0));
+        }
+        return *jobSystem;
+    }
+
+    bool Core::loadPackages() {
+        return packageRegistry.loadPackages(getJobSystem());
+    }
+
+    AssetManager& Core::getAssetManager() {
+        if (!assetManager) {
+            MemoryTagScope memoryTag(MemoryTag::ASSET);
+            assetManager = std::make_unique<AssetManager>(packageRegistry);
+        }
+        return *assetManager;
+    }
+
+    void Core::setMaxFrameTime(double seconds) {
+        if (seconds <= 0.0) {
+            logError(LogChannel::CORE, "Max frame time has to be positive ({}).", seconds);
+            return;
+        }
+
+        this->maxFrameTime = seconds;
+    }
+
 
 
     // -------------------------------------
@@ -49,20 +190,20 @@ namespace frag {
 
     static GLFWwindow* window;
     int Core::initGLFWWindow() {
-        logDebug("Initializing GLFW window...");
+        FRAG_LOG_DEBUG(LogChannel::CORE, "Initializing GLFW window...");
 
          /* Initialize the library */
         if (!glfwInit()) {
-            logFatal("Failed to initialize GLFW.");
+            logFatal(LogChannel::CORE, "Failed to initialize GLFW.");
             return -1;
         }
 
          /* Create a windowed mode window and its OpenGL context */
-        window = glfwCreateWindow(640, 480, gameName.c_str(), NULL, NULL);
+        window = glfwCreateWindow(renderSettings.width, renderSettings.height, gameName.c_str(), NULL, NULL);
         if (!window)
         {
             glfwTerminate();
-            logFatal("Failed to create GLFW window.");
+            logFatal(LogChannel::CORE, "Failed to create GLFW window.");
             return -1;
         }
 
@@ -74,28 +215,93 @@ namespace frag {
     }
 
     void Core::enterGameLoop() {
-        logDebug("Entering game loop...");
+        FRAG_LOG_DEBUG(LogChannel::CORE, "Entering game loop...");
 
-        if (!windowIsInitialized) {
-            logFatal("Window is not initialized, cannot enter game loop.");
+        if (!headless && !windowIsInitialized) {
+            logFatal(LogChannel::CORE, "Window is not initialized, cannot enter game loop.");
             return;
         }
 
-        while (!glfwWindowShouldClose(window))
+        FRAG_PROFILE_THREAD("Core");
+
+        FramePacer framePacer;
+        framePacer.setTargetFPS(targetFPS);
+        updateAccumulator = 0.0;
+
+        unsigned long long startFrameCount = frameCount;
+        auto loopStart = std::chrono::steady_clock::now();
+        auto lastFrameStart = loopStart;
+        while (!stopRequested.load(std::memory_order_acquire))
         {
-            /* Render here */
-            //glClear(GL_COLOR_BUFFER_BIT);
+            if (!headless && glfwWindowShouldClose(window)) break;
+            if (frameLimit > 0 && frameCount - startFrameCount >= frameLimit) break;
+
+            auto frameStart = std::chrono::steady_clock::now();
+            if (wallTimeLimit > 0.0 && std::chrono::duration<double>(frameStart - loopStart).count() >= wallTimeLimit) break;
+
+            runFrame(std::chrono::duration<double>(frameStart - lastFrameStart).count());
+            lastFrameStart = frameStart;
+
+            if (!headless) {
+                FRAG_PROFILE_ZONE("Core::swapAndPoll");
+
+                /* Swap front and back buffers, not needed if the frame didn't change */
+                if (framePresented) glfwSwapBuffers(window);
+
+                /* Poll for and process events */
+                glfwPollEvents();
+            }
+
+            {
+                FRAG_PROFILE_ZONE("Core::waitForNextFrame");
+                framePacer.waitForNextFrame();
+            }
+        }
+
+        if (!headless) {
+            glfwTerminate();
+            windowIsInitialized = false;
+        }
+
+        FRAG_LOG_DEBUG(LogChannel::CORE, "Exited game loop.");
+    }
+
+    void Core::runFrame(double frameTime) {
+        if (frameTime > maxFrameTime) frameTime = maxFrameTime;
+        lastFrameTime = frameTime;
+        frameArena.beginFrame();
+
+        if (assetManager) assetManager->update();
 
-            /* Swap front and back buffers */
-            glfwSwapBuffers(window);
+        double alpha = 1.0;
+        if (frameMode == FrameMode::FIXED) {
+            double fixedDeltaTime = 1.0 / targetFPS;
+
+            updateAccumulator += frameTime;
+            while (updateAccumulator >= fixedDeltaTime) {
+                FRAG_PROFILE_ZONE("Core::update");
+                if (updateCallback) updateCallback(fixedDeltaTime);
+                updateAccumulator -= fixedDeltaTime;
+            }
+            alpha = updateAccumulator / fixedDeltaTime;
+        }
+        else {
+            FRAG_PROFILE_ZONE("Core::update");
+            if (updateCallback) updateCallback(frameTime);
+        }
+
+        {
+            FRAG_PROFILE_ZONE("Core::render");
+            if (renderCallback) renderCallback(alpha);
 
-            /* Poll for and process events */
-            glfwPollEvents();
-            
+            MemoryTagScope memoryTag(MemoryTag::RENDER);
+            renderer.submit();
+            framePresented = renderModule && renderModule->swapBuffers();
         }
-        glfwTerminate();
+        frameCount++;
 
-        logDebug("Exited game loop.");
+        memory_endFrame();
+        FRAG_PROFILE_FRAME();
     }
     
 }
@@ -0,0 +1,263 @@
+#include <frag/asset/AssetArchive.h>
+
+#include <cstdio>
+#include <cstring>
+#include <array>
+#include <algorithm>
+#include <string>
+#include <system_error>
+
+#include <frag/Log.h>
+#include <frag/profile/Profiler.h>
+#include <frag/io/BlockCompression.h>
+#include <frag/package/IPackage.h>
+
+namespace frag {
+
+    /*
+        Archive file layout (native byte order, checked with BYTE_ORDER_MARK):
+            ArchiveHeader
+            TOC entries, seeds and slots of the FrozenTable, every section aligned to DATA_ALIGNMENT
+            Asset data, every asset aligned to DATA_ALIGNMENT
+        Only the header and the TOC are covered by the checksum, the asset data is just bounds checked.
+    */
+    namespace {
+        constexpr char ARCHIVE_MAGIC[8] = { 'F', 'R', 'A', 'G', 'A', 'R', 'C', '\0' };
+        constexpr uint32_t ARCHIVE_FORMAT_VERSION = 1;
+        constexpr uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+        enum Section : uint32_t {
+            TOC_ENTRIES, TOC_SEEDS, TOC_SLOTS,
+            SECTION_COUNT
+        };
+
+        struct ArchiveSection {
+            uint64_t offset;
+            uint64_t size; // In bytes
+        };
+
+        struct ArchiveHeader {
+            char magic[8];
+            uint32_t formatVersion;
+            uint32_t byteOrderMark;
+            uint64_t packageHash;
+            uint32_t entrySize;           // sizeof(FrozenTable<AssetArchive::Entry>::Entry), catches layout changes
+            uint32_t reserved;
+            uint64_t fileSize;
+            uint64_t tocChecksum;         // fragHash of all TOC sections
+            ArchiveSection sections[SECTION_COUNT];
+        };
+
+        size_t alignOffset(size_t offset) {
+            return (offset + AssetArchive::DATA_ALIGNMENT - 1) / AssetArchive::DATA_ALIGNMENT * AssetArchive::DATA_ALIGNMENT;
+        }
+
+        std::string_view asText(std::span<const std::byte> bytes) {
+            return std::string_view(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+        }
+
+        template<typename T>
+        std::span<const T> getSection(const MappedFile& file, const ArchiveHeader& header, Section section) {
+            const ArchiveSection& info = header.sections[section];
+            return std::span<const T>(reinterpret_cast<const T*>(file.getData() + info.offset), info.size / sizeof(T));
+        }
+    }
+
+    // ------------------------------------
+    // -- Public Methods Implementation --
+    // ------------------------------------
+
+    bool AssetArchive::pack(const IPackage& package, const std::filesystem::path& assetDirectory, const std::filesystem::path& archivePath,
+        const AssetArchiveOptions& options) {
+        FRAG_PROFILE_ZONE("AssetArchive::pack");
+
+        if (!package.isSetup()) {
+            logError(LogChannel::ASSET, "Package is not setup yet, cannot pack its assets into '{}'.", archivePath.string());
+            return false;
+        }
+
+        // The data goes into one buffer first, the TOC can only be written once all sizes are known
+        std::vector<FrozenTable<Entry>::Entry> entries;
+        std::string data;
+        std::vector<std::byte> compressed;
+        size_t originalBytes = 0;
+        bool allRead = true;
+
+        package.forEachAsset([&](FragHash key, int type, std::string_view assetPath) {
+            std::filesystem::path path = std::filesystem::path(assetPath);
+            if (path.is_relative()) path = assetDirectory / path;
+
+            MappedFile assetFile;
+            if (!assetFile.open(path)) {
+                logError(LogChannel::ASSET, "Cannot read asset file '{}' for the archive.", path.string());
+                allRead = false;
+                return;
+            }
+            std::span<const std::byte> bytes = assetFile.getBytes();
+            std::span<const std::byte> stored = bytes;
+
+            Entry entry = {};
+            entry.size = bytes.size();
+            entry.type = type;
+
+            if (options.compress && !bytes.empty()) {
+                compressBlock(bytes, compressed);
+                if ((double)compressed.size() <= (double)bytes.size() * options.maxCompressionRatio) {
+                    stored = compressed;
+                    entry.flags |= FLAG_COMPRESSED;
+                }
+            }
+
+            data.resize(alignOffset(data.size()), '\0');
+            entry.offset = data.size();  // Relative to the data section for now
+            entry.storedSize = stored.size();
+            data.append(asText(stored));
+
+            originalBytes += bytes.size();
+            entries.push_back({ key, entry });
+        });
+        if (!allRead) return false;
+
+        FrozenTable<Entry> table;
+        table.build(entries); // The keys come out of a FrozenTable, they are unique
+        std::array<std::span<const std::byte>, SECTION_COUNT> sections = {
+            std::as_bytes(table.getEntries()), std::as_bytes(table.getSeeds()), std::as_bytes(table.getSlots())
+        };
+
+        ArchiveHeader header = {};
+        std::memcpy(header.magic, ARCHIVE_MAGIC, sizeof(header.magic));
+        header.formatVersion = ARCHIVE_FORMAT_VERSION;
+        header.byteOrderMark = BYTE_ORDER_MARK;
+        header.packageHash = package.getPackageHash();
+        header.entrySize = sizeof(FrozenTable<Entry>::Entry);
+
+        std::string tocBody;
+        for (size_t i = 0; i < SECTION_COUNT; i++) {
+            size_t offset = alignOffset(sizeof(ArchiveHeader) + tocBody.size());
+            tocBody.resize(offset - sizeof(ArchiveHeader), '\0');
+            header.sections[i].offset = offset;
+            header.sections[i].size = sections[i].size();
+            tocBody.append(asText(sections[i]));
+        }
+        size_t dataOffset = alignOffset(sizeof(ArchiveHeader) + tocBody.size());
+        tocBody.resize(dataOffset - sizeof(ArchiveHeader), '\0');
+
+        // Now that the TOC size is known, the offsets can point to the actual place in the file
+        std::vector<FrozenTable<Entry>::Entry> finalEntries(table.getEntries().begin(), table.getEntries().end());
+        for (auto& entry : finalEntries) entry.value.offset += dataOffset;
+        std::memcpy(tocBody.data() + header.sections[TOC_ENTRIES].offset - sizeof(ArchiveHeader), finalEntries.data(), header.sections[TOC_ENTRIES].size);
+
+        header.fileSize = dataOffset + data.size();
+        header.tocChecksum = fragHash(tocBody);
+
+        // Written to a temporary file first, so a crash never leaves a half written archive behind
+        std::error_code error;
+        if (archivePath.has_parent_path()) std::filesystem::create_directories(archivePath.parent_path(), error);
+
+        std::filesystem::path tempPath = archivePath;
+        tempPath += ".tmp";
+        std::FILE* file = std::fopen(tempPath.string().c_str(), "wb");
+        if (!file) {
+            logError(LogChannel::ASSET, "Cannot write asset archive '{}'.", tempPath.string());
+            return false;
+        }
+
+        bool written = std::fwrite(&header, sizeof(header), 1, file) == 1;
+        written = std::fwrite(tocBody.data(), 1, tocBody.size(), file) == tocBody.size() && written;
+        written = std::fwrite(data.data(), 1, data.size(), file) == data.size() && written;
+        written = std::fclose(file) == 0 && written;
+
+        if (written) std::filesystem::rename(tempPath, archivePath, error);
+        if (!written || error) {
+            logError(LogChannel::ASSET, "Cannot write asset archive '{}'.", archivePath.string());
+            std::filesystem::remove(tempPath, error);
+            return false;
+        }
+
+        logInfo(LogChannel::ASSET, "Packed {} asset(s) of package {:016x} into '{}' ({} -> {} bytes).", finalEntries.size(), package.getPackageHash(),
+            archivePath.string(), originalBytes, header.fileSize);
+        return true;
+    }
+
+    bool AssetArchive::open(const std::filesystem::path& path) {
+        FRAG_PROFILE_ZONE("AssetArchive::open");
+        close();
+
+        MappedFile newFile;
+        if (!newFile.open(path)) {
+            logError(LogChannel::ASSET, "Cannot open asset archive '{}'.", path.string());
+            return false;
+        }
+
+        auto reject = [&](std::string_view reason) {
+            logError(LogChannel::ASSET, "Asset archive '{}' cannot be used: {}.", path.string(), reason);
+            return false;
+        };
+
+        if (newFile.getSize() < sizeof(ArchiveHeader)) return reject("too small");
+        ArchiveHeader header;
+        std::memcpy(&header, newFile.getData(), sizeof(header));
+
+        if (std::memcmp(header.magic, ARCHIVE_MAGIC, sizeof(header.magic)) != 0) return reject("not an asset archive");
+        if (header.byteOrderMark != BYTE_ORDER_MARK) return reject("written on a machine with another byte order");
+        if (header.formatVersion != ARCHIVE_FORMAT_VERSION) return reject("other archive format version");
+        if (header.entrySize != sizeof(FrozenTable<Entry>::Entry)) return reject("written by another engine build");
+        if (header.fileSize != newFile.getSize()) return reject("wrong file size");
+
+        size_t tocEnd = sizeof(ArchiveHeader);
+        for (const ArchiveSection& section : header.sections) {
+            if (section.offset % DATA_ALIGNMENT != 0 || section.offset < sizeof(ArchiveHeader) || section.offset > newFile.getSize()
+                || section.size > newFile.getSize() - section.offset) return reject("broken section table");
+            tocEnd = std::max<size_t>(tocEnd, section.offset + section.size);
+        }
+        if (header.sections[TOC_ENTRIES].size % sizeof(FrozenTable<Entry>::Entry) != 0
+            || header.sections[TOC_SEEDS].size % sizeof(uint32_t) != 0 || header.sections[TOC_SLOTS].size % sizeof(uint32_t) != 0) return reject("broken section table");
+
+        tocEnd = alignOffset(tocEnd);
+        if (tocEnd > newFile.getSize()) return reject("broken section table");
+        std::string_view tocBody(reinterpret_cast<const char*>(newFile.getData()) + sizeof(ArchiveHeader), tocEnd - sizeof(ArchiveHeader));
+        if (fragHash(tocBody) != header.tocChecksum) return reject("checksum mismatch");
+
+        FrozenTable<Entry> newToc;
+        if (!newToc.setView(getSection<FrozenTable<Entry>::Entry>(newFile, header, TOC_ENTRIES),
+            getSection<uint32_t>(newFile, header, TOC_SEEDS), getSection<uint32_t>(newFile, header, TOC_SLOTS))) return reject("broken table of contents");
+
+        for (const auto& entry : newToc.getEntries()) {
+            const Entry& value = entry.value;
+            bool compressed = (value.flags & FLAG_COMPRESSED) != 0;
+            if (value.offset < tocEnd || value.offset > newFile.getSize() || value.storedSize > newFile.getSize() - value.offset
+                || (!compressed && value.storedSize != value.size)) return reject("broken entry");
+        }
+
+        // The views point into the mapping, which stays where it is when the file is moved
+        file = std::move(newFile);
+        toc.setView(newToc.getEntries(), newToc.getSeeds(), newToc.getSlots());
+        packageHash = header.packageHash;
+
+        logDebug(LogChannel::ASSET, "Opened asset archive '{}' with {} asset(s).", path.string(), toc.size());
+        return true;
+    }
+
+    void AssetArchive::close() {
+        toc.clear();
+        file.close();
+        packageHash = 0;
+    }
+
+    std::span<const std::byte> AssetArchive::getView(const Entry& entry) const {
+        if (entry.flags & FLAG_COMPRESSED) return {};
+        return std::span<const std::byte>(file.getData() + entry.offset, entry.storedSize);
+    }
+
+    bool AssetArchive::read(const Entry& entry, std::vector<std::byte>& buffer) const {
+        std::span<const std::byte> stored(file.getData() + entry.offset, entry.storedSize);
+        buffer.resize(entry.size);
+
+        if (!(entry.flags & FLAG_COMPRESSED)) {
+            if (!stored.empty()) std::memcpy(buffer.data(), stored.data(), stored.size());
+            return true;
+        }
+        return decompressBlock(stored, buffer);
+    }
+
+}
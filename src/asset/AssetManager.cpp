@@ -0,0 +1,532 @@
+#include <frag/asset/AssetManager.h>
+
+#include <string>
+#include <utility>
+#include <algorithm>
+#include <fstream>
+
+#include <frag/Log.h>
+#include <frag/profile/Profiler.h>
+#include <frag/memory/MemoryTracker.h>
+#include <frag/package/IPackage.h>
+#include <frag/package/PackageRegistry.h>
+
+namespace frag {
+
+    void detail::releaseAssetRecord(AssetRecord* record) {
+        record->manager->releaseRecord(record);
+    }
+
+    // The whole file into buffer, whatever is there right now if it changes while it is read
+    static bool readFile(const std::filesystem::path& path, std::vector<std::byte>& buffer) {
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file) return false;
+
+        std::streamoff size = file.tellg();
+        if (size < 0 || !file.seekg(0)) return false;
+        buffer.resize((size_t)size);
+        file.read(reinterpret_cast<char*>(buffer.data()), size);
+        buffer.resize((size_t)file.gcount());
+        return !file.bad();
+    }
+
+    // ------------------------------------
+    // -- Public Methods Implementation --
+    // ------------------------------------
+
+    AssetManager::AssetManager(const PackageRegistry& packageRegistry, int ioThreadCount) : packageRegistry(packageRegistry) {
+        if (ioThreadCount < 1) ioThreadCount = 1;
+
+        ioThreads.reserve(ioThreadCount);
+        for (int i = 0; i < ioThreadCount; i++) {
+            ioThreads.emplace_back(&AssetManager::ioThread, this, i);
+        }
+    }
+
+    AssetManager::~AssetManager() {
+        {
+            std::lock_guard lock(mutex);
+            running = false;
+        }
+        queueCondition.notify_all();
+        for (auto& thread : ioThreads) thread.join();
+
+        for (auto& [key, record] : records) recordPool.destroy(record);
+    }
+
+    void AssetManager::setAssetDirectory(std::filesystem::path directory) {
+        std::lock_guard lock(mutex);
+        assetDirectory = std::move(directory);
+    }
+
+    void AssetManager::registerDecoder(int type, std::shared_ptr<IAssetDecoder> decoder) {
+        if (!decoder) {
+            logError(LogChannel::ASSET, "Cannot register a null decoder for asset type {}.", type);
+            return;
+        }
+
+        std::lock_guard lock(mutex);
+        decoders[type] = std::move(decoder);
+    }
+
+    bool AssetManager::mountArchive(const std::filesystem::path& path) {
+        MemoryTagScope memoryTag(MemoryTag::ASSET);
+        auto archive = std::make_shared<AssetArchive>();
+        if (!archive->open(path)) return false;
+
+        std::lock_guard lock(mutex);
+        archives.push_back(std::move(archive));
+        return true;
+    }
+
+    AssetHandle AssetManager::load(FragHash key, AssetPriority priority) {
+        MemoryTagScope memoryTag(MemoryTag::ASSET);
+        std::lock_guard lock(mutex);
+
+        detail::AssetRecord* record;
+        auto it = records.find(key);
+        if (it != records.end()) {
+            record = it->second;
+        }
+        else {
+            int type = packageRegistry.getAssetType(key);
+            if (type < 0) {
+                logError(LogChannel::ASSET, "There is no asset with the key {:016x} in any loaded package.", key);
+                return AssetHandle();
+            }
+
+            record = recordPool.create();
+            record->manager = this;
+            record->key = key;
+            record->type = type;
+            record->path = std::string(packageRegistry.getAssetPath(key));
+            records.emplace(key, record);
+        }
+
+        record->refCount.fetch_add(1, std::memory_order_relaxed); // The one of the handle
+        if (record->cached) removeFromCache(record);
+
+        AssetState state = record->state.load(std::memory_order_relaxed);
+        if (state == AssetState::READY) cacheStats.hits++;
+
+        if (state == AssetState::UNLOADED) {
+            cacheStats.misses++;
+            record->state.store(AssetState::QUEUED, std::memory_order_relaxed);
+            pendingCount.fetch_add(1, std::memory_order_relaxed);
+            enqueue(record, priority);
+        }
+        else if (state == AssetState::QUEUED && priority < record->priority) {
+            // The old entry stays in the prefetch queue, the I/O thread skips it since the asset isn't QUEUED anymore by then
+            enqueue(record, priority);
+        }
+        return AssetHandle(record);
+    }
+
+    AssetHandle AssetManager::load(const IPackage& package, FragHash nameHash, AssetPriority priority) {
+        return load(package.getKey(nameHash), priority);
+    }
+
+    void AssetManager::setMemoryBudget(size_t bytes) {
+        std::lock_guard lock(mutex);
+        memoryBudget = bytes;
+    }
+
+    void AssetManager::setTypeMemoryBudget(int type, size_t bytes) {
+        std::lock_guard lock(mutex);
+        if (bytes == 0) typeMemoryBudgets.erase(type);
+        else typeMemoryBudgets[type] = bytes;
+    }
+
+    void AssetManager::clearCache() {
+        std::vector<AssetData> unloadedAssets;
+        std::lock_guard lock(mutex);
+        while (lruHead) unloadRecord(lruHead, unloadedAssets);
+    }
+
+    void AssetManager::enableHotReload(bool enabled) {
+        std::lock_guard lock(mutex);
+        if (enabled == (fileWatcher != nullptr)) return;
+
+        if (!enabled) {
+            fileWatcher.reset();
+            watchedAssets.clear();
+            return;
+        }
+
+        fileWatcher = std::make_unique<FileWatcher>();
+        fileWatcher->setDebounceTime(hotReloadDebounce);
+        if (!fileWatcher->start()) {
+            fileWatcher.reset();
+            return;
+        }
+        for (auto& [key, record] : records) {
+            if (record->state.load(std::memory_order_relaxed) == AssetState::READY) watchRecord(record);
+        }
+        logInfo(LogChannel::ASSET, "Hot reload enabled.");
+    }
+
+    void AssetManager::setHotReloadDebounce(std::chrono::milliseconds time) {
+        std::lock_guard lock(mutex);
+        hotReloadDebounce = time;
+        if (fileWatcher) fileWatcher->setDebounceTime(time);
+    }
+
+    void AssetManager::setReloadCallback(std::function<void(const AssetHandle& asset)> callback) {
+        std::lock_guard lock(mutex);
+        reloadCallback = std::move(callback);
+    }
+
+    AssetManager::CacheStats AssetManager::getCacheStats() const {
+        std::lock_guard lock(mutex);
+        return cacheStats;
+    }
+
+    size_t AssetManager::getTypeMemory(int type) const {
+        std::lock_guard lock(mutex);
+        auto it = typeMemory.find(type);
+        return it != typeMemory.end() ? it->second : 0;
+    }
+
+    void AssetManager::update() {
+        FRAG_PROFILE_ZONE("AssetManager::update");
+        MemoryTagScope memoryTag(MemoryTag::ASSET);
+
+        {
+            std::lock_guard lock(finishedMutex);
+            publishingRecords.swap(finishedRecords);
+        }
+
+        // Destroyed after the lock is released, freeing a big asset can take a moment
+        std::vector<AssetData> unloadedAssets;
+        std::vector<AssetHandle> reloadedAssets;
+        std::function<void(const AssetHandle&)> callback;
+        {
+            std::lock_guard lock(mutex);
+            for (detail::AssetRecord* record : publishingRecords) {
+                if (record->reloadLoading) {
+                    // Hot reload: swap the new version in, the old one stays if the new one is broken
+                    record->reloadLoading = false;
+                    if (record->result.data) {
+                        loadedMemory.fetch_add(record->result.memorySize - record->loaded.memorySize, std::memory_order_relaxed);
+                        typeMemory[record->type] += record->result.memorySize - record->loaded.memorySize;
+                        unloadedAssets.push_back(std::move(record->loaded));
+                        record->loaded = std::move(record->result);
+                        record->version++;
+
+                        record->refCount.fetch_add(1, std::memory_order_relaxed);
+                        reloadedAssets.push_back(AssetHandle(record));
+                        logDebug(LogChannel::ASSET, "Reloaded asset '{}'.", record->path);
+                    }
+                    else {
+                        logWarn(LogChannel::ASSET, "Reloading asset '{}' failed, the old version stays.", record->path);
+                    }
+                    record->result = AssetData();
+                    pendingCount.fetch_sub(1, std::memory_order_relaxed);
+
+                    if (record->reloadRequested) {
+                        record->reloadRequested = false;
+                        queueReload(record);
+                    }
+                    dropReference(record);
+                    continue;
+                }
+
+                if (record->result.data) {
+                    record->loaded = std::move(record->result);
+                    loadedCount.fetch_add(1, std::memory_order_relaxed);
+                    loadedMemory.fetch_add(record->loaded.memorySize, std::memory_order_relaxed);
+                    typeMemory[record->type] += record->loaded.memorySize;
+                    record->state.store(AssetState::READY, std::memory_order_release);
+                    if (fileWatcher) watchRecord(record);
+                }
+                else {
+                    record->state.store(AssetState::FAILED, std::memory_order_release);
+                }
+                record->result = AssetData();
+                pendingCount.fetch_sub(1, std::memory_order_relaxed);
+                dropReference(record);
+            }
+            publishingRecords.clear();
+
+            if (fileWatcher) reloadChangedFiles(unloadedAssets);
+
+            for (detail::AssetRecord* record : releasedRecords) {
+                record->released = false;
+                if (record->refCount.load(std::memory_order_acquire) != 0) continue; // Was loaded again in the meantime
+
+                // Failed assets are never cached, so loading them again tries again
+                if (memoryBudget > 0 && record->state.load(std::memory_order_relaxed) == AssetState::READY) addToCache(record);
+                else unloadRecord(record, unloadedAssets);
+            }
+            releasedRecords.clear();
+
+            evictOverBudget(unloadedAssets);
+            if (!reloadedAssets.empty()) callback = reloadCallback;
+        }
+
+        if (callback) {
+            MemoryTagScope userTag(MemoryTag::USER);
+            for (const AssetHandle& asset : reloadedAssets) callback(asset);
+        }
+    }
+
+    void AssetManager::waitForAll() {
+        FRAG_PROFILE_ZONE("AssetManager::waitForAll");
+
+        {
+            std::unique_lock lock(mutex);
+            idleCondition.wait(lock, [this]() { return queues[0].empty() && queues[1].empty() && loadingCount == 0; });
+        }
+        update();
+    }
+
+
+
+    // -------------------------------------
+    // -- Private Methods Implementation --
+    // -------------------------------------
+
+    void AssetManager::enqueue(detail::AssetRecord* record, AssetPriority priority) {
+        record->refCount.fetch_add(1, std::memory_order_relaxed); // The one of the queue entry
+        record->priority = priority;
+        queues[(size_t)priority].push_back(record);
+        queueCondition.notify_one();
+    }
+
+    void AssetManager::dropReference(detail::AssetRecord* record) {
+        if (record->refCount.fetch_sub(1, std::memory_order_acq_rel) == 1) addToReleased(record);
+    }
+
+    void AssetManager::addToReleased(detail::AssetRecord* record) {
+        if (record->released) return;
+        record->released = true;
+        releasedRecords.push_back(record);
+    }
+
+    void AssetManager::addToCache(detail::AssetRecord* record) {
+        record->cached = true;
+        record->lruPrevious = lruTail;
+        record->lruNext = nullptr;
+        if (lruTail) lruTail->lruNext = record;
+        else lruHead = record;
+        lruTail = record;
+
+        cacheStats.cachedCount++;
+        cacheStats.cachedMemory += record->loaded.memorySize;
+    }
+
+    void AssetManager::removeFromCache(detail::AssetRecord* record) {
+        if (record->lruPrevious) record->lruPrevious->lruNext = record->lruNext;
+        else lruHead = record->lruNext;
+        if (record->lruNext) record->lruNext->lruPrevious = record->lruPrevious;
+        else lruTail = record->lruPrevious;
+        record->lruPrevious = nullptr;
+        record->lruNext = nullptr;
+        record->cached = false;
+
+        cacheStats.cachedCount--;
+        cacheStats.cachedMemory -= record->loaded.memorySize;
+    }
+
+    void AssetManager::unloadRecord(detail::AssetRecord* record, std::vector<AssetData>& unloadedAssets) {
+        if (record->cached) removeFromCache(record);
+        if (fileWatcher) unwatchRecord(record);
+
+        if (record->state.load(std::memory_order_relaxed) == AssetState::READY) {
+            loadedCount.fetch_sub(1, std::memory_order_relaxed);
+            loadedMemory.fetch_sub(record->loaded.memorySize, std::memory_order_relaxed);
+            typeMemory[record->type] -= record->loaded.memorySize;
+            unloadedAssets.push_back(std::move(record->loaded));
+        }
+        records.erase(record->key);
+        recordPool.destroy(record);
+    }
+
+    void AssetManager::evictOverBudget(std::vector<AssetData>& unloadedAssets) {
+        auto evict = [&](detail::AssetRecord* record) {
+            cacheStats.evictions++;
+            cacheStats.evictedMemory += record->loaded.memorySize;
+            unloadRecord(record, unloadedAssets);
+        };
+
+        while (lruHead && loadedMemory.load(std::memory_order_relaxed) > memoryBudget) evict(lruHead);
+
+        for (const auto& [type, budget] : typeMemoryBudgets) {
+            detail::AssetRecord* record = lruHead;
+            while (record && typeMemory[type] > budget) {
+                detail::AssetRecord* next = record->lruNext;
+                if (record->type == type) evict(record);
+                record = next;
+            }
+        }
+    }
+
+    void AssetManager::watchRecord(detail::AssetRecord* record) {
+        if (record->filePath.empty()) return;
+
+        std::filesystem::path file = FileWatcher::normalizePath(record->filePath);
+        std::vector<FragHash>& keys = watchedAssets[file.string()];
+        if (std::find(keys.begin(), keys.end(), record->key) != keys.end()) return;
+        if (keys.empty()) fileWatcher->watchFile(file);
+        keys.push_back(record->key);
+    }
+
+    void AssetManager::unwatchRecord(detail::AssetRecord* record) {
+        if (record->filePath.empty()) return;
+
+        std::filesystem::path file = FileWatcher::normalizePath(record->filePath);
+        auto it = watchedAssets.find(file.string());
+        if (it == watchedAssets.end()) return;
+
+        std::erase(it->second, record->key);
+        if (it->second.empty()) {
+            fileWatcher->unwatchFile(file);
+            watchedAssets.erase(it);
+        }
+    }
+
+    void AssetManager::queueReload(detail::AssetRecord* record) {
+        if (record->reloadQueued) return;
+        if (record->reloadLoading) {
+            record->reloadRequested = true; // The file changed after the I/O thread read it
+            return;
+        }
+
+        record->reloadQueued = true;
+        pendingCount.fetch_add(1, std::memory_order_relaxed);
+        enqueue(record, AssetPriority::IMMEDIATE);
+    }
+
+    void AssetManager::reloadChangedFiles(std::vector<AssetData>& unloadedAssets) {
+        changedFiles.clear();
+        fileWatcher->collectChanges(changedFiles);
+
+        for (const std::filesystem::path& file : changedFiles) {
+            auto watched = watchedAssets.find(file.string());
+            if (watched == watchedAssets.end()) continue;
+
+            std::vector<FragHash> keys = watched->second; // unloadRecord changes the list
+            for (FragHash key : keys) {
+                auto it = records.find(key);
+                if (it == records.end()) continue;
+
+                detail::AssetRecord* record = it->second;
+                if (record->state.load(std::memory_order_relaxed) != AssetState::READY) continue;
+
+                // Nobody uses a cached asset right now, it's enough to forget it
+                if (record->cached) unloadRecord(record, unloadedAssets);
+                else queueReload(record);
+            }
+        }
+    }
+
+    void AssetManager::releaseRecord(detail::AssetRecord* record) {
+        std::lock_guard lock(mutex);
+        dropReference(record);
+    }
+
+    bool AssetManager::loadAsset(detail::AssetRecord& record, IAssetDecoder& decoder, const std::filesystem::path& path,
+        const AssetArchive* archive, const AssetArchive::Entry* archiveEntry, std::vector<std::byte>& buffer) {
+        FRAG_PROFILE_ZONE("AssetManager::loadAsset");
+
+        // Uncompressed archive entries are decoded right from the mapping, without a copy
+        std::span<const std::byte> bytes;
+        if (archiveEntry) {
+            if (archiveEntry->flags & AssetArchive::FLAG_COMPRESSED) {
+                if (!archive->read(*archiveEntry, buffer)) {
+                    logError(LogChannel::ASSET, "Could not decompress asset '{}' from its archive.", record.path);
+                    return false;
+                }
+                bytes = buffer;
+            }
+            else {
+                bytes = archive->getView(*archiveEntry);
+            }
+        }
+        else {
+            // Loose files are read, not mapped. Editors rewrite them in place while the engine runs (hot reload),
+            // a mapping of a file that gets truncated meanwhile would crash the process with SIGBUS.
+            if (!readFile(path, buffer)) {
+                logError(LogChannel::ASSET, "Could not read asset file '{}'.", path.string());
+                return false;
+            }
+            bytes = buffer;
+        }
+
+        AssetDescription description = { record.key, record.type, record.path };
+        record.result = decoder.decode(bytes, description);
+        if (!record.result.data) {
+            logError(LogChannel::ASSET, "Could not decode asset '{}' (type {}).", path.string(), record.type);
+            return false;
+        }
+        return true;
+    }
+
+    void AssetManager::ioThread(int threadIndex) {
+        MemoryTagScope memoryTag(MemoryTag::ASSET);
+        std::string threadName = "AssetIO " + std::to_string(threadIndex);
+        FRAG_PROFILE_THREAD(threadName.c_str());
+
+        std::vector<std::byte> buffer; // For loose files and compressed archive entries, grows to the biggest one
+
+        std::unique_lock lock(mutex);
+        while (true) {
+            queueCondition.wait(lock, [this]() { return !running || !queues[0].empty() || !queues[1].empty(); });
+            if (!running) return;
+
+            auto& queue = queues[0].empty() ? queues[1] : queues[0];
+            detail::AssetRecord* record = queue.front();
+            queue.pop_front();
+
+            bool reload = record->reloadQueued;
+            if (!reload && record->state.load(std::memory_order_relaxed) != AssetState::QUEUED) {
+                // Second entry of an asset that was moved to the IMMEDIATE queue
+                dropReference(record);
+                continue;
+            }
+            if (!reload && record->refCount.load(std::memory_order_relaxed) == 1) {
+                // Only the queue entry is left, nobody wants the asset anymore
+                record->state.store(AssetState::UNLOADED, std::memory_order_relaxed);
+                pendingCount.fetch_sub(1, std::memory_order_relaxed);
+                dropReference(record);
+                if (queues[0].empty() && queues[1].empty() && loadingCount == 0) idleCondition.notify_all();
+                continue;
+            }
+
+            // A reloaded asset stays READY with the old data until update swaps the new one in
+            if (reload) {
+                record->reloadQueued = false;
+                record->reloadLoading = true;
+            }
+            else {
+                record->state.store(AssetState::LOADING, std::memory_order_relaxed);
+            }
+            loadingCount++;
+
+            auto decoderIt = decoders.find(record->type);
+            std::shared_ptr<IAssetDecoder> decoder = decoderIt != decoders.end() ? decoderIt->second : rawDecoder;
+            std::filesystem::path path = record->path;
+            if (path.is_relative()) path = assetDirectory / path;
+
+            std::shared_ptr<const AssetArchive> archive;
+            const AssetArchive::Entry* archiveEntry = nullptr;
+            for (auto it = archives.rbegin(); it != archives.rend() && !archiveEntry; ++it) {
+                archiveEntry = (*it)->find(record->key);
+                if (archiveEntry) archive = *it;
+            }
+            record->filePath = archiveEntry ? std::string() : path.string();
+
+            lock.unlock();
+            loadAsset(*record, *decoder, path, archive.get(), archiveEntry, buffer);
+            {
+                std::lock_guard finishedLock(finishedMutex);
+                finishedRecords.push_back(record); // Keeps the reference of the queue entry until update
+            }
+            lock.lock();
+
+            loadingCount--;
+            if (queues[0].empty() && queues[1].empty() && loadingCount == 0) idleCondition.notify_all();
+        }
+    }
+
+}
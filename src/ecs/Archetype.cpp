@@ -0,0 +1,117 @@
+#include <frag/ecs/Archetype.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace frag {
+
+    static size_t alignUp(size_t value, size_t alignment) {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+
+    // ------------------------------------
+    // -- Public Methods Implementation --
+    // ------------------------------------
+
+    Archetype::Archetype(const ComponentMask& mask) : mask(mask) {
+        columnLookup.fill(-1);
+
+        for (size_t id = 0; id < MAX_COMPONENT_TYPES; id++) {
+            if (!mask.test(id)) continue;
+
+            columnLookup[id] = (int16_t)components.size();
+            components.push_back((ComponentId)id);
+            columnInfos.push_back(&getComponentInfo((ComponentId)id));
+        }
+        columnOffsets.resize(components.size());
+
+        // Biggest capacity that still fits into one chunk. A single entity that doesn't fit gets a bigger chunk.
+        size_t bytesPerRow = sizeof(Entity);
+        for (const ComponentInfo* info : columnInfos) bytesPerRow += info->size;
+
+        uint32_t capacity = (uint32_t)std::max<size_t>(CHUNK_SIZE / bytesPerRow, 1);
+        while (capacity > 1 && computeLayout(capacity) > CHUNK_SIZE) capacity--;
+
+        chunkCapacity = capacity;
+        chunkBytes = std::max(CHUNK_SIZE, computeLayout(capacity));
+    }
+
+    Archetype::~Archetype() {
+        for (uint32_t row = 0; row < entityCount; row++) {
+            for (size_t column = 0; column < columnInfos.size(); column++) {
+                if (columnInfos[column]->destroy) columnInfos[column]->destroy(getComponent(row, components[column]));
+            }
+        }
+        for (Chunk& chunk : chunks) {
+            ::operator delete(chunk.data, std::align_val_t(COLUMN_ALIGNMENT));
+        }
+    }
+
+
+
+    // -------------------------------------
+    // -- Private Methods Implementation --
+    // -------------------------------------
+
+    size_t Archetype::computeLayout(uint32_t capacity) {
+        size_t offset = sizeof(Entity) * capacity;
+        for (size_t column = 0; column < columnInfos.size(); column++) {
+            offset = alignUp(offset, COLUMN_ALIGNMENT);
+            columnOffsets[column] = offset;
+            offset += columnInfos[column]->size * capacity;
+        }
+        return offset;
+    }
+
+    uint32_t Archetype::allocateRow(Entity entity) {
+        size_t chunkIndex = entityCount / chunkCapacity;
+        if (chunkIndex == chunks.size()) {
+            Chunk chunk;
+            chunk.data = static_cast<std::byte*>(::operator new(chunkBytes, std::align_val_t(COLUMN_ALIGNMENT)));
+            chunks.push_back(chunk);
+        }
+
+        Chunk& chunk = chunks[chunkIndex];
+        getEntities(chunk)[chunk.count] = entity;
+        chunk.count++;
+
+        return (uint32_t)entityCount++;
+    }
+
+    Entity Archetype::removeRow(uint32_t row, bool destroyComponents) {
+        if (destroyComponents) {
+            for (size_t column = 0; column < columnInfos.size(); column++) {
+                if (columnInfos[column]->destroy) columnInfos[column]->destroy(getComponent(row, components[column]));
+            }
+        }
+
+        uint32_t lastRow = (uint32_t)entityCount - 1;
+        Entity movedEntity;
+
+        if (row != lastRow) {
+            // Fill the hole with the last entity, the storage stays packed
+            for (size_t column = 0; column < columnInfos.size(); column++) {
+                const ComponentInfo& info = *columnInfos[column];
+                void* dst = getComponent(row, components[column]);
+                void* src = getComponent(lastRow, components[column]);
+                if (info.relocate) info.relocate(dst, src);
+                else std::memcpy(dst, src, info.size);
+            }
+
+            movedEntity = getEntity(lastRow);
+            getEntities(chunks[row / chunkCapacity])[row % chunkCapacity] = movedEntity;
+        }
+
+        chunks[lastRow / chunkCapacity].count--;
+        entityCount--;
+
+        // Keep one empty chunk around, so an entity that moves back and forth doesn't allocate every time
+        if (chunks.size() > 1 && chunks[chunks.size() - 2].count == 0) {
+            ::operator delete(chunks.back().data, std::align_val_t(COLUMN_ALIGNMENT));
+            chunks.pop_back();
+        }
+
+        return movedEntity;
+    }
+
+}
@@ -0,0 +1,59 @@
+#include <frag/ecs/Component.h>
+
+#include <array>
+#include <mutex>
+
+#include <frag/Log.h>
+
+namespace frag {
+
+    // Infos are never moved once written, so they can be read without the lock once the id is published
+    static std::array<ComponentInfo, MAX_COMPONENT_TYPES> componentInfos;
+    static std::atomic<size_t> componentCount = 0;
+    static std::mutex registryMutex;
+
+    namespace detail {
+        ComponentId registerComponentType(std::atomic<ComponentId>& slot, ComponentInfo&& info) {
+            std::lock_guard lock(registryMutex);
+
+            ComponentId id = slot.load(std::memory_order_relaxed);
+            if (id != INVALID_COMPONENT_ID) {
+                if (info.name != componentInfos[id].name) {
+                    logWarn(LogChannel::PACKAGE, "Component '{}' is already registered as '{}', keeping the old name.", info.name, componentInfos[id].name);
+                }
+                return id;
+            }
+
+            size_t count = componentCount.load(std::memory_order_relaxed);
+            if (count >= MAX_COMPONENT_TYPES) {
+                logFatal(LogChannel::PACKAGE, "Too many component types, cannot register '{}' (FRAG_ECS_MAX_COMPONENTS is {}).", info.name, MAX_COMPONENT_TYPES);
+                std::terminate();
+            }
+
+            id = (ComponentId)count;
+            componentInfos[id] = std::move(info);
+            componentCount.store(count + 1, std::memory_order_release);
+            slot.store(id, std::memory_order_release);
+
+            logTrace(LogChannel::PACKAGE, "Registered component '{}' with id {}.", componentInfos[id].name, id);
+            return id;
+        }
+    }
+
+    const ComponentInfo& getComponentInfo(ComponentId id) {
+        return componentInfos[id];
+    }
+
+    size_t getComponentTypeCount() {
+        return componentCount.load(std::memory_order_acquire);
+    }
+
+    ComponentId findComponentId(std::string_view name) {
+        size_t count = componentCount.load(std::memory_order_acquire);
+        for (size_t id = 0; id < count; id++) {
+            if (componentInfos[id].name == name) return (ComponentId)id;
+        }
+        return INVALID_COMPONENT_ID;
+    }
+
+}
@@ -0,0 +1,133 @@
+#include <frag/ecs/World.h>
+
+#include <cstring>
+
+namespace frag {
+
+    // ------------------------------------
+    // -- Public Methods Implementation --
+    // ------------------------------------
+
+    World::World() {
+        emptyArchetype = getOrCreateArchetype(ComponentMask());
+    }
+
+    World::~World() {
+        // Archetypes destroy their components themselves
+    }
+
+    Entity World::createEntity() {
+        Entity entity = allocateEntity();
+
+        EntityRecord& record = records[entity.index];
+        record.archetype = emptyArchetype;
+        record.row = emptyArchetype->allocateRow(entity);
+        return entity;
+    }
+
+    void World::destroyEntity(Entity entity) {
+        if (!isAlive(entity)) {
+            logWarn(LogChannel::CORE, "destroyEntity on a dead entity ({}:{})", entity.index, entity.generation);
+            return;
+        }
+
+        EntityRecord& record = records[entity.index];
+        Entity moved = record.archetype->removeRow(record.row, true);
+        if (moved.isValid()) records[moved.index].row = record.row;
+
+        record.archetype = nullptr;
+        record.generation++;
+        freeIndices.push_back(entity.index);
+        aliveEntities--;
+    }
+
+
+
+    // -------------------------------------
+    // -- Private Methods Implementation --
+    // -------------------------------------
+
+    Entity World::allocateEntity() {
+        Entity entity;
+        if (!freeIndices.empty()) {
+            entity.index = freeIndices.back();
+            freeIndices.pop_back();
+        }
+        else {
+            entity.index = (uint32_t)records.size();
+            records.emplace_back();
+        }
+
+        entity.generation = records[entity.index].generation;
+        aliveEntities++;
+        return entity;
+    }
+
+    Archetype* World::getOrCreateArchetype(const ComponentMask& mask) {
+        auto it = archetypeLookup.find(mask);
+        if (it != archetypeLookup.end()) return it->second;
+
+        archetypes.push_back(std::make_unique<Archetype>(mask));
+        Archetype* archetype = archetypes.back().get();
+        archetypeLookup.emplace(mask, archetype);
+
+        logTrace(LogChannel::CORE, "Created archetype with {} component(s), {} entities per chunk.", archetype->getComponents().size(), archetype->getChunkCapacity());
+        return archetype;
+    }
+
+    Archetype* World::getArchetypeWith(Archetype* archetype, ComponentId id) {
+        auto it = archetype->addEdges.find(id);
+        if (it != archetype->addEdges.end()) return it->second;
+
+        ComponentMask mask = archetype->getMask();
+        mask.set(id);
+        Archetype* target = getOrCreateArchetype(mask);
+
+        archetype->addEdges.emplace(id, target);
+        target->removeEdges.emplace(id, archetype);
+        return target;
+    }
+
+    Archetype* World::getArchetypeWithout(Archetype* archetype, ComponentId id) {
+        auto it = archetype->removeEdges.find(id);
+        if (it != archetype->removeEdges.end()) return it->second;
+
+        ComponentMask mask = archetype->getMask();
+        mask.reset(id);
+        Archetype* target = getOrCreateArchetype(mask);
+
+        archetype->removeEdges.emplace(id, target);
+        target->addEdges.emplace(id, archetype);
+        return target;
+    }
+
+    void World::moveEntity(Entity entity, Archetype* target) {
+        EntityRecord& record = records[entity.index];
+        Archetype* source = record.archetype;
+        uint32_t sourceRow = record.row;
+        uint32_t targetRow = target->allocateRow(entity);
+
+        for (size_t column = 0; column < source->columnInfos.size(); column++) {
+            const ComponentInfo& info = *source->columnInfos[column];
+            ComponentId id = source->components[column];
+            void* src = source->getComponent(sourceRow, id);
+
+            if (!target->hasComponent(id)) {
+                if (info.destroy) info.destroy(src);
+                continue;
+            }
+
+            void* dst = target->getComponent(targetRow, id);
+            if (info.relocate) info.relocate(dst, src);
+            else std::memcpy(dst, src, info.size);
+        }
+
+        // Every component of the old row is moved out or destroyed, only the hole has to be filled
+        Entity moved = source->removeRow(sourceRow, false);
+        if (moved.isValid()) records[moved.index].row = sourceRow;
+
+        record.archetype = target;
+        record.row = targetRow;
+    }
+
+}
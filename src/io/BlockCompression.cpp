@@ -0,0 +1,157 @@
+#include <frag/io/BlockCompression.h>
+
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+
+namespace frag {
+
+    namespace {
+        constexpr size_t MIN_MATCH = 4;
+        constexpr size_t LAST_LITERALS = 5;     // The block always ends with at least this many literals
+        constexpr size_t MATCH_FIND_LIMIT = 12; // No match starts in the last 12 bytes
+        constexpr size_t MAX_OFFSET = 65535;
+        constexpr int HASH_BITS = 14;
+        constexpr int SKIP_TRIGGER = 6;         // Incompressible data is skipped faster and faster
+
+        uint32_t read32(const uint8_t* data) {
+            uint32_t value;
+            std::memcpy(&value, data, sizeof(value));
+            return value;
+        }
+
+        uint32_t hashSequence(uint32_t sequence) {
+            return (sequence * 2654435761u) >> (32 - HASH_BITS);
+        }
+
+        void writeLength(std::vector<std::byte>& output, size_t length) {
+            while (length >= 255) {
+                output.push_back(std::byte{ 255 });
+                length -= 255;
+            }
+            output.push_back(std::byte((uint8_t)length));
+        }
+
+        void writeSequence(std::vector<std::byte>& output, const uint8_t* literals, size_t literalLength, size_t offset, size_t matchLength) {
+            size_t matchCode = matchLength - MIN_MATCH;
+            uint8_t token = (uint8_t)((std::min<size_t>(literalLength, 15) << 4) | std::min<size_t>(matchCode, 15));
+            output.push_back(std::byte(token));
+            if (literalLength >= 15) writeLength(output, literalLength - 15);
+
+            size_t literalStart = output.size();
+            output.resize(literalStart + literalLength);
+            if (literalLength > 0) std::memcpy(output.data() + literalStart, literals, literalLength);
+
+            output.push_back(std::byte((uint8_t)(offset & 0xFF)));
+            output.push_back(std::byte((uint8_t)(offset >> 8)));
+            if (matchCode >= 15) writeLength(output, matchCode - 15);
+        }
+
+        // Returns false if the length runs past the end of the input
+        bool readLength(const uint8_t*& in, const uint8_t* inEnd, size_t& length) {
+            uint8_t value;
+            do {
+                if (in >= inEnd) return false;
+                value = *in++;
+                length += value;
+            } while (value == 255);
+            return true;
+        }
+    }
+
+    void compressBlock(std::span<const std::byte> input, std::vector<std::byte>& output) {
+        output.clear();
+        output.reserve(getMaxCompressedSize(input.size()));
+
+        const uint8_t* in = reinterpret_cast<const uint8_t*>(input.data());
+        size_t size = input.size();
+        size_t anchor = 0;
+
+        if (size > MATCH_FIND_LIMIT) {
+            // Position + 1 of the last sequence with that hash, 0 = none
+            std::vector<uint32_t> table((size_t)1 << HASH_BITS, 0);
+            size_t matchLimit = size - LAST_LITERALS;
+            size_t searchLimit = size - MATCH_FIND_LIMIT;
+
+            size_t position = 0;
+            size_t misses = 0;
+            while (position < searchLimit) {
+                uint32_t sequence = read32(in + position);
+                uint32_t& slot = table[hashSequence(sequence)];
+                size_t candidate = (size_t)slot - 1;
+                bool found = slot != 0 && position - candidate <= MAX_OFFSET && read32(in + candidate) == sequence;
+                slot = (uint32_t)(position + 1);
+
+                if (!found) {
+                    position += 1 + (misses++ >> SKIP_TRIGGER);
+                    continue;
+                }
+                misses = 0;
+
+                // Grow the match backwards over literals that match as well
+                while (position > anchor && candidate > 0 && in[position - 1] == in[candidate - 1]) {
+                    position--;
+                    candidate--;
+                }
+
+                size_t matchLength = MIN_MATCH;
+                while (position + matchLength < matchLimit && in[candidate + matchLength] == in[position + matchLength]) matchLength++;
+
+                writeSequence(output, in + anchor, position - anchor, position - candidate, matchLength);
+                position += matchLength;
+                anchor = position;
+            }
+        }
+
+        // Last literals, a token without a match
+        size_t literalLength = size - anchor;
+        output.push_back(std::byte((uint8_t)(std::min<size_t>(literalLength, 15) << 4)));
+        if (literalLength >= 15) writeLength(output, literalLength - 15);
+        size_t literalStart = output.size();
+        output.resize(literalStart + literalLength);
+        if (literalLength > 0) std::memcpy(output.data() + literalStart, in + anchor, literalLength);
+    }
+
+    bool decompressBlock(std::span<const std::byte> input, std::span<std::byte> output) {
+        const uint8_t* in = reinterpret_cast<const uint8_t*>(input.data());
+        const uint8_t* inEnd = in + input.size();
+        uint8_t* outStart = reinterpret_cast<uint8_t*>(output.data());
+        uint8_t* out = outStart;
+        uint8_t* outEnd = outStart + output.size();
+
+        while (in < inEnd) {
+            uint8_t token = *in++;
+
+            size_t literalLength = token >> 4;
+            if (literalLength == 15 && !readLength(in, inEnd, literalLength)) return false;
+            if (literalLength > (size_t)(inEnd - in) || literalLength > (size_t)(outEnd - out)) return false;
+            if (literalLength > 0) std::memcpy(out, in, literalLength);
+            in += literalLength;
+            out += literalLength;
+
+            if (in == inEnd) break; // The last sequence has no match
+
+            if (inEnd - in < 2) return false;
+            size_t offset = (size_t)in[0] | ((size_t)in[1] << 8);
+            in += 2;
+            if (offset == 0 || offset > (size_t)(out - outStart)) return false;
+
+            size_t matchLength = (token & 15);
+            if (matchLength == 15 && !readLength(in, inEnd, matchLength)) return false;
+            matchLength += MIN_MATCH;
+            if (matchLength > (size_t)(outEnd - out)) return false;
+
+            const uint8_t* match = out - offset;
+            if (offset >= matchLength) {
+                std::memcpy(out, match, matchLength);
+                out += matchLength;
+            }
+            else {
+                // Overlapping match, repeats the last offset bytes
+                for (size_t i = 0; i < matchLength; i++) *out++ = match[i];
+            }
+        }
+        return out == outEnd;
+    }
+
+}
@@ -0,0 +1,171 @@
+#include <frag/io/FileWatcher.h>
+
+#include <system_error>
+
+#include <frag/Log.h>
+#include <frag/profile/Profiler.h>
+
+#if defined(__linux__)
+    #include <poll.h>
+    #include <sys/eventfd.h>
+    #include <sys/inotify.h>
+    #include <unistd.h>
+#endif
+
+namespace frag {
+
+    // ------------------------------------
+    // -- Public Methods Implementation --
+    // ------------------------------------
+
+    FileWatcher::~FileWatcher() {
+        stop();
+    }
+
+    bool FileWatcher::start() {
+        if (running) return true;
+
+        #if defined(__linux__)
+            inotifyHandle = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+            wakeHandle = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+            if (inotifyHandle < 0 || wakeHandle < 0) {
+                logError(LogChannel::CORE, "Cannot start the file watcher, inotify is not available.");
+                if (inotifyHandle >= 0) ::close(inotifyHandle);
+                if (wakeHandle >= 0) ::close(wakeHandle);
+                inotifyHandle = -1;
+                wakeHandle = -1;
+                return false;
+            }
+
+            {
+                std::lock_guard lock(mutex);
+                for (const std::string& file : watchedFiles) {
+                    addDirectoryWatch(std::filesystem::path(file).parent_path().string());
+                }
+            }
+
+            running = true;
+            watchThread = std::thread(&FileWatcher::watchThreadLoop, this);
+            return true;
+        #else
+            logWarn(LogChannel::CORE, "File watching is not supported on this platform yet.");
+            return false;
+        #endif
+    }
+
+    void FileWatcher::stop() {
+        if (!running) return;
+
+        #if defined(__linux__)
+            running = false;
+            uint64_t wake = 1;
+            [[maybe_unused]] ssize_t written = ::write(wakeHandle, &wake, sizeof(wake));
+            watchThread.join();
+
+            ::close(inotifyHandle);
+            ::close(wakeHandle);
+            inotifyHandle = -1;
+            wakeHandle = -1;
+
+            std::lock_guard lock(mutex);
+            directoryWatches.clear();
+            watchedDirectories.clear();
+        #endif
+    }
+
+    void FileWatcher::watchFile(const std::filesystem::path& path) {
+        std::filesystem::path file = normalizePath(path);
+
+        std::lock_guard lock(mutex);
+        if (!watchedFiles.insert(file.string()).second) return;
+        if (running) addDirectoryWatch(file.parent_path().string());
+    }
+
+    void FileWatcher::unwatchFile(const std::filesystem::path& path) {
+        // The directory stays watched, other files in it might get watched again later
+        std::string file = normalizePath(path).string();
+
+        std::lock_guard lock(mutex);
+        watchedFiles.erase(file);
+        pendingChanges.erase(file);
+    }
+
+    void FileWatcher::setDebounceTime(std::chrono::milliseconds time) {
+        std::lock_guard lock(mutex);
+        debounceTime = time;
+    }
+
+    void FileWatcher::collectChanges(std::vector<std::filesystem::path>& changedFiles) {
+        auto now = std::chrono::steady_clock::now();
+
+        std::lock_guard lock(mutex);
+        for (auto it = pendingChanges.begin(); it != pendingChanges.end();) {
+            if (now - it->second < debounceTime) {
+                ++it;
+                continue;
+            }
+            changedFiles.emplace_back(it->first);
+            it = pendingChanges.erase(it);
+        }
+    }
+
+    std::filesystem::path FileWatcher::normalizePath(const std::filesystem::path& path) {
+        std::error_code error;
+        std::filesystem::path absolute = std::filesystem::absolute(path, error);
+        return (error ? path : absolute).lexically_normal();
+    }
+
+
+
+    // -------------------------------------
+    // -- Private Methods Implementation --
+    // -------------------------------------
+
+    void FileWatcher::addDirectoryWatch(const std::string& directory) {
+        #if defined(__linux__)
+            if (directoryWatches.contains(directory)) return;
+
+            int watch = inotify_add_watch(inotifyHandle, directory.c_str(), IN_CLOSE_WRITE | IN_MODIFY | IN_CREATE | IN_MOVED_TO);
+            if (watch < 0) {
+                logWarn(LogChannel::CORE, "Cannot watch directory '{}' for changes.", directory);
+                return;
+            }
+            directoryWatches[directory] = watch;
+            watchedDirectories[watch] = directory;
+        #endif
+    }
+
+    void FileWatcher::watchThreadLoop() {
+        #if defined(__linux__)
+            FRAG_PROFILE_THREAD("FileWatcher");
+
+            // Big enough for many events at once, aligned like inotify_event wants it
+            alignas(inotify_event) char buffer[16 * 1024];
+
+            pollfd handles[2] = { { inotifyHandle, POLLIN, 0 }, { wakeHandle, POLLIN, 0 } };
+            while (running.load(std::memory_order_relaxed)) {
+                if (::poll(handles, 2, -1) <= 0) continue;
+                if (handles[1].revents & POLLIN) break;
+
+                while (true) {
+                    ssize_t length = ::read(inotifyHandle, buffer, sizeof(buffer));
+                    if (length <= 0) break;
+
+                    auto now = std::chrono::steady_clock::now();
+                    std::lock_guard lock(mutex);
+                    for (ssize_t offset = 0; offset < length;) {
+                        const inotify_event* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+                        offset += sizeof(inotify_event) + event->len;
+
+                        auto directory = watchedDirectories.find(event->wd);
+                        if (event->len == 0 || directory == watchedDirectories.end()) continue;
+
+                        std::string file = (std::filesystem::path(directory->second) / event->name).string();
+                        if (watchedFiles.contains(file)) pendingChanges[file] = now;
+                    }
+                }
+            }
+        #endif
+    }
+
+}
@@ -0,0 +1,130 @@
+#include <frag/io/MappedFile.h>
+
+#include <utility>
+
+#if defined(_WIN32)
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace frag {
+
+    // ------------------------------------
+    // -- Public Methods Implementation --
+    // ------------------------------------
+
+    MappedFile::~MappedFile() {
+        close();
+    }
+
+    MappedFile::MappedFile(MappedFile&& other) noexcept {
+        *this = std::move(other);
+    }
+
+    MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+        if (this == &other) return *this;
+        close();
+
+        data = std::exchange(other.data, nullptr);
+        size = std::exchange(other.size, 0);
+        opened = std::exchange(other.opened, false);
+        #if defined(_WIN32)
+            fileHandle = std::exchange(other.fileHandle, nullptr);
+            mappingHandle = std::exchange(other.mappingHandle, nullptr);
+        #endif
+        return *this;
+    }
+
+    #if defined(_WIN32)
+
+    bool MappedFile::open(const std::filesystem::path& path) {
+        close();
+
+        HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) return false;
+
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(file, &fileSize)) {
+            CloseHandle(file);
+            return false;
+        }
+
+        fileHandle = file;
+        size = (size_t)fileSize.QuadPart;
+        opened = true;
+        if (size == 0) return true; // Empty files cannot be mapped
+
+        HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        void* view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+        if (!view) {
+            if (mapping) CloseHandle(mapping);
+            close();
+            return false;
+        }
+
+        mappingHandle = mapping;
+        data = static_cast<const std::byte*>(view);
+        return true;
+    }
+
+    void MappedFile::close() {
+        if (data) UnmapViewOfFile(data);
+        if (mappingHandle) CloseHandle(mappingHandle);
+        if (fileHandle) CloseHandle(fileHandle);
+
+        data = nullptr;
+        size = 0;
+        opened = false;
+        fileHandle = nullptr;
+        mappingHandle = nullptr;
+    }
+
+    #else
+
+    bool MappedFile::open(const std::filesystem::path& path) {
+        close();
+
+        int file = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (file < 0) return false;
+
+        struct stat fileStat;
+        if (fstat(file, &fileStat) != 0) {
+            ::close(file);
+            return false;
+        }
+
+        size = (size_t)fileStat.st_size;
+        opened = true;
+        if (size > 0) {
+            void* view = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+            if (view == MAP_FAILED) {
+                ::close(file);
+                size = 0;
+                opened = false;
+                return false;
+            }
+            data = static_cast<const std::byte*>(view);
+        }
+
+        // The mapping keeps the file alive on its own
+        ::close(file);
+        return true;
+    }
+
+    void MappedFile::close() {
+        if (data) munmap(const_cast<std::byte*>(data), size);
+
+        data = nullptr;
+        size = 0;
+        opened = false;
+    }
+
+    #endif
+
+}
@@ -0,0 +1,280 @@
+#include <frag/job/JobSystem.h>
+
+#include <array>
+#include <string>
+
+#include <frag/Log.h>
+#include <frag/profile/Profiler.h>
+
+namespace frag {
+
+    // Per-thread pool of Job objects. Only the owning thread allocates, any thread may give jobs back.
+    struct JobPool {
+        static constexpr size_t CHUNK_SIZE = 256;
+
+        Job* freeList = nullptr;
+        std::atomic<Job*> returnedJobs = nullptr;
+        std::vector<std::unique_ptr<Job[]>> chunks;
+    };
+
+    // Which JobSystems the thread belongs to. Fixed size, a thread_local vector would put heap memory
+    // of the thread onto whoever created the first JobSystem there.
+    struct JobThreadContext {
+        static constexpr size_t MAX_SYSTEMS = 8;
+
+        struct Membership {
+            uint64_t systemId = 0;
+            int threadIndex = -1;
+        };
+        std::array<Membership, MAX_SYSTEMS> systems;
+        size_t systemCount = 0;
+        uint32_t randomState = 0x9E3779B9u;
+
+        bool join(uint64_t systemId, int threadIndex) {
+            if (systemCount == MAX_SYSTEMS) return false;
+            systems[systemCount++] = { systemId, threadIndex };
+            return true;
+        }
+        void leave(uint64_t systemId) {
+            for (size_t i = 0; i < systemCount; i++) {
+                if (systems[i].systemId != systemId) continue;
+                systems[i] = systems[--systemCount];
+                return;
+            }
+        }
+        int findThreadIndex(uint64_t systemId) const {
+            for (size_t i = 0; i < systemCount; i++) {
+                if (systems[i].systemId == systemId) return systems[i].threadIndex;
+            }
+            return -1;
+        }
+    };
+    static thread_local JobThreadContext jobThreadContext;
+    static std::atomic<uint64_t> nextSystemId = 1;
+
+    static uint32_t nextRandom() {
+        // xorshift32, only used to pick steal victims
+        uint32_t x = jobThreadContext.randomState;
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        jobThreadContext.randomState = x;
+        return x;
+    }
+
+    // ------------------------------------
+    // -- Public Methods Implementation --
+    // ------------------------------------
+
+    JobSystem::JobSystem(int workerCount) {
+        if (workerCount < 0) {
+            unsigned cores = std::thread::hardware_concurrency();
+            workerCount = cores > 1 ? (int)cores - 1 : 0;
+        }
+
+        for (int i = 0; i <= workerCount; i++) {
+            queues.push_back(std::make_unique<WorkStealingDeque<Job>>(QUEUE_CAPACITY));
+            pools.push_back(std::make_unique<JobPool>());
+        }
+
+        systemId = nextSystemId.fetch_add(1, std::memory_order_relaxed);
+        if (!jobThreadContext.join(systemId, 0)) {
+            logWarn(LogChannel::CORE, "This thread already owns {} JobSystems, it counts as a foreign thread for the new one.", JobThreadContext::MAX_SYSTEMS);
+        }
+
+        running = true;
+        for (int i = 1; i <= workerCount; i++) {
+            workers.emplace_back(&JobSystem::workerThread, this, i);
+        }
+
+        FRAG_LOG_DEBUG(LogChannel::CORE, "JobSystem started with {} worker thread(s).", workerCount);
+    }
+
+    JobSystem::~JobSystem() {
+        running.store(false, std::memory_order_release);
+        {
+            std::lock_guard lock(sleepMutex);
+            sleepCondition.notify_all();
+        }
+        for (std::thread& worker : workers) worker.join();
+
+        jobThreadContext.leave(systemId);
+    }
+
+    void JobSystem::wait(JobCounter& counter) {
+        FRAG_PROFILE_ZONE("JobSystem::wait");
+
+        int threadIndex = getCurrentThreadIndex();
+        int idleRounds = 0;
+        while (!counter.isDone()) {
+            Job* job = findJob(threadIndex);
+            if (job) {
+                execute(job);
+                idleRounds = 0;
+                continue;
+            }
+
+            // The remaining jobs are running on other threads
+            if (++idleRounds > 64) std::this_thread::yield();
+        }
+    }
+
+    int JobSystem::getCurrentThreadIndex() const {
+        return jobThreadContext.findThreadIndex(systemId);
+    }
+
+
+
+    // -------------------------------------
+    // -- Private Methods Implementation --
+    // -------------------------------------
+
+    Job* JobSystem::allocateJob() {
+        int threadIndex = getCurrentThreadIndex();
+        if (threadIndex < 0) return new Job();
+
+        JobPool& pool = *pools[threadIndex];
+        if (!pool.freeList) {
+            pool.freeList = pool.returnedJobs.exchange(nullptr, std::memory_order_acquire);
+        }
+        if (!pool.freeList) {
+            pool.chunks.push_back(std::make_unique<Job[]>(JobPool::CHUNK_SIZE));
+            Job* chunk = pool.chunks.back().get();
+            for (size_t i = 0; i < JobPool::CHUNK_SIZE; i++) {
+                chunk[i].pool = &pool;
+                chunk[i].next = pool.freeList;
+                pool.freeList = &chunk[i];
+            }
+        }
+
+        Job* job = pool.freeList;
+        pool.freeList = job->next;
+        return job;
+    }
+
+    void JobSystem::freeJob(Job* job) {
+        JobPool* pool = job->pool;
+        if (!pool) {
+            delete job;
+            return;
+        }
+
+        Job* head = pool->returnedJobs.load(std::memory_order_relaxed);
+        do {
+            job->next = head;
+        } while (!pool->returnedJobs.compare_exchange_weak(head, job, std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    void JobSystem::submit(Job* job) {
+        int threadIndex = getCurrentThreadIndex();
+
+        if (threadIndex >= 0) {
+            if (!queues[threadIndex]->push(job)) {
+                // Local queue is full, just do it right now
+                execute(job);
+                return;
+            }
+        }
+        else {
+            std::lock_guard lock(foreignJobsMutex);
+            foreignJobs.push_back(job);
+        }
+
+        queuedJobs.fetch_add(1, std::memory_order_seq_cst);
+        wakeWorker();
+    }
+
+    void JobSystem::execute(Job* job) {
+        job->execute(*job);
+        job->destroy(*job);
+
+        JobCounter* counter = job->counter;
+        freeJob(job);
+
+        if (counter) {
+            // The waiting thread may destroy the counter as soon as it sees it done, so the lock
+            // is taken before the decrement and the counter isn't touched after unlocking it
+            Job* waiting = nullptr;
+            counter->lockWaitingJobs();
+            if (counter->value.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                // Counter is done, start everything that waited for it
+                waiting = counter->waitingJobs;
+                counter->waitingJobs = nullptr;
+            }
+            counter->unlockWaitingJobs();
+
+            while (waiting) {
+                Job* next = waiting->next;
+                submit(waiting);
+                waiting = next;
+            }
+        }
+    }
+
+    Job* JobSystem::findJob(int threadIndex) {
+        Job* job = nullptr;
+
+        if (threadIndex >= 0) job = queues[threadIndex]->pop();
+
+        if (!job) {
+            std::lock_guard lock(foreignJobsMutex);
+            if (!foreignJobs.empty()) {
+                job = foreignJobs.front();
+                foreignJobs.pop_front();
+            }
+        }
+
+        if (!job) {
+            size_t queueCount = queues.size();
+            size_t start = nextRandom() % queueCount;
+            for (size_t i = 0; i < queueCount && !job; i++) {
+                size_t victim = (start + i) % queueCount;
+                if ((int)victim == threadIndex) continue;
+                job = queues[victim]->steal();
+            }
+        }
+
+        if (job) queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+        return job;
+    }
+
+    void JobSystem::wakeWorker() {
+        if (sleepingWorkers.load(std::memory_order_seq_cst) > 0) {
+            std::lock_guard lock(sleepMutex);
+            sleepCondition.notify_one();
+        }
+    }
+
+    void JobSystem::workerThread(int threadIndex) {
+        jobThreadContext.join(systemId, threadIndex); // A fresh thread, there is always space
+        jobThreadContext.randomState ^= (uint32_t)threadIndex * 0x85EBCA6Bu;
+
+        thread_local std::string threadName = "JobWorker " + std::to_string(threadIndex);
+        FRAG_PROFILE_THREAD(threadName.c_str());
+
+        int idleRounds = 0;
+        while (running.load(std::memory_order_acquire)) {
+            Job* job = findJob(threadIndex);
+            if (job) {
+                execute(job);
+                idleRounds = 0;
+                continue;
+            }
+
+            if (++idleRounds < 64) {
+                std::this_thread::yield();
+                continue;
+            }
+
+            // Nothing to do for a while, sleep until a job gets submitted
+            std::unique_lock lock(sleepMutex);
+            sleepingWorkers.fetch_add(1, std::memory_order_seq_cst);
+            if (queuedJobs.load(std::memory_order_seq_cst) <= 0 && running.load(std::memory_order_acquire)) {
+                sleepCondition.wait(lock);
+            }
+            sleepingWorkers.fetch_sub(1, std::memory_order_relaxed);
+            idleRounds = 0;
+        }
+    }
+
+}
@@ -0,0 +1,132 @@
+#include <frag/log/FileLogSink.h>
+
+#include <iostream>
+#include <system_error>
+
+namespace frag {
+
+    // ------------------------------------
+    // -- Public Methods Implementation --
+    // ------------------------------------
+
+    FileLogSink::FileLogSink(std::filesystem::path path) : FileLogSink(std::move(path), Settings()) {}
+
+    FileLogSink::FileLogSink(std::filesystem::path path, Settings settings) : path(std::move(path)), settings(settings) {
+        buffer.reserve(settings.flushThreshold + 4096);
+        openFile();
+    }
+
+    FileLogSink::~FileLogSink() {
+        flush();
+        if (file) std::fclose(file);
+    }
+
+    void FileLogSink::write(std::string_view lines) {
+        // Without a file (it couldn't be opened) the lines would only pile up in the buffer
+        if (!file) {
+            droppedBytes += lines.size();
+            return;
+        }
+
+        if (buffer.empty()) firstBufferedTime = std::chrono::steady_clock::now();
+        buffer.append(lines);
+
+        if (buffer.size() >= settings.flushThreshold || std::chrono::steady_clock::now() >= getFlushDeadline()) {
+            flush();
+        }
+    }
+
+    void FileLogSink::flush() {
+        if (buffer.empty()) return;
+
+        if (file && currentFileSize > 0 && currentFileSize + buffer.size() > settings.maxFileSize) rotate();
+        if (!file) {
+            droppedBytes += buffer.size();
+            buffer.clear();
+            return;
+        }
+
+        // The stream is unbuffered, so this is exactly one write of the whole batch
+        size_t written = std::fwrite(buffer.data(), 1, buffer.size(), file);
+        currentFileSize += written;
+        totalBytesWritten += written;
+        if (written == buffer.size()) {
+            writeFailing = false;
+            buffer.clear();
+            return;
+        }
+
+        // Short write (disk full, I/O error), the rest is tried again with the next flush.
+        // It isn't kept forever though, a disk that stays full would let the buffer grow without end.
+        std::clearerr(file);
+        buffer.erase(0, written);
+        if (!writeFailing) {
+            // Logging this through the logger would end up right here again
+            std::cerr << "FragLogger: Cannot write to log file '" << path.string() << "', " << buffer.size() << " bytes are waiting.\n";
+            writeFailing = true;
+        }
+        if (buffer.size() > settings.flushThreshold) {
+            std::cerr << "FragLogger: Dropped " << buffer.size() << " bytes of log lines that couldn't be written to '" << path.string() << "'.\n";
+            droppedBytes += buffer.size();
+            buffer.clear();
+        }
+        firstBufferedTime = std::chrono::steady_clock::now(); // Otherwise the deadline stays in the past and the logger thread spins
+    }
+
+    std::chrono::steady_clock::time_point FileLogSink::getFlushDeadline() const {
+        if (buffer.empty() || !file) return std::chrono::steady_clock::time_point::max();
+        return firstBufferedTime + settings.flushInterval;
+    }
+
+
+
+    // -------------------------------------
+    // -- Private Methods Implementation --
+    // -------------------------------------
+
+    void FileLogSink::openFile() {
+        if (path.has_parent_path()) {
+            std::error_code error;
+            std::filesystem::create_directories(path.parent_path(), error);
+        }
+
+        file = std::fopen(path.string().c_str(), "ab");
+        if (!file) {
+            // Logging this through the logger would end up right here again
+            std::cerr << "FragLogger: Cannot open log file '" << path.string() << "', file logging is disabled.\n";
+            return;
+        }
+        std::setvbuf(file, nullptr, _IONBF, 0); // We do the buffering ourselves
+
+        std::error_code error;
+        uintmax_t size = std::filesystem::file_size(path, error);
+        currentFileSize = error ? 0 : (size_t)size;
+    }
+
+    void FileLogSink::rotate() {
+        std::fclose(file);
+        file = nullptr;
+
+        std::error_code error;
+        if (settings.maxRotatedFiles > 0) {
+            std::filesystem::remove(getRotatedPath(settings.maxRotatedFiles), error);
+            for (int i = settings.maxRotatedFiles - 1; i >= 1; i--) {
+                std::filesystem::rename(getRotatedPath(i), getRotatedPath(i + 1), error);
+            }
+            std::filesystem::rename(path, getRotatedPath(1), error);
+        }
+        else {
+            std::filesystem::remove(path, error);
+        }
+
+        openFile();
+    }
+
+    // game.log -> game.<index>.log
+    std::filesystem::path FileLogSink::getRotatedPath(int index) const {
+        std::filesystem::path rotated = path;
+        rotated.replace_filename(path.stem().string() + "." + std::to_string(index) + path.extension().string());
+        return rotated;
+    }
+
+}
@@ -0,0 +1,104 @@
+#include <frag/memory/LinearArena.h>
+
+#include <algorithm>
+
+namespace frag {
+
+    // ------------------------------------
+    // -- Public Methods Implementation --
+    // ------------------------------------
+
+    LinearArena::LinearArena(size_t chunkSize, std::pmr::memory_resource* upstream) : upstream(upstream), chunkSize(chunkSize) {}
+
+    LinearArena::~LinearArena() {
+        freeChunks(current.load(std::memory_order_relaxed));
+    }
+
+    void LinearArena::reset() {
+        Chunk* chunk = current.load(std::memory_order_relaxed);
+        if (!chunk) return;
+
+        peakBytes = std::max(peakBytes, getUsedBytes());
+        if (!chunk->previous) {
+            chunk->used.store(0, std::memory_order_relaxed);
+            return;
+        }
+
+        // The frame needed more than one chunk, next time one chunk of the whole size is enough
+        size_t capacity = getCapacity();
+        freeChunks(chunk);
+        current.store(nullptr, std::memory_order_relaxed);
+        addChunk(capacity);
+    }
+
+    size_t LinearArena::getUsedBytes() const {
+        size_t used = 0;
+        for (Chunk* chunk = current.load(std::memory_order_acquire); chunk; chunk = chunk->previous) {
+            used += chunk->used.load(std::memory_order_relaxed);
+        }
+        return used;
+    }
+
+    size_t LinearArena::getCapacity() const {
+        size_t capacity = 0;
+        for (Chunk* chunk = current.load(std::memory_order_acquire); chunk; chunk = chunk->previous) {
+            capacity += chunk->capacity;
+        }
+        return capacity;
+    }
+
+
+
+    // -------------------------------------
+    // -- Private Methods Implementation --
+    // -------------------------------------
+
+    void* LinearArena::do_allocate(size_t bytes, size_t alignment) {
+        Chunk* chunk = current.load(std::memory_order_acquire);
+        if (chunk) {
+            if (void* memory = allocateFrom(chunk, bytes, alignment)) return memory;
+        }
+
+        std::lock_guard lock(growMutex);
+        // Another thread may have added a chunk while this one waited for the lock
+        Chunk* newest = current.load(std::memory_order_acquire);
+        if (newest && newest != chunk) {
+            if (void* memory = allocateFrom(newest, bytes, alignment)) return memory;
+        }
+        return allocateFrom(addChunk(bytes + alignment), bytes, alignment);
+    }
+
+    void* LinearArena::allocateFrom(Chunk* chunk, size_t bytes, size_t alignment) {
+        uintptr_t base = reinterpret_cast<uintptr_t>(chunk->getData());
+        size_t used = chunk->used.load(std::memory_order_relaxed);
+        while (true) {
+            uintptr_t start = (base + used + alignment - 1) & ~(uintptr_t)(alignment - 1);
+            size_t newUsed = start - base + bytes;
+            if (newUsed > chunk->capacity) return nullptr;
+            if (chunk->used.compare_exchange_weak(used, newUsed, std::memory_order_relaxed)) return reinterpret_cast<void*>(start);
+        }
+    }
+
+    LinearArena::Chunk* LinearArena::addChunk(size_t minCapacity) {
+        size_t capacity = std::max(chunkSize, minCapacity);
+        void* memory = upstream->allocate(sizeof(Chunk) + capacity, alignof(Chunk));
+
+        Chunk* chunk = new (memory) Chunk();
+        chunk->previous = current.load(std::memory_order_relaxed);
+        chunk->capacity = capacity;
+        current.store(chunk, std::memory_order_release);
+        chunkAllocationCount.fetch_add(1, std::memory_order_relaxed);
+        return chunk;
+    }
+
+    void LinearArena::freeChunks(Chunk* chunk) {
+        while (chunk) {
+            Chunk* previous = chunk->previous;
+            size_t capacity = chunk->capacity;
+            chunk->~Chunk();
+            upstream->deallocate(chunk, sizeof(Chunk) + capacity, alignof(Chunk));
+            chunk = previous;
+        }
+    }
+
+}
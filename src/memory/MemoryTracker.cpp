@@ -0,0 +1,334 @@
+#include <frag/memory/MemoryTracker.h>
+
+#include <cstdint>
+#include <cstdlib>
+#include <array>
+#include <atomic>
+#include <format>
+#include <iterator>
+#include <mutex>
+#include <new>
+#include <string>
+
+#include <frag/Log.h>
+
+namespace frag {
+
+    const char* getMemoryTagName(MemoryTag tag) {
+        switch (tag) {
+            case MemoryTag::USER: return "user";
+            case MemoryTag::CORE: return "core";
+            case MemoryTag::LOGGER: return "logger";
+            case MemoryTag::GLOBAL: return "global";
+            case MemoryTag::PACKAGE: return "package";
+            case MemoryTag::ASSET: return "asset";
+            case MemoryTag::RENDER: return "render";
+            default: return "unknown";
+        }
+    }
+
+#if FRAG_MEMORY_TRACKING
+
+    namespace {
+        // In front of every allocation, the pointer handed out is right after it
+        struct AllocationHeader {
+            size_t size;
+            uint32_t offset;    // From the start of the malloc block to the pointer handed out
+            MemoryTag tag;
+        };
+        constexpr size_t HEADER_SPACE = (sizeof(AllocationHeader) + __STDCPP_DEFAULT_NEW_ALIGNMENT__ - 1)
+            / __STDCPP_DEFAULT_NEW_ALIGNMENT__ * __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+
+        // Only ever written by one thread, so a plain load + store is enough. Other threads only read them.
+        struct TagCounters {
+            std::atomic<uint64_t> allocatedBytes = 0;
+            std::atomic<uint64_t> freedBytes = 0;
+            std::atomic<uint64_t> allocations = 0;
+            std::atomic<uint64_t> frees = 0;
+        };
+
+        // One per thread. When a thread ends its counters are handed to the next new thread (they keep their values,
+        // only the sums matter), so threads that come and go don't add up.
+        struct alignas(64) ThreadCounters {
+            TagCounters tags[MEMORY_TAG_COUNT];
+            ThreadCounters* next = nullptr;
+            std::atomic<bool> inUse = true;
+        };
+
+        std::atomic<ThreadCounters*> allThreadCounters = nullptr;
+        // For allocations of threads whose thread_locals are already destroyed, the only ones that need fetch_add
+        ThreadCounters exitedThreadCounters;
+
+        thread_local ThreadCounters* threadCounters = nullptr;
+        thread_local bool threadExited = false;
+
+        struct ThreadExitGuard {
+            bool active = false;
+            ~ThreadExitGuard() {
+                if (threadCounters) threadCounters->inUse.store(false, std::memory_order_release);
+                threadCounters = nullptr;
+                threadExited = true;
+            }
+        };
+        thread_local ThreadExitGuard threadExitGuard;
+
+        ThreadCounters* claimThreadCounters() {
+            for (ThreadCounters* counters = allThreadCounters.load(std::memory_order_acquire); counters; counters = counters->next) {
+                bool expected = false;
+                if (!counters->inUse.load(std::memory_order_relaxed)
+                    && counters->inUse.compare_exchange_strong(expected, true, std::memory_order_acquire)) return counters;
+            }
+
+            // malloc, operator new would end up right back here. Never freed, the counters are needed until the end.
+            void* memory = std::malloc(sizeof(ThreadCounters) + alignof(ThreadCounters));
+            if (!memory) return nullptr;
+            uintptr_t aligned = (reinterpret_cast<uintptr_t>(memory) + alignof(ThreadCounters) - 1) & ~(uintptr_t)(alignof(ThreadCounters) - 1);
+            ThreadCounters* counters = new (reinterpret_cast<void*>(aligned)) ThreadCounters();
+
+            ThreadCounters* head = allThreadCounters.load(std::memory_order_relaxed);
+            do {
+                counters->next = head;
+            } while (!allThreadCounters.compare_exchange_weak(head, counters, std::memory_order_release, std::memory_order_relaxed));
+            return counters;
+        }
+
+        void addTo(std::atomic<uint64_t>& counter, uint64_t value, bool shared) {
+            if (shared) counter.fetch_add(value, std::memory_order_relaxed);
+            else counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+        }
+
+        void count(MemoryTag tag, size_t size, bool allocation) {
+            ThreadCounters* counters = threadCounters;
+            if (!counters && !threadExited) {
+                counters = claimThreadCounters();
+                threadCounters = counters;
+                threadExitGuard.active = true; // Makes sure the guard exists, so the counters are handed back
+            }
+            bool shared = !counters;
+            if (shared) counters = &exitedThreadCounters;
+
+            TagCounters& tagCounters = counters->tags[(size_t)tag];
+            if (allocation) {
+                addTo(tagCounters.allocatedBytes, size, shared);
+                addTo(tagCounters.allocations, 1, shared);
+            }
+            else {
+                addTo(tagCounters.freedBytes, size, shared);
+                addTo(tagCounters.frees, 1, shared);
+            }
+        }
+
+        void* trackedAllocate(size_t size, size_t alignment) {
+            size_t padding = alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__ ? alignment - 1 : 0;
+            // The header and padding would wrap the size around to a tiny block, the throwing overloads turn this into bad_alloc
+            if (size > SIZE_MAX - HEADER_SPACE - padding) return nullptr;
+
+            void* memory;
+            while (!(memory = std::malloc(size + HEADER_SPACE + padding))) {
+                std::new_handler handler = std::get_new_handler();
+                if (!handler) return nullptr;
+                handler();
+            }
+
+            uintptr_t start = reinterpret_cast<uintptr_t>(memory) + HEADER_SPACE;
+            if (padding) start = (start + padding) & ~(uintptr_t)padding;
+
+            MemoryTag tag = detail::currentMemoryTag;
+            AllocationHeader* header = reinterpret_cast<AllocationHeader*>(start) - 1;
+            header->size = size;
+            header->offset = (uint32_t)(start - reinterpret_cast<uintptr_t>(memory));
+            header->tag = tag;
+
+            count(tag, size, true);
+            return reinterpret_cast<void*>(start);
+        }
+
+        void trackedFree(void* pointer) {
+            if (!pointer) return;
+
+            AllocationHeader* header = static_cast<AllocationHeader*>(pointer) - 1;
+            count(header->tag, header->size, false);
+            std::free(static_cast<std::byte*>(pointer) - header->offset);
+        }
+
+        struct TagTotals {
+            uint64_t allocatedBytes = 0;
+            uint64_t freedBytes = 0;
+            uint64_t allocations = 0;
+            uint64_t frees = 0;
+        };
+
+        std::array<TagTotals, MEMORY_TAG_COUNT> sumCounters() {
+            std::array<TagTotals, MEMORY_TAG_COUNT> totals;
+            auto add = [&](const ThreadCounters& counters) {
+                for (size_t i = 0; i < MEMORY_TAG_COUNT; i++) {
+                    totals[i].allocatedBytes += counters.tags[i].allocatedBytes.load(std::memory_order_relaxed);
+                    totals[i].freedBytes += counters.tags[i].freedBytes.load(std::memory_order_relaxed);
+                    totals[i].allocations += counters.tags[i].allocations.load(std::memory_order_relaxed);
+                    totals[i].frees += counters.tags[i].frees.load(std::memory_order_relaxed);
+                }
+            };
+            for (ThreadCounters* counters = allThreadCounters.load(std::memory_order_acquire); counters; counters = counters->next) add(*counters);
+            add(exitedThreadCounters);
+            return totals;
+        }
+
+        // Peaks and per frame values, only touched when the stats are read or a frame ends
+        struct FrameState {
+            std::mutex mutex;
+            uint64_t peakBytes[MEMORY_TAG_COUNT] = {};
+            uint64_t frameStartAllocations[MEMORY_TAG_COUNT] = {};
+            uint64_t frameStartBytes[MEMORY_TAG_COUNT] = {};
+            uint64_t lastFrameAllocations[MEMORY_TAG_COUNT] = {};
+            uint64_t lastFrameBytes[MEMORY_TAG_COUNT] = {};
+            uint64_t frameCount = 0;
+            uint32_t reportInterval = 0;
+        };
+        FrameState frameState;
+
+        // Expects the mutex of frameState to be locked
+        MemorySnapshot takeSnapshot(bool endFrame) {
+            std::array<TagTotals, MEMORY_TAG_COUNT> totals = sumCounters();
+
+            MemorySnapshot snapshot;
+            for (size_t i = 0; i < MEMORY_TAG_COUNT; i++) {
+                const TagTotals& tag = totals[i];
+                if (endFrame) {
+                    frameState.lastFrameAllocations[i] = tag.allocations - frameState.frameStartAllocations[i];
+                    frameState.lastFrameBytes[i] = tag.allocatedBytes - frameState.frameStartBytes[i];
+                    frameState.frameStartAllocations[i] = tag.allocations;
+                    frameState.frameStartBytes[i] = tag.allocatedBytes;
+                }
+
+                // A free on one thread can be counted before the allocation on another one, live values never go below zero
+                MemoryTagStats& stats = snapshot[i];
+                stats.liveBytes = tag.allocatedBytes > tag.freedBytes ? tag.allocatedBytes - tag.freedBytes : 0;
+                stats.liveAllocations = tag.allocations > tag.frees ? tag.allocations - tag.frees : 0;
+                stats.totalAllocations = tag.allocations;
+                stats.frameAllocations = frameState.lastFrameAllocations[i];
+                stats.frameBytes = frameState.lastFrameBytes[i];
+
+                if (stats.liveBytes > frameState.peakBytes[i]) frameState.peakBytes[i] = stats.liveBytes;
+                stats.peakBytes = frameState.peakBytes[i];
+            }
+            return snapshot;
+        }
+
+        std::string formatBytes(size_t bytes) {
+            if (bytes >= 1024 * 1024) return std::format("{:.1f}MiB", bytes / (1024.0 * 1024.0));
+            if (bytes >= 1024) return std::format("{:.1f}KiB", bytes / 1024.0);
+            return std::format("{}B", bytes);
+        }
+    }
+
+    // ------------------------------------
+    // -- Public Methods Implementation --
+    // ------------------------------------
+
+    MemoryLeakCheck::MemoryLeakCheck() : baseline(memory_getAllStats()) {}
+
+    MemoryLeakCheck::~MemoryLeakCheck() {
+        MemorySnapshot snapshot = memory_getAllStats();
+
+        bool leaked = false;
+        for (size_t i = 0; i < MEMORY_TAG_COUNT; i++) {
+            if ((MemoryTag)i == MemoryTag::LOGGER || (MemoryTag)i == MemoryTag::GLOBAL) continue;
+            if (snapshot[i].liveBytes <= baseline[i].liveBytes) continue;
+
+            leaked = true;
+            logWarn(LogChannel::CORE, "Memory leak check: '{}' still holds {} in {} allocation(s) more than when the Core was created.",
+                getMemoryTagName((MemoryTag)i), formatBytes(snapshot[i].liveBytes - baseline[i].liveBytes),
+                snapshot[i].liveAllocations > baseline[i].liveAllocations ? snapshot[i].liveAllocations - baseline[i].liveAllocations : 0);
+        }
+        if (!leaked) logDebug(LogChannel::CORE, "Memory leak check: nothing left behind.");
+    }
+
+    MemoryTagStats memory_getStats(MemoryTag tag) {
+        return memory_getAllStats()[(size_t)tag];
+    }
+
+    MemorySnapshot memory_getAllStats() {
+        std::lock_guard lock(frameState.mutex);
+        return takeSnapshot(false);
+    }
+
+    void memory_endFrame() {
+        bool report;
+        {
+            std::lock_guard lock(frameState.mutex);
+            takeSnapshot(true);
+            frameState.frameCount++;
+            report = frameState.reportInterval > 0 && frameState.frameCount % frameState.reportInterval == 0;
+        }
+        if (report) memory_logReport();
+    }
+
+    void memory_setReportInterval(uint32_t frames) {
+        std::lock_guard lock(frameState.mutex);
+        frameState.reportInterval = frames;
+    }
+
+    void memory_logReport() {
+        MemorySnapshot snapshot = memory_getAllStats();
+
+        std::string line;
+        for (size_t i = 0; i < MEMORY_TAG_COUNT; i++) {
+            const MemoryTagStats& stats = snapshot[i];
+            if (!line.empty()) line += " | ";
+            std::format_to(std::back_inserter(line), "{} {} (peak {}, {} allocs/frame)", getMemoryTagName((MemoryTag)i),
+                formatBytes(stats.liveBytes), formatBytes(stats.peakBytes), stats.frameAllocations);
+        }
+        logInfo(LogChannel::CORE, "Memory: {}", line);
+    }
+
+#endif
+
+}
+
+#if FRAG_MEMORY_TRACKING
+
+// -- Global operator new / delete, every allocation of the process goes through the tracker --
+
+void* operator new(std::size_t size) {
+    void* memory = frag::trackedAllocate(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+    if (!memory) throw std::bad_alloc();
+    return memory;
+}
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return frag::trackedAllocate(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return frag::trackedAllocate(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    void* memory = frag::trackedAllocate(size, (size_t)alignment);
+    if (!memory) throw std::bad_alloc();
+    return memory;
+}
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+    return operator new(size, alignment);
+}
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return frag::trackedAllocate(size, (size_t)alignment);
+}
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return frag::trackedAllocate(size, (size_t)alignment);
+}
+
+void operator delete(void* pointer) noexcept { frag::trackedFree(pointer); }
+void operator delete[](void* pointer) noexcept { frag::trackedFree(pointer); }
+void operator delete(void* pointer, std::size_t) noexcept { frag::trackedFree(pointer); }
+void operator delete[](void* pointer, std::size_t) noexcept { frag::trackedFree(pointer); }
+void operator delete(void* pointer, const std::nothrow_t&) noexcept { frag::trackedFree(pointer); }
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept { frag::trackedFree(pointer); }
+void operator delete(void* pointer, std::align_val_t) noexcept { frag::trackedFree(pointer); }
+void operator delete[](void* pointer, std::align_val_t) noexcept { frag::trackedFree(pointer); }
+void operator delete(void* pointer, std::size_t, std::align_val_t) noexcept { frag::trackedFree(pointer); }
+void operator delete[](void* pointer, std::size_t, std::align_val_t) noexcept { frag::trackedFree(pointer); }
+void operator delete(void* pointer, std::align_val_t, const std::nothrow_t&) noexcept { frag::trackedFree(pointer); }
+void operator delete[](void* pointer, std::align_val_t, const std::nothrow_t&) noexcept { frag::trackedFree(pointer); }
+
+#endif
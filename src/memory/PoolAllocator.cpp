@@ -0,0 +1,99 @@
+#include <frag/memory/PoolAllocator.h>
+
+#include <algorithm>
+#include <bit>
+
+namespace frag {
+
+    // ------------------------------------
+    // -- Public Methods Implementation --
+    // ------------------------------------
+
+    FixedBlockPool::FixedBlockPool(size_t blockSize, size_t blockAlignment, size_t blocksPerChunk, std::pmr::memory_resource* upstream)
+        : upstream(upstream), blockAlignment(std::max(blockAlignment, alignof(FreeBlock))), blocksPerChunk(std::max<size_t>(blocksPerChunk, 1)) {
+        // Every block has to fit a free list entry and keep the next block aligned
+        size_t size = std::max(blockSize, sizeof(FreeBlock));
+        this->blockSize = (size + this->blockAlignment - 1) / this->blockAlignment * this->blockAlignment;
+    }
+
+    FixedBlockPool::~FixedBlockPool() {
+        for (void* chunk : chunks) upstream->deallocate(chunk, blockSize * blocksPerChunk, blockAlignment);
+    }
+
+    void* FixedBlockPool::allocate() {
+        std::lock_guard lock(mutex);
+        if (!freeList) addChunk();
+
+        FreeBlock* block = freeList;
+        freeList = block->next;
+        usedBlocks++;
+        return block;
+    }
+
+    void FixedBlockPool::deallocate(void* block) {
+        if (!block) return;
+
+        std::lock_guard lock(mutex);
+        freeList = new (block) FreeBlock{ freeList };
+        usedBlocks--;
+    }
+
+    size_t FixedBlockPool::getUsedBlocks() const {
+        std::lock_guard lock(mutex);
+        return usedBlocks;
+    }
+
+    size_t FixedBlockPool::getCapacity() const {
+        std::lock_guard lock(mutex);
+        return chunks.size() * blocksPerChunk;
+    }
+
+    PoolResource::PoolResource(size_t blocksPerChunk, std::pmr::memory_resource* upstream) : upstream(upstream) {
+        for (size_t i = 0; i < CLASS_COUNT; i++) {
+            size_t blockSize = MIN_BLOCK_SIZE << i;
+            pools[i] = std::make_unique<FixedBlockPool>(blockSize, MIN_BLOCK_SIZE, blocksPerChunk, upstream);
+        }
+    }
+
+    size_t PoolResource::getUsedBlocks() const {
+        size_t used = 0;
+        for (const auto& pool : pools) used += pool->getUsedBlocks();
+        return used;
+    }
+
+
+
+    // -------------------------------------
+    // -- Private Methods Implementation --
+    // -------------------------------------
+
+    void FixedBlockPool::addChunk() {
+        std::byte* chunk = static_cast<std::byte*>(upstream->allocate(blockSize * blocksPerChunk, blockAlignment));
+        chunks.push_back(chunk);
+
+        // Linked back to front, so the blocks are handed out in address order
+        for (size_t i = blocksPerChunk; i-- > 0;) {
+            freeList = new (chunk + i * blockSize) FreeBlock{ freeList };
+        }
+    }
+
+    void* PoolResource::do_allocate(size_t bytes, size_t alignment) {
+        int sizeClass = getSizeClass(bytes, alignment);
+        if (sizeClass < 0) return upstream->allocate(bytes, alignment);
+        return pools[sizeClass]->allocate();
+    }
+
+    void PoolResource::do_deallocate(void* memory, size_t bytes, size_t alignment) {
+        int sizeClass = getSizeClass(bytes, alignment);
+        if (sizeClass < 0) upstream->deallocate(memory, bytes, alignment);
+        else pools[sizeClass]->deallocate(memory);
+    }
+
+    int PoolResource::getSizeClass(size_t bytes, size_t alignment) {
+        if (bytes > MAX_BLOCK_SIZE || alignment > MIN_BLOCK_SIZE) return -1;
+        // 16 -> 0, 17..32 -> 1, ..., 129..256 -> 4
+        size_t size = std::max(bytes, MIN_BLOCK_SIZE);
+        return std::bit_width(size - 1) - std::bit_width(MIN_BLOCK_SIZE - 1);
+    }
+
+}
@@ -1,7 +1,304 @@
 #include <frag/package/IPackage.h>
 
+#include <cstdio>
+#include <cstring>
+#include <array>
+#include <format>
+#include <system_error>
+
 namespace frag {
 
-    
+    /*
+        Snapshot file layout (native byte order, checked with BYTE_ORDER_MARK):
+            SnapshotHeader
+            Sections, every one aligned to SECTION_ALIGNMENT, in the order of the Section enum
+        The frozen tables are written exactly as they are in memory, so loading them is just pointing into the file.
+    */
+    namespace {
+        constexpr char SNAPSHOT_MAGIC[8] = { 'F', 'R', 'A', 'G', 'P', 'K', 'G', '\0' };
+        constexpr uint32_t SNAPSHOT_FORMAT_VERSION = 1;
+        constexpr uint32_t BYTE_ORDER_MARK = 0x01020304;
+        constexpr size_t SECTION_ALIGNMENT = 16;
+
+        enum Section : uint32_t {
+            STRING_ARENA,
+            GAME_STATE_ENTRIES, GAME_STATE_SEEDS, GAME_STATE_SLOTS,
+            ASSET_ENTRIES, ASSET_SEEDS, ASSET_SLOTS,
+            COMPONENT_ENTRIES, COMPONENT_SEEDS, COMPONENT_SLOTS,
+            SECTION_COUNT
+        };
+
+        struct SnapshotSection {
+            uint64_t offset;
+            uint64_t size; // In bytes
+        };
+
+        struct SnapshotHeader {
+            char magic[8];
+            uint32_t formatVersion;
+            uint32_t byteOrderMark;
+            uint64_t snapshotVersion;
+            uint64_t packageHash;
+            uint32_t packageNameOffset;   // StringRef into the arena
+            uint32_t packageNameLength;
+            uint32_t entrySizes[3];       // sizeof the Entry of every table, catches layout changes
+            uint32_t reserved;
+            uint64_t fileSize;
+            uint64_t checksum;            // computeChecksum of everything after the header
+            SnapshotSection sections[SECTION_COUNT];
+        };
+
+        // FNV-1a style, but 8 bytes per step. Byte wise FNV-1a takes ~10ms for a 10MB snapshot.
+        uint64_t computeChecksum(std::string_view data) {
+            uint64_t hash = FRAG_HASH_OFFSET_BASIS;
+            size_t i = 0;
+            for (; i + 8 <= data.size(); i += 8) {
+                uint64_t word;
+                std::memcpy(&word, data.data() + i, sizeof(word));
+                hash = (hash ^ word) * FRAG_HASH_PRIME;
+                hash ^= hash >> 29;
+            }
+            return fragHashAppend(hash, data.substr(i));
+        }
+
+        template<typename T>
+        bool isSectionValid(const SnapshotHeader& header, Section section, size_t fileSize) {
+            const SnapshotSection& info = header.sections[section];
+            return info.offset % SECTION_ALIGNMENT == 0 && info.offset >= sizeof(SnapshotHeader) && info.offset <= fileSize
+                && info.size <= fileSize - info.offset && info.size % sizeof(T) == 0;
+        }
+
+        template<typename T>
+        std::span<const T> getSection(const MappedFile& file, const SnapshotHeader& header, Section section) {
+            const SnapshotSection& info = header.sections[section];
+            return std::span<const T>(reinterpret_cast<const T*>(file.getData() + info.offset), info.size / sizeof(T));
+        }
+    }
+
+    // ------------------------------------
+    // -- Public Methods Implementation --
+    // ------------------------------------
+
+    bool IPackage::saveSnapshot(const std::filesystem::path& path) const {
+        FRAG_PROFILE_ZONE("IPackage::saveSnapshot");
+
+        if (!packageIsSetup) {
+            logWarn(LogChannel::PACKAGE, "Package {} is not setup yet, cannot save a snapshot.", packageName);
+            return false;
+        }
+
+        std::array<std::span<const std::byte>, SECTION_COUNT> sections = {
+            std::as_bytes(std::span(stringArena.getData())),
+            std::as_bytes(frozenGameStates.getEntries()), std::as_bytes(frozenGameStates.getSeeds()), std::as_bytes(frozenGameStates.getSlots()),
+            std::as_bytes(frozenAssets.getEntries()), std::as_bytes(frozenAssets.getSeeds()), std::as_bytes(frozenAssets.getSlots()),
+            std::as_bytes(frozenComponents.getEntries()), std::as_bytes(frozenComponents.getSeeds()), std::as_bytes(frozenComponents.getSlots()),
+        };
+
+        SnapshotHeader header = {};
+        std::memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+        header.formatVersion = SNAPSHOT_FORMAT_VERSION;
+        header.byteOrderMark = BYTE_ORDER_MARK;
+        header.snapshotVersion = getSnapshotVersion();
+        header.packageHash = packageHash;
+        header.packageNameOffset = packageNameRef.offset;
+        header.packageNameLength = packageNameRef.length;
+        header.entrySizes[0] = sizeof(FrozenTable<frozenGameState>::Entry);
+        header.entrySizes[1] = sizeof(FrozenTable<frozenAsset>::Entry);
+        header.entrySizes[2] = sizeof(FrozenTable<frozenComponent>::Entry);
+
+        // Everything after the header goes into one buffer, so the checksum is computed in one go
+        std::string body;
+        for (size_t i = 0; i < SECTION_COUNT; i++) {
+            size_t offset = (sizeof(SnapshotHeader) + body.size() + SECTION_ALIGNMENT - 1) / SECTION_ALIGNMENT * SECTION_ALIGNMENT;
+            body.resize(offset - sizeof(SnapshotHeader), '\0');
+            header.sections[i].offset = offset;
+            header.sections[i].size = sections[i].size();
+            body.append(reinterpret_cast<const char*>(sections[i].data()), sections[i].size());
+        }
+        header.fileSize = sizeof(SnapshotHeader) + body.size();
+        header.checksum = computeChecksum(body);
+
+        // Written to a temporary file first, so a crash never leaves a half written snapshot behind
+        std::error_code error;
+        if (path.has_parent_path()) std::filesystem::create_directories(path.parent_path(), error);
+
+        std::filesystem::path tempPath = path;
+        tempPath += ".tmp";
+        std::FILE* file = std::fopen(tempPath.string().c_str(), "wb");
+        if (!file) {
+            logError(LogChannel::PACKAGE, "Cannot write package snapshot '{}'.", tempPath.string());
+            return false;
+        }
+
+        bool written = std::fwrite(&header, sizeof(header), 1, file) == 1;
+        written = std::fwrite(body.data(), 1, body.size(), file) == body.size() && written;
+        written = std::fclose(file) == 0 && written;
+
+        if (written) std::filesystem::rename(tempPath, path, error);
+        if (!written || error) {
+            logError(LogChannel::PACKAGE, "Cannot write package snapshot '{}'.", path.string());
+            std::filesystem::remove(tempPath, error);
+            return false;
+        }
+
+        logDebug(LogChannel::PACKAGE, "Saved snapshot of package {} ({} bytes).", packageName, header.fileSize);
+        return true;
+    }
+
+    bool IPackage::loadSnapshot(const std::filesystem::path& path) {
+        FRAG_PROFILE_ZONE("IPackage::loadSnapshot");
+
+        if (packageIsSetup || packageNameSet) {
+            logWarn(LogChannel::PACKAGE, "Package {} is already setup, cannot load a snapshot into it.", packageName);
+            return false;
+        }
+
+        MappedFile file;
+        if (!file.open(path)) return false; // No snapshot yet, nothing to complain about
+
+        auto reject = [&](std::string_view reason) {
+            logDebug(LogChannel::PACKAGE, "Package snapshot '{}' is not used: {}.", path.string(), reason);
+            return false;
+        };
+
+        if (file.getSize() < sizeof(SnapshotHeader)) return reject("too small");
+        SnapshotHeader header;
+        std::memcpy(&header, file.getData(), sizeof(header));
+
+        if (std::memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic)) != 0) return reject("not a package snapshot");
+        if (header.byteOrderMark != BYTE_ORDER_MARK) return reject("written on a machine with another byte order");
+        if (header.formatVersion != SNAPSHOT_FORMAT_VERSION) return reject("other snapshot format version");
+        if (header.snapshotVersion != getSnapshotVersion()) return reject("other package snapshot version");
+        if (header.fileSize != file.getSize()) return reject("wrong file size");
+        if (header.entrySizes[0] != sizeof(FrozenTable<frozenGameState>::Entry)
+            || header.entrySizes[1] != sizeof(FrozenTable<frozenAsset>::Entry)
+            || header.entrySizes[2] != sizeof(FrozenTable<frozenComponent>::Entry)) return reject("written by another engine build");
+
+        std::string_view body(reinterpret_cast<const char*>(file.getData()) + sizeof(SnapshotHeader), file.getSize() - sizeof(SnapshotHeader));
+        if (computeChecksum(body) != header.checksum) return reject("checksum mismatch");
+
+        bool sectionsValid = isSectionValid<char>(header, STRING_ARENA, file.getSize())
+            && isSectionValid<FrozenTable<frozenGameState>::Entry>(header, GAME_STATE_ENTRIES, file.getSize())
+            && isSectionValid<FrozenTable<frozenAsset>::Entry>(header, ASSET_ENTRIES, file.getSize())
+            && isSectionValid<FrozenTable<frozenComponent>::Entry>(header, COMPONENT_ENTRIES, file.getSize());
+        for (Section section : { GAME_STATE_SEEDS, GAME_STATE_SLOTS, ASSET_SEEDS, ASSET_SLOTS, COMPONENT_SEEDS, COMPONENT_SLOTS }) {
+            sectionsValid = sectionsValid && isSectionValid<uint32_t>(header, section, file.getSize());
+        }
+        if (!sectionsValid) return reject("broken section table");
+
+        // Everything gets checked on local tables first, the package itself is only touched once all of it is fine
+        StringArena arena;
+        arena.setView(std::string_view(reinterpret_cast<const char*>(file.getData() + header.sections[STRING_ARENA].offset), header.sections[STRING_ARENA].size));
+
+        StringArena::StringRef nameRef = { header.packageNameOffset, header.packageNameLength };
+        if (!arena.isValid(nameRef)) return reject("broken package name");
+        std::string_view name = arena.get(nameRef);
+        if (!name.starts_with("p:") || fragHash(name.substr(2)) != header.packageHash) return reject("broken package name");
+
+        FrozenTable<frozenGameState> gameStates;
+        FrozenTable<frozenAsset> assets;
+        FrozenTable<frozenComponent> snapshotComponents;
+        bool tablesValid = gameStates.setView(getSection<FrozenTable<frozenGameState>::Entry>(file, header, GAME_STATE_ENTRIES),
+                getSection<uint32_t>(file, header, GAME_STATE_SEEDS), getSection<uint32_t>(file, header, GAME_STATE_SLOTS))
+            && assets.setView(getSection<FrozenTable<frozenAsset>::Entry>(file, header, ASSET_ENTRIES),
+                getSection<uint32_t>(file, header, ASSET_SEEDS), getSection<uint32_t>(file, header, ASSET_SLOTS))
+            && snapshotComponents.setView(getSection<FrozenTable<frozenComponent>::Entry>(file, header, COMPONENT_ENTRIES),
+                getSection<uint32_t>(file, header, COMPONENT_SEEDS), getSection<uint32_t>(file, header, COMPONENT_SLOTS));
+        if (!tablesValid) return reject("broken tables");
+
+        for (const auto& entry : gameStates.getEntries()) {
+            if (!arena.isValid(entry.value.name)) return reject("broken string reference");
+        }
+        for (const auto& entry : assets.getEntries()) {
+            if (!arena.isValid(entry.value.name) || !arena.isValid(entry.value.path)) return reject("broken string reference");
+        }
+        for (const auto& entry : snapshotComponents.getEntries()) {
+            if (!arena.isValid(entry.value.name)) return reject("broken string reference");
+        }
+
+        // ComponentIds depend on the registration order of this run, so the types get registered and the ids looked up by name
+        packageName = std::string(name);
+        loadingSnapshot = true;
+        setupComponents();
+        loadingSnapshot = false;
+
+        std::vector<FrozenTable<frozenComponent>::Entry> components(snapshotComponents.getEntries().begin(), snapshotComponents.getEntries().end());
+        for (auto& entry : components) {
+            entry.value.id = findComponentId(arena.get(entry.value.name));
+            if (entry.value.id == INVALID_COMPONENT_ID) {
+                packageName.clear();
+                return reject(std::format("component '{}' is not registered by setupComponents", arena.get(entry.value.name)));
+            }
+        }
+
+        snapshotFile = std::move(file); // The mapping stays the same, the views above stay valid
+        stringArena.setView(arena.getData());
+        frozenGameStates.setView(gameStates.getEntries(), gameStates.getSeeds(), gameStates.getSlots());
+        frozenAssets.setView(assets.getEntries(), assets.getSeeds(), assets.getSlots());
+        frozenComponents.build(std::move(components));
+
+        packageHash = header.packageHash;
+        packageNameRef = nameRef;
+        packageNameSet = true;
+        packageIsSetup = true;
+
+        logDebug(LogChannel::PACKAGE, "Loaded package {} from snapshot '{}'.", packageName, path.string());
+        return true;
+    }
+
+    void IPackage::setupWithSnapshot(const std::filesystem::path& path) {
+        if (loadSnapshot(path)) return;
+
+        setupPackage();
+        if (!packageIsSetup) finishPackage();
+        if (packageIsSetup) saveSnapshot(path);
+    }
+
+
+
+    // -------------------------------------
+    // -- Private Methods Implementation --
+    // -------------------------------------
+
+    void IPackage::freezeRegistries() {
+        packageNameRef = stringArena.add(packageName);
+
+        std::vector<FrozenTable<frozenGameState>::Entry> gameStates;
+        gameStates.reserve(registeredGameStates.size());
+        for (const auto& [key, name] : registeredGameStates) {
+            gameStates.push_back({ key, { stringArena.add(name) } });
+        }
+
+        std::vector<FrozenTable<frozenAsset>::Entry> assets;
+        assets.reserve(registeredAssets.size());
+        for (const auto& [key, asset] : registeredAssets) {
+            frozenAsset frozen;
+            frozen.type = asset.type;
+            frozen.name = stringArena.add(asset.name);
+            frozen.path = stringArena.add(asset.path.generic_string());
+            assets.push_back({ key, frozen });
+        }
+
+        std::vector<FrozenTable<frozenComponent>::Entry> components;
+        components.reserve(registeredComponents.size());
+        for (const auto& [key, component] : registeredComponents) {
+            components.push_back({ key, { stringArena.add(component.name), component.id } });
+        }
+
+        // The keys come out of maps, so they are unique and build can't fail
+        frozenGameStates.build(std::move(gameStates));
+        frozenAssets.build(std::move(assets));
+        frozenComponents.build(std::move(components));
+        stringArena.shrinkToFit();
+
+        // Not needed anymore, give the nodes back
+        registeredGameStates = {};
+        registeredAssets = {};
+        registeredComponents = {};
+
+        logDebug(LogChannel::PACKAGE, "Package {} frozen: {} game states, {} assets, {} components, {} bytes.", packageName,
+            frozenGameStates.size(), frozenAssets.size(), frozenComponents.size(),
+            frozenGameStates.getMemoryUsage() + frozenAssets.getMemoryUsage() + frozenComponents.getMemoryUsage() + stringArena.getSize());
+    }
 
-}
\ No newline at end of file
+}
@@ -0,0 +1,275 @@
+#include <frag/package/PackageRegistry.h>
+
+#include <unordered_map>
+#include <algorithm>
+#include <chrono>
+
+#include <frag/Log.h>
+#include <frag/profile/Profiler.h>
+#include <frag/memory/MemoryTracker.h>
+
+namespace frag {
+
+    // ------------------------------------
+    // -- Public Methods Implementation --
+    // ------------------------------------
+
+    void PackageRegistry::addPackage(std::string_view name, std::unique_ptr<IPackage> package, std::vector<std::string> dependencies) {
+        if (loaded) {
+            logError(LogChannel::PACKAGE, "Packages are already loaded, cannot add package '{}'.", name);
+            return;
+        }
+        if (!package) {
+            logError(LogChannel::PACKAGE, "Cannot add package '{}', it is null.", name);
+            return;
+        }
+
+        MemoryTagScope memoryTag(MemoryTag::PACKAGE);
+        auto slot = std::make_unique<PackageSlot>();
+        slot->name = std::string(name);
+        slot->hash = fragHash(name);
+        slot->package = std::move(package);
+        slot->dependencyNames = std::move(dependencies);
+        packages.push_back(std::move(slot));
+    }
+
+    void PackageRegistry::setSnapshotDirectory(std::filesystem::path directory) {
+        snapshotDirectory = std::move(directory);
+    }
+
+    bool PackageRegistry::loadPackages(JobSystem& jobSystem) {
+        FRAG_PROFILE_ZONE("PackageRegistry::loadPackages");
+        MemoryTagScope memoryTag(MemoryTag::PACKAGE);
+
+        if (loaded) {
+            logWarn(LogChannel::PACKAGE, "Packages are already loaded.");
+            return true;
+        }
+        auto startTime = std::chrono::steady_clock::now();
+
+        bool allValid = resolveDependencies();
+
+        // Everything without (valid) dependencies starts right away, the rest gets started by its last dependency
+        JobCounter counter;
+        for (size_t i = 0; i < packages.size(); i++) {
+            PackageSlot& slot = *packages[i];
+            if (!slot.failed.load(std::memory_order_relaxed) && slot.remainingDependencies.load(std::memory_order_relaxed) == 0) {
+                startPackage(i, jobSystem, counter);
+            }
+        }
+        jobSystem.wait(counter);
+
+        size_t loadedCount = 0;
+        for (const auto& slot : packages) {
+            slot->loaded = !slot->failed.load(std::memory_order_relaxed) && slot->package->getPackageHash() == slot->hash;
+            if (slot->loaded) loadedCount++;
+        }
+
+        buildIndex();
+        loaded = true;
+
+        logInfo(LogChannel::PACKAGE, "Loaded {} of {} package(s) in {:.2f}ms.", loadedCount, packages.size(),
+            std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count());
+        return allValid && loadedCount == packages.size();
+    }
+
+    IPackage* PackageRegistry::getPackage(FragHash packageHash) const {
+        for (const auto& slot : packages) {
+            if (slot->hash == packageHash && slot->loaded) return slot->package.get();
+        }
+        return nullptr;
+    }
+
+    IPackage* PackageRegistry::getGameStateOwner(FragHash key) const {
+        const IndexEntry* entry = gameStateIndex.find(key);
+        return entry ? packages[entry->packageIndex]->package.get() : nullptr;
+    }
+
+    IPackage* PackageRegistry::getAssetOwner(FragHash key) const {
+        const IndexEntry* entry = assetIndex.find(key);
+        return entry ? packages[entry->packageIndex]->package.get() : nullptr;
+    }
+
+    int PackageRegistry::getAssetType(FragHash key) const {
+        const IndexEntry* entry = assetIndex.find(key);
+        if (!entry) return -1;
+        const IPackage& package = *packages[entry->packageIndex]->package;
+        return package.frozenAssets.getEntries()[entry->entryIndex].value.type;
+    }
+
+    std::string_view PackageRegistry::getAssetPath(FragHash key) const {
+        const IndexEntry* entry = assetIndex.find(key);
+        if (!entry) return std::string_view();
+        const IPackage& package = *packages[entry->packageIndex]->package;
+        return package.stringArena.get(package.frozenAssets.getEntries()[entry->entryIndex].value.path);
+    }
+
+    ComponentId PackageRegistry::getComponentId(FragHash key) const {
+        const IndexEntry* entry = componentIndex.find(key);
+        if (!entry) return INVALID_COMPONENT_ID;
+        const IPackage& package = *packages[entry->packageIndex]->package;
+        return package.frozenComponents.getEntries()[entry->entryIndex].value.id;
+    }
+
+
+
+    // -------------------------------------
+    // -- Private Methods Implementation --
+    // -------------------------------------
+
+    bool PackageRegistry::resolveDependencies() {
+        bool allValid = true;
+
+        std::unordered_map<FragHash, size_t> packageByHash;
+        for (size_t i = 0; i < packages.size(); i++) {
+            PackageSlot& slot = *packages[i];
+            if (!packageByHash.emplace(slot.hash, i).second) {
+                logError(LogChannel::PACKAGE, "Package '{}' was added twice (or collides with '{}'), the second one is skipped.", slot.name, packages[packageByHash[slot.hash]]->name);
+                slot.failed = true;
+                allValid = false;
+            }
+        }
+
+        std::vector<std::vector<size_t>> dependencies(packages.size());
+        for (size_t i = 0; i < packages.size(); i++) {
+            PackageSlot& slot = *packages[i];
+            if (slot.failed) continue;
+
+            for (const std::string& dependencyName : slot.dependencyNames) {
+                auto it = packageByHash.find(fragHash(dependencyName));
+                if (it == packageByHash.end()) {
+                    logError(LogChannel::PACKAGE, "Package '{}' depends on '{}', which was never added. '{}' is skipped.", slot.name, dependencyName, slot.name);
+                    slot.failed = true;
+                    allValid = false;
+                    break;
+                }
+                dependencies[i].push_back(it->second);
+            }
+        }
+
+        // Kahn's algorithm, only to find packages that can never start (cycles, or depending on a skipped package)
+        std::vector<int> remaining(packages.size(), 0);
+        for (size_t i = 0; i < packages.size(); i++) {
+            if (packages[i]->failed) continue;
+            for (size_t dependency : dependencies[i]) {
+                packages[dependency]->dependents.push_back(i);
+                remaining[i]++;
+            }
+        }
+        for (size_t i = 0; i < packages.size(); i++) {
+            packages[i]->remainingDependencies.store(remaining[i], std::memory_order_relaxed);
+        }
+
+        std::vector<size_t> ready;
+        for (size_t i = 0; i < packages.size(); i++) {
+            if (!packages[i]->failed && remaining[i] == 0) ready.push_back(i);
+        }
+        while (!ready.empty()) {
+            size_t index = ready.back();
+            ready.pop_back();
+            for (size_t dependent : packages[index]->dependents) {
+                if (--remaining[dependent] == 0) ready.push_back(dependent);
+            }
+        }
+
+        for (size_t i = 0; i < packages.size(); i++) {
+            if (!packages[i]->failed && remaining[i] > 0) {
+                logError(LogChannel::PACKAGE, "Package '{}' has a cyclic dependency or depends on a skipped package, it is skipped.", packages[i]->name);
+                packages[i]->failed = true;
+                allValid = false;
+            }
+        }
+        return allValid;
+    }
+
+    void PackageRegistry::startPackage(size_t index, JobSystem& jobSystem, JobCounter& counter) {
+        jobSystem.run([this, index, &jobSystem, &counter]() { setupPackage(index, jobSystem, counter); }, &counter);
+    }
+
+    void PackageRegistry::setupPackage(size_t index, JobSystem& jobSystem, JobCounter& counter) {
+        FRAG_PROFILE_ZONE("PackageRegistry::setupPackage");
+        MemoryTagScope memoryTag(MemoryTag::PACKAGE); // Runs on a job thread
+
+        PackageSlot& slot = *packages[index];
+        if (slot.failed.load(std::memory_order_relaxed)) {
+            logError(LogChannel::PACKAGE, "Package '{}' is skipped, one of its dependencies failed.", slot.name);
+            startDependents(index, jobSystem, counter);
+            return;
+        }
+
+        IPackage& package = *slot.package;
+
+        if (snapshotDirectory.empty()) {
+            package.setupPackage();
+            if (!package.packageIsSetup) package.finishPackage();
+        }
+        else {
+            package.setupWithSnapshot(snapshotDirectory / (slot.name + ".fragpkg"));
+        }
+
+        if (!package.packageIsSetup) {
+            logError(LogChannel::PACKAGE, "Package '{}' could not be setup.", slot.name);
+            slot.failed.store(true, std::memory_order_relaxed);
+        }
+        else if (package.getPackageHash() != slot.hash) {
+            logError(LogChannel::PACKAGE, "Package '{}' calls itself '{}', the names given to addPackage and rPackageName have to match.",
+                slot.name, package.getPackageName());
+            slot.failed.store(true, std::memory_order_relaxed);
+        }
+
+        startDependents(index, jobSystem, counter);
+    }
+
+    void PackageRegistry::startDependents(size_t index, JobSystem& jobSystem, JobCounter& counter) {
+        // Dependents of a failed package fail as well, they still get "started" so the failure reaches their dependents too
+        PackageSlot& slot = *packages[index];
+        bool failed = slot.failed.load(std::memory_order_relaxed);
+
+        for (size_t dependent : slot.dependents) {
+            PackageSlot& dependentSlot = *packages[dependent];
+            if (failed) dependentSlot.failed.store(true, std::memory_order_relaxed);
+
+            if (dependentSlot.remainingDependencies.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                startPackage(dependent, jobSystem, counter);
+            }
+        }
+    }
+
+    void PackageRegistry::buildIndex() {
+        FRAG_PROFILE_ZONE("PackageRegistry::buildIndex");
+
+        std::vector<FrozenTable<IndexEntry>::Entry> gameStates;
+        std::vector<FrozenTable<IndexEntry>::Entry> assets;
+        std::vector<FrozenTable<IndexEntry>::Entry> components;
+
+        for (uint32_t packageIndex = 0; packageIndex < packages.size(); packageIndex++) {
+            const PackageSlot& slot = *packages[packageIndex];
+            if (!slot.loaded) continue;
+
+            const IPackage& package = *slot.package;
+            auto gameStateEntries = package.frozenGameStates.getEntries();
+            for (uint32_t i = 0; i < gameStateEntries.size(); i++) gameStates.push_back({ gameStateEntries[i].key, { packageIndex, i } });
+            auto assetEntries = package.frozenAssets.getEntries();
+            for (uint32_t i = 0; i < assetEntries.size(); i++) assets.push_back({ assetEntries[i].key, { packageIndex, i } });
+            auto componentEntries = package.frozenComponents.getEntries();
+            for (uint32_t i = 0; i < componentEntries.size(); i++) components.push_back({ componentEntries[i].key, { packageIndex, i } });
+        }
+
+        // Keys are namespaced by the package hash, so two packages can only collide by an actual hash collision
+        auto build = [this](FrozenTable<IndexEntry>& table, std::vector<FrozenTable<IndexEntry>::Entry>&& entries, std::string_view what) {
+            std::sort(entries.begin(), entries.end(), [](const auto& a, const auto& b) { return a.key < b.key; });
+            auto duplicate = std::unique(entries.begin(), entries.end(), [&](const auto& a, const auto& b) {
+                if (a.key != b.key) return false;
+                logError(LogChannel::PACKAGE, "Hash collision in the global {} index between packages '{}' and '{}', the second one is ignored.",
+                    what, packages[a.value.packageIndex]->name, packages[b.value.packageIndex]->name);
+                return true;
+            });
+            entries.erase(duplicate, entries.end());
+            table.build(std::move(entries));
+        };
+        build(gameStateIndex, std::move(gameStates), "game state");
+        build(assetIndex, std::move(assets), "asset");
+        build(componentIndex, std::move(components), "component");
+    }
+
+}
@@ -0,0 +1,325 @@
+#include <frag/profile/Profiler.h>
+
+#if FRAG_PROFILING
+
+#include <atomic>
+#include <mutex>
+#include <memory>
+#include <chrono>
+#include <algorithm>
+#include <fstream>
+#include <unordered_map>
+#include <string_view>
+
+#include <frag/Log.h>
+#include <frag/memory/MemoryTracker.h>
+
+namespace frag {
+
+    struct ProfileEvent {
+        const char* name;
+        int64_t start;
+        int64_t end;
+    };
+
+    // Written by exactly one thread, read by the thread that ends the frame
+    struct ProfileThreadBuffer {
+        static constexpr size_t CAPACITY = 1 << 14;
+
+        uint32_t threadId = 0;
+        std::string threadName;
+
+        std::unique_ptr<ProfileEvent[]> events = std::make_unique<ProfileEvent[]>(CAPACITY);
+        alignas(64) std::atomic<size_t> writePos = 0;
+        alignas(64) std::atomic<size_t> readPos = 0;
+        std::atomic<uint64_t> droppedEvents = 0;
+
+        void push(const ProfileEvent& event) {
+            size_t write = writePos.load(std::memory_order_relaxed);
+            if (write - readPos.load(std::memory_order_acquire) >= CAPACITY) {
+                droppedEvents.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+
+            events[write & (CAPACITY - 1)] = event;
+            writePos.store(write + 1, std::memory_order_release);
+        }
+
+        template<typename Consumer>
+        void consume(Consumer&& consumer) {
+            size_t read = readPos.load(std::memory_order_relaxed);
+            size_t write = writePos.load(std::memory_order_acquire);
+            for (; read != write; read++) {
+                consumer(events[read & (CAPACITY - 1)]);
+            }
+            readPos.store(read, std::memory_order_release);
+        }
+    };
+
+    struct CapturedEvent {
+        const char* name;
+        int64_t start;
+        int64_t end;
+        uint32_t threadId;
+    };
+
+    // Zone and thread names are user strings, a quote or control character in them would break the whole trace
+    static void appendJsonString(std::string& json, std::string_view text) {
+        json += '"';
+        for (char c : text) {
+            if (c == '"' || c == '\\') {
+                json += '\\';
+                json += c;
+            }
+            else if ((unsigned char)c < 0x20) std::format_to(std::back_inserter(json), "\\u{:04x}", (unsigned)c);
+            else json += c;
+        }
+        json += '"';
+    }
+
+    class Profiler {
+        public:
+            static constexpr size_t HISTORY_FRAMES = 240;
+            static constexpr size_t MAX_CAPTURED_EVENTS = 4 * 1024 * 1024;
+
+            // Never destroyed, the logging thread may still record zones during static destruction
+            static Profiler& get() {
+                static Profiler* instance = [] {
+                    MemoryTagScope memoryTag(MemoryTag::GLOBAL);
+                    return new Profiler();
+                }();
+                return *instance;
+            }
+
+            ProfileThreadBuffer* getThreadBuffer() {
+                thread_local ProfileThreadBuffer* buffer = nullptr;
+                if (buffer) return buffer;
+
+                // Created lazily by whatever the thread records first, but kept until the end of the process
+                MemoryTagScope memoryTag(MemoryTag::GLOBAL);
+                std::lock_guard lock(threadBuffersMutex);
+                threadBuffers.push_back(std::make_unique<ProfileThreadBuffer>());
+                buffer = threadBuffers.back().get();
+                buffer->threadId = (uint32_t)threadBuffers.size();
+                buffer->threadName = "Thread " + std::to_string(buffer->threadId);
+                return buffer;
+            }
+
+            void setThreadName(const char* name) {
+                ProfileThreadBuffer* buffer = getThreadBuffer();
+                MemoryTagScope memoryTag(MemoryTag::GLOBAL);
+                std::lock_guard lock(threadBuffersMutex);
+                buffer->threadName = name;
+            }
+
+            void endFrame() {
+                MemoryTagScope memoryTag(MemoryTag::GLOBAL);  // Zone history and captured events
+                bool logThisFrame = false;
+                {
+                    std::lock_guard lock(threadBuffersMutex);
+                    collectFrame();
+                    logThisFrame = summaryInterval > 0 && frameCount % summaryInterval == 0;
+                }
+
+                if (logThisFrame) logSummaries();
+            }
+
+            std::vector<ProfileZoneSummary> getZoneSummaries() {
+                std::lock_guard lock(threadBuffersMutex);
+
+                std::vector<ProfileZoneSummary> summaries;
+                std::vector<int64_t> times;
+                for (auto& zone : zones) {
+                    const ZoneData& data = zone.second;
+                    size_t samples = std::min<size_t>(data.historyPos, HISTORY_FRAMES);
+                    if (samples == 0) continue;
+
+                    times.clear();
+                    uint64_t calls = 0;
+                    for (size_t i = 0; i < samples; i++) {
+                        times.push_back(data.history[i].time);
+                        calls += data.history[i].calls;
+                    }
+                    std::sort(times.begin(), times.end());
+
+                    int64_t total = 0;
+                    for (int64_t time : times) total += time;
+
+                    ProfileZoneSummary summary;
+                    summary.name = std::string(zone.first);
+                    summary.minMs = times.front() / 1e6;
+                    summary.maxMs = times.back() / 1e6;
+                    summary.avgMs = (double)total / samples / 1e6;
+                    summary.p99Ms = times[std::min(samples - 1, (size_t)(samples * 0.99))] / 1e6;
+                    summary.avgCallsPerFrame = (double)calls / samples;
+                    summaries.push_back(std::move(summary));
+                }
+
+                std::sort(summaries.begin(), summaries.end(), [](const ProfileZoneSummary& a, const ProfileZoneSummary& b) {
+                    return a.avgMs > b.avgMs;
+                });
+                return summaries;
+            }
+
+            void startCapture() {
+                std::lock_guard lock(threadBuffersMutex);
+                capturedEvents.clear();
+                captureEpoch = profiling_now();
+                capturing = true;
+            }
+
+            void stopCapture() {
+                std::lock_guard lock(threadBuffersMutex);
+                capturing = false;
+            }
+
+            bool exportChromeTrace(const std::filesystem::path& path) {
+                std::lock_guard lock(threadBuffersMutex);
+
+                std::ofstream file(path, std::ios::binary | std::ios::trunc);
+                if (!file) {
+                    logError(LogChannel::CORE, "Cannot write Chrome trace to '{}'.", path.string());
+                    return false;
+                }
+
+                std::string json;
+                json.reserve(capturedEvents.size() * 96 + 1024);
+                json += "{\"traceEvents\":[\n";
+
+                bool first = true;
+                for (auto& buffer : threadBuffers) {
+                    if (!first) json += ",\n";
+                    first = false;
+                    std::format_to(std::back_inserter(json), "{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":{},\"args\":{{\"name\":", buffer->threadId);
+                    appendJsonString(json, buffer->threadName);
+                    json += "}}";
+                }
+                for (const CapturedEvent& event : capturedEvents) {
+                    if (!first) json += ",\n";
+                    first = false;
+                    json += "{\"name\":";
+                    appendJsonString(json, event.name);
+                    std::format_to(std::back_inserter(json), ",\"ph\":\"X\",\"pid\":1,\"tid\":{},\"ts\":{:.3f},\"dur\":{:.3f}}}",
+                        event.threadId, (event.start - captureEpoch) / 1000.0, (event.end - event.start) / 1000.0);
+                }
+                json += "\n]}\n";
+
+                file.write(json.data(), json.size());
+                logInfo(LogChannel::CORE, "Exported {} profiler events to '{}'.", capturedEvents.size(), path.string());
+                return (bool)file;
+            }
+
+            void setSummaryInterval(uint32_t frames) {
+                std::lock_guard lock(threadBuffersMutex);
+                summaryInterval = frames;
+            }
+
+        private:
+            struct FrameSample {
+                int64_t time = 0;
+                uint32_t calls = 0;
+            };
+            struct ZoneData {
+                int64_t frameTime = 0;
+                uint32_t frameCalls = 0;
+                std::vector<FrameSample> history;
+                size_t historyPos = 0;
+            };
+
+            std::mutex threadBuffersMutex;
+            std::vector<std::unique_ptr<ProfileThreadBuffer>> threadBuffers;
+
+            std::unordered_map<std::string_view, ZoneData> zones;
+            uint64_t frameCount = 0;
+            uint32_t summaryInterval = 0;
+
+            bool capturing = false;
+            std::vector<CapturedEvent> capturedEvents;
+            int64_t captureEpoch = profiling_now();
+
+            // threadBuffersMutex has to be locked
+            void collectFrame() {
+                for (auto& zone : zones) {
+                    zone.second.frameTime = 0;
+                    zone.second.frameCalls = 0;
+                }
+
+                for (auto& buffer : threadBuffers) {
+                    buffer->consume([&](const ProfileEvent& event) {
+                        ZoneData& zone = zones[std::string_view(event.name)];
+                        zone.frameTime += event.end - event.start;
+                        zone.frameCalls++;
+
+                        if (capturing && event.start >= captureEpoch && capturedEvents.size() < MAX_CAPTURED_EVENTS) {
+                            capturedEvents.push_back({ event.name, event.start, event.end, buffer->threadId });
+                        }
+                    });
+                }
+
+                for (auto& zone : zones) {
+                    ZoneData& data = zone.second;
+                    if (data.history.size() < HISTORY_FRAMES) data.history.resize(HISTORY_FRAMES);
+                    data.history[data.historyPos % HISTORY_FRAMES] = { data.frameTime, data.frameCalls };
+                    data.historyPos++;
+                }
+                frameCount++;
+            }
+
+            void logSummaries() {
+                std::vector<ProfileZoneSummary> summaries = getZoneSummaries();
+
+                logInfo(LogChannel::CORE, "Profiler summary over the last {} frames:", HISTORY_FRAMES);
+                for (const ProfileZoneSummary& summary : summaries) {
+                    logInfo(LogChannel::CORE, "  {:<28} min {:8.3f}ms  avg {:8.3f}ms  p99 {:8.3f}ms  max {:8.3f}ms  ({:.1f} calls/frame)",
+                        summary.name, summary.minMs, summary.avgMs, summary.p99Ms, summary.maxMs, summary.avgCallsPerFrame);
+                }
+            }
+    };
+
+
+
+    // ------------------------------------
+    // -- Public Functions Implementation --
+    // ------------------------------------
+
+    // Nanoseconds
+    int64_t profiling_now() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    void profiling_recordZone(const char* name, int64_t start, int64_t end) {
+        thread_local ProfileThreadBuffer* buffer = Profiler::get().getThreadBuffer();
+        buffer->push({ name, start, end });
+    }
+
+    void profiling_endFrame() {
+        Profiler::get().endFrame();
+    }
+
+    void profiling_setThreadName(const char* name) {
+        Profiler::get().setThreadName(name);
+    }
+
+    void profiling_startCapture() {
+        Profiler::get().startCapture();
+    }
+
+    void profiling_stopCapture() {
+        Profiler::get().stopCapture();
+    }
+
+    bool profiling_exportChromeTrace(const std::filesystem::path& path) {
+        return Profiler::get().exportChromeTrace(path);
+    }
+
+    std::vector<ProfileZoneSummary> profiling_getZoneSummaries() {
+        return Profiler::get().getZoneSummaries();
+    }
+
+    void profiling_setSummaryInterval(uint32_t frames) {
+        Profiler::get().setSummaryInterval(frames);
+    }
+
+}
+
+#endif
@@ -0,0 +1,143 @@
+#include <frag/render/Renderer.h>
+
+#include <atomic>
+#include <utility>
+
+#include <frag/profile/Profiler.h>
+#include <frag/memory/MemoryTracker.h>
+
+namespace frag {
+
+    namespace {
+        std::atomic<uint64_t> nextRendererId = 1;
+
+        // Most threads only ever draw with one renderer, that one is looked up without the mutex
+        struct ThreadBufferCache {
+            uint64_t rendererId = 0;
+            CommandBuffer* buffer = nullptr;
+        };
+        thread_local ThreadBufferCache threadBufferCache;
+    }
+
+    // ------------------------------------
+    // -- Public Methods Implementation --
+    // ------------------------------------
+
+    Renderer::Renderer() : id(nextRendererId.fetch_add(1, std::memory_order_relaxed)) {}
+
+    Renderer::~Renderer() = default;
+
+    void Renderer::setRenderModule(IRenderModule* module) {
+        this->module = module;
+    }
+
+    CommandBuffer& Renderer::getCommandBuffer() {
+        if (threadBufferCache.rendererId == id) return *threadBufferCache.buffer;
+
+        CommandBuffer& buffer = findCommandBuffer();
+        threadBufferCache = { id, &buffer };
+        return buffer;
+    }
+
+    void Renderer::clear(Color color) {
+        clearRequested = true;
+        clearColor = color;
+    }
+
+    void Renderer::submit() {
+        FRAG_PROFILE_ZONE("Renderer::submit");
+        MemoryTagScope memoryTag(MemoryTag::RENDER);
+
+        std::lock_guard lock(bufferMutex);
+        stats = {};
+        stats.commandBufferCount = commandBuffers.size();
+
+        if (module) {
+            if (clearRequested) module->fillColor(clearColor);
+
+            sortItems.clear();
+            for (uint32_t i = 0; i < commandBuffers.size(); i++) {
+                std::span<const RenderCommand> commands = commandBuffers[i].buffer->getCommands();
+                for (uint32_t j = 0; j < commands.size(); j++) {
+                    sortItems.push_back({ commands[j].sortKey, i, j });
+                }
+            }
+            stats.commandCount = sortItems.size();
+
+            {
+                FRAG_PROFILE_ZONE("Renderer::sort");
+                radixSort(sortItems, sortScratch);
+            }
+
+            // Gathered into one array in the final order, every batch is just a part of it
+            sortedRects.resize(sortItems.size());
+            for (size_t i = 0; i < sortItems.size(); i++) {
+                sortedRects[i] = commandBuffers[sortItems[i].bufferIndex].buffer->getCommands()[sortItems[i].commandIndex].rect;
+            }
+
+            {
+                FRAG_PROFILE_ZONE("Renderer::draw");
+                size_t batchStart = 0;
+                for (size_t i = 1; i <= sortItems.size(); i++) {
+                    if (i < sortItems.size() && CommandBuffer::getMaterial(sortItems[i].key) == CommandBuffer::getMaterial(sortItems[batchStart].key)) continue;
+
+                    module->fillRects(std::span<const RectInstance>(sortedRects).subspan(batchStart, i - batchStart));
+                    stats.batchCount++;
+                    batchStart = i;
+                }
+            }
+        }
+
+        for (ThreadCommandBuffer& commandBuffer : commandBuffers) commandBuffer.buffer->clear();
+        clearRequested = false;
+    }
+
+
+
+    // -------------------------------------
+    // -- Private Methods Implementation --
+    // -------------------------------------
+
+    CommandBuffer& Renderer::findCommandBuffer() {
+        std::thread::id thread = std::this_thread::get_id();
+        MemoryTagScope memoryTag(MemoryTag::RENDER);
+
+        std::lock_guard lock(bufferMutex);
+        for (ThreadCommandBuffer& commandBuffer : commandBuffers) {
+            if (commandBuffer.thread == thread) return *commandBuffer.buffer;
+        }
+        commandBuffers.push_back({ thread, std::make_unique<CommandBuffer>() });
+        return *commandBuffers.back().buffer;
+    }
+
+    void Renderer::radixSort(std::vector<SortItem>& items, std::vector<SortItem>& scratch) {
+        // LSD radix sort over the used bytes of the key, stable so equal keys keep their recording order.
+        // The lowest 2 bytes of a key are always 0 (see CommandBuffer::makeSortKey).
+        constexpr int FIRST_BYTE = 2;
+        constexpr int BYTE_COUNT = 8;
+        if (items.size() < 2) return;
+
+        size_t counts[BYTE_COUNT][256] = {};
+        for (const SortItem& item : items) {
+            for (int byte = FIRST_BYTE; byte < BYTE_COUNT; byte++) counts[byte][(item.key >> (byte * 8)) & 0xFF]++;
+        }
+
+        scratch.resize(items.size());
+        for (int byte = FIRST_BYTE; byte < BYTE_COUNT; byte++) {
+            // Usually most bytes are the same for every command (e.g. only one layer), nothing to do for them
+            if (counts[byte][(items[0].key >> (byte * 8)) & 0xFF] == items.size()) continue;
+
+            size_t offsets[256];
+            size_t offset = 0;
+            for (int digit = 0; digit < 256; digit++) {
+                offsets[digit] = offset;
+                offset += counts[byte][digit];
+            }
+            for (const SortItem& item : items) {
+                scratch[offsets[(item.key >> (byte * 8)) & 0xFF]++] = item;
+            }
+            std::swap(items, scratch);
+        }
+    }
+
+}
@@ -0,0 +1,493 @@
+#include <frag/render/SimdKernels.h>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
+
+#if FRAG_SIMD && (defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86))
+    #define FRAG_SIMD_X86 1
+    #include <immintrin.h>
+    #if defined(_MSC_VER) && !defined(__clang__)
+        #include <intrin.h>
+    #endif
+#else
+    #define FRAG_SIMD_X86 0
+#endif
+
+// Lets single functions use instructions the rest of the engine isn't compiled for (MSVC allows that anyway)
+#if FRAG_SIMD_X86 && (defined(__GNUC__) || defined(__clang__))
+    #define FRAG_TARGET_SSE2 __attribute__((target("sse2")))
+    #define FRAG_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+    #define FRAG_TARGET_SSE2
+    #define FRAG_TARGET_AVX2
+#endif
+
+namespace frag {
+
+    namespace {
+        struct KernelTable {
+            SimdLevel level = SimdLevel::SCALAR;
+            void (*fillSpan)(uint32_t* destination, size_t count, uint32_t value) = nullptr;
+            void (*blendSpan)(uint32_t* destination, size_t count, uint32_t color) = nullptr;
+            void (*blendPixels)(uint32_t* destination, const uint32_t* source, size_t count) = nullptr;
+            void (*gradientSpan)(uint32_t* destination, size_t count, uint32_t from, uint32_t to, uint32_t position, uint32_t step) = nullptr;
+            void (*swapRedBlue)(uint32_t* destination, const uint32_t* source, size_t count) = nullptr;
+            void (*premultiplyPixels)(uint32_t* destination, const uint32_t* source, size_t count) = nullptr;
+        };
+
+        // -- Scalar, the reference for the SIMD versions --
+
+        using PixelBytes = std::array<uint8_t, 4>;
+
+        uint32_t blendPixel(uint32_t destination, uint32_t source) {
+            PixelBytes target = std::bit_cast<PixelBytes>(destination);
+            PixelBytes color = std::bit_cast<PixelBytes>(source);
+            uint8_t inverseAlpha = 255 - color[3];
+            for (int i = 0; i < 4; i++) {
+                target[i] = (uint8_t)std::min<uint32_t>(255, (uint32_t)color[i] + multiplyColorChannel(target[i], inverseAlpha));
+            }
+            return std::bit_cast<uint32_t>(target);
+        }
+
+        uint32_t gradientPixel(uint32_t from, uint32_t to, uint32_t weight) {
+            PixelBytes start = std::bit_cast<PixelBytes>(from);
+            PixelBytes end = std::bit_cast<PixelBytes>(to);
+            PixelBytes result;
+            for (int i = 0; i < 4; i++) {
+                result[i] = (uint8_t)(((uint32_t)start[i] * (256 - weight) + (uint32_t)end[i] * weight + 128) >> 8);
+            }
+            return std::bit_cast<uint32_t>(result);
+        }
+
+        uint32_t premultiplyPixel(uint32_t pixel) {
+            PixelBytes bytes = std::bit_cast<PixelBytes>(pixel);
+            for (int i = 0; i < 3; i++) bytes[i] = multiplyColorChannel(bytes[i], bytes[3]);
+            return std::bit_cast<uint32_t>(bytes);
+        }
+
+        void fillSpanScalar(uint32_t* destination, size_t count, uint32_t value) {
+            for (size_t i = 0; i < count; i++) destination[i] = value;
+        }
+
+        void blendSpanScalar(uint32_t* destination, size_t count, uint32_t color) {
+            for (size_t i = 0; i < count; i++) destination[i] = blendPixel(destination[i], color);
+        }
+
+        void blendPixelsScalar(uint32_t* destination, const uint32_t* source, size_t count) {
+            for (size_t i = 0; i < count; i++) destination[i] = blendPixel(destination[i], source[i]);
+        }
+
+        void gradientSpanScalar(uint32_t* destination, size_t count, uint32_t from, uint32_t to, uint32_t position, uint32_t step) {
+            for (size_t i = 0; i < count; i++, position += step) destination[i] = gradientPixel(from, to, position >> 16);
+        }
+
+        void swapRedBlueScalar(uint32_t* destination, const uint32_t* source, size_t count) {
+            for (size_t i = 0; i < count; i++) {
+                PixelBytes bytes = std::bit_cast<PixelBytes>(source[i]);
+                std::swap(bytes[0], bytes[2]);
+                destination[i] = std::bit_cast<uint32_t>(bytes);
+            }
+        }
+
+        void premultiplyPixelsScalar(uint32_t* destination, const uint32_t* source, size_t count) {
+            for (size_t i = 0; i < count; i++) destination[i] = premultiplyPixel(source[i]);
+        }
+
+#if FRAG_SIMD_X86
+
+        // -- SSE2 --
+        // Pixels are widened to 16 bit per channel (2 pixels per register) for the math.
+        // x86 is little endian, so the alpha of a pixel is the top byte of its 32 bit lane.
+
+        // (x + 128) * 257 >> 16 is the same as multiplyColorChannel, for every product of two 8 bit values
+        FRAG_TARGET_SSE2 inline __m128i divideBy255Sse2(__m128i product) {
+            return _mm_mulhi_epu16(_mm_add_epi16(product, _mm_set1_epi16(128)), _mm_set1_epi16(257));
+        }
+
+        // [a0 a0 a0 a0 a1 a1 a1 a1] out of two widened pixels
+        FRAG_TARGET_SSE2 inline __m128i broadcastAlphaSse2(__m128i pixels) {
+            return _mm_shufflehi_epi16(_mm_shufflelo_epi16(pixels, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+        }
+
+        // (start * (256 - weight) + end * weight + 128) / 256, at most 65408 so it fits in 16 bit
+        FRAG_TARGET_SSE2 inline __m128i interpolateSse2(__m128i start, __m128i end, __m128i weight) {
+            __m128i sum = _mm_add_epi16(_mm_mullo_epi16(start, _mm_sub_epi16(_mm_set1_epi16(256), weight)), _mm_mullo_epi16(end, weight));
+            return _mm_srli_epi16(_mm_add_epi16(sum, _mm_set1_epi16(128)), 8);
+        }
+
+        // The alpha lanes get multiplied by 255, which keeps them as they are
+        FRAG_TARGET_SSE2 inline __m128i premultiplyWidenedSse2(__m128i pixels, __m128i alphaLanes, __m128i alphaFactor) {
+            __m128i factor = _mm_or_si128(_mm_andnot_si128(alphaLanes, broadcastAlphaSse2(pixels)), alphaFactor);
+            return divideBy255Sse2(_mm_mullo_epi16(pixels, factor));
+        }
+
+        FRAG_TARGET_SSE2 void fillSpanSse2(uint32_t* destination, size_t count, uint32_t value) {
+            // Single pixels until the destination is aligned, then full aligned stores
+            while (count > 0 && (reinterpret_cast<uintptr_t>(destination) & 15) != 0) {
+                *destination++ = value;
+                count--;
+            }
+
+            __m128i fill = _mm_set1_epi32(static_cast<int>(value));
+            for (; count >= 16; count -= 16, destination += 16) {
+                _mm_store_si128(reinterpret_cast<__m128i*>(destination), fill);
+                _mm_store_si128(reinterpret_cast<__m128i*>(destination + 4), fill);
+                _mm_store_si128(reinterpret_cast<__m128i*>(destination + 8), fill);
+                _mm_store_si128(reinterpret_cast<__m128i*>(destination + 12), fill);
+            }
+            for (; count >= 4; count -= 4, destination += 4) {
+                _mm_store_si128(reinterpret_cast<__m128i*>(destination), fill);
+            }
+            while (count-- > 0) *destination++ = value;
+        }
+
+        FRAG_TARGET_SSE2 void blendSpanSse2(uint32_t* destination, size_t count, uint32_t color) {
+            const __m128i zero = _mm_setzero_si128();
+            const __m128i source = _mm_set1_epi32(static_cast<int>(color));
+            const __m128i inverseAlpha = _mm_set1_epi16(static_cast<short>(255 - (color >> 24)));
+
+            for (; count >= 4; count -= 4, destination += 4) {
+                __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(destination));
+                __m128i low = divideBy255Sse2(_mm_mullo_epi16(_mm_unpacklo_epi8(pixels, zero), inverseAlpha));
+                __m128i high = divideBy255Sse2(_mm_mullo_epi16(_mm_unpackhi_epi8(pixels, zero), inverseAlpha));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(destination), _mm_adds_epu8(_mm_packus_epi16(low, high), source));
+            }
+            blendSpanScalar(destination, count, color);
+        }
+
+        FRAG_TARGET_SSE2 void blendPixelsSse2(uint32_t* destination, const uint32_t* source, size_t count) {
+            const __m128i zero = _mm_setzero_si128();
+            const __m128i maxValue = _mm_set1_epi16(255);
+
+            for (; count >= 4; count -= 4, destination += 4, source += 4) {
+                __m128i colors = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source));
+                __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(destination));
+                __m128i inverseLow = _mm_sub_epi16(maxValue, broadcastAlphaSse2(_mm_unpacklo_epi8(colors, zero)));
+                __m128i inverseHigh = _mm_sub_epi16(maxValue, broadcastAlphaSse2(_mm_unpackhi_epi8(colors, zero)));
+                __m128i low = divideBy255Sse2(_mm_mullo_epi16(_mm_unpacklo_epi8(pixels, zero), inverseLow));
+                __m128i high = divideBy255Sse2(_mm_mullo_epi16(_mm_unpackhi_epi8(pixels, zero), inverseHigh));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(destination), _mm_adds_epu8(_mm_packus_epi16(low, high), colors));
+            }
+            blendPixelsScalar(destination, source, count);
+        }
+
+        FRAG_TARGET_SSE2 void gradientSpanSse2(uint32_t* destination, size_t count, uint32_t from, uint32_t to, uint32_t position, uint32_t step) {
+            const __m128i zero = _mm_setzero_si128();
+            const __m128i start = _mm_unpacklo_epi8(_mm_set1_epi32(static_cast<int>(from)), zero);
+            const __m128i end = _mm_unpacklo_epi8(_mm_set1_epi32(static_cast<int>(to)), zero);
+            const __m128i advance = _mm_set1_epi32(static_cast<int>(step * 4));
+            __m128i positions = _mm_add_epi32(_mm_set1_epi32(static_cast<int>(position)),
+                _mm_set_epi32(static_cast<int>(step * 3), static_cast<int>(step * 2), static_cast<int>(step), 0));
+
+            for (; count >= 4; count -= 4, destination += 4, position += step * 4) {
+                // Weights of the 4 pixels as [w0 w0 w1 w1 w2 w2 w3 w3], then spread over the channels
+                __m128i weights = _mm_srli_epi32(positions, 16);
+                weights = _mm_packs_epi32(weights, weights);
+                weights = _mm_unpacklo_epi16(weights, weights);
+                __m128i low = interpolateSse2(start, end, _mm_unpacklo_epi32(weights, weights));
+                __m128i high = interpolateSse2(start, end, _mm_unpackhi_epi32(weights, weights));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(destination), _mm_packus_epi16(low, high));
+                positions = _mm_add_epi32(positions, advance);
+            }
+            gradientSpanScalar(destination, count, from, to, position, step);
+        }
+
+        FRAG_TARGET_SSE2 void swapRedBlueSse2(uint32_t* destination, const uint32_t* source, size_t count) {
+            const __m128i keep = _mm_set1_epi32(static_cast<int>(0xFF00FF00));
+            const __m128i lowByte = _mm_set1_epi32(0xFF);
+
+            for (; count >= 4; count -= 4, destination += 4, source += 4) {
+                __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source));
+                __m128i swapped = _mm_or_si128(_mm_and_si128(_mm_srli_epi32(pixels, 16), lowByte), _mm_slli_epi32(_mm_and_si128(pixels, lowByte), 16));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(destination), _mm_or_si128(_mm_and_si128(pixels, keep), swapped));
+            }
+            swapRedBlueScalar(destination, source, count);
+        }
+
+        FRAG_TARGET_SSE2 void premultiplyPixelsSse2(uint32_t* destination, const uint32_t* source, size_t count) {
+            const __m128i zero = _mm_setzero_si128();
+            const __m128i alphaLanes = _mm_set_epi16(-1, 0, 0, 0, -1, 0, 0, 0);
+            const __m128i alphaFactor = _mm_and_si128(alphaLanes, _mm_set1_epi16(255));
+
+            for (; count >= 4; count -= 4, destination += 4, source += 4) {
+                __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source));
+                __m128i low = premultiplyWidenedSse2(_mm_unpacklo_epi8(pixels, zero), alphaLanes, alphaFactor);
+                __m128i high = premultiplyWidenedSse2(_mm_unpackhi_epi8(pixels, zero), alphaLanes, alphaFactor);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(destination), _mm_packus_epi16(low, high));
+            }
+            premultiplyPixelsScalar(destination, source, count);
+        }
+
+        // -- AVX2 --
+        // Same as SSE2 with 8 pixels at once. Unpacking and packing works per 128 bit half, since both
+        // directions do that the pixels end up in the right place again.
+
+        FRAG_TARGET_AVX2 inline __m256i divideBy255Avx2(__m256i product) {
+            return _mm256_mulhi_epu16(_mm256_add_epi16(product, _mm256_set1_epi16(128)), _mm256_set1_epi16(257));
+        }
+
+        FRAG_TARGET_AVX2 inline __m256i broadcastAlphaAvx2(__m256i pixels) {
+            return _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(pixels, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+        }
+
+        // (start * (256 - weight) + end * weight + 128) / 256, at most 65408 so it fits in 16 bit
+        FRAG_TARGET_AVX2 inline __m256i interpolateAvx2(__m256i start, __m256i end, __m256i weight) {
+            __m256i sum = _mm256_add_epi16(_mm256_mullo_epi16(start, _mm256_sub_epi16(_mm256_set1_epi16(256), weight)), _mm256_mullo_epi16(end, weight));
+            return _mm256_srli_epi16(_mm256_add_epi16(sum, _mm256_set1_epi16(128)), 8);
+        }
+
+        // The alpha lanes get multiplied by 255, which keeps them as they are
+        FRAG_TARGET_AVX2 inline __m256i premultiplyWidenedAvx2(__m256i pixels, __m256i alphaLanes, __m256i alphaFactor) {
+            __m256i factor = _mm256_or_si256(_mm256_andnot_si256(alphaLanes, broadcastAlphaAvx2(pixels)), alphaFactor);
+            return divideBy255Avx2(_mm256_mullo_epi16(pixels, factor));
+        }
+
+        FRAG_TARGET_AVX2 void fillSpanAvx2(uint32_t* destination, size_t count, uint32_t value) {
+            __m256i fill = _mm256_set1_epi32(static_cast<int>(value));
+            if (count < 8) {
+                while (count-- > 0) *destination++ = value;
+                return;
+            }
+
+            // One unaligned store covers the head, the aligned loop then starts at the next 32 byte boundary
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(destination), fill);
+            size_t head = (32 - (reinterpret_cast<uintptr_t>(destination) & 31)) / sizeof(uint32_t);
+            destination += head;
+            count -= head;
+
+            for (; count >= 32; count -= 32, destination += 32) {
+                _mm256_store_si256(reinterpret_cast<__m256i*>(destination), fill);
+                _mm256_store_si256(reinterpret_cast<__m256i*>(destination + 8), fill);
+                _mm256_store_si256(reinterpret_cast<__m256i*>(destination + 16), fill);
+                _mm256_store_si256(reinterpret_cast<__m256i*>(destination + 24), fill);
+            }
+            for (; count >= 8; count -= 8, destination += 8) {
+                _mm256_store_si256(reinterpret_cast<__m256i*>(destination), fill);
+            }
+            // Same for the tail, the last 8 pixels overlap with what is already filled
+            if (count > 0) _mm256_storeu_si256(reinterpret_cast<__m256i*>(destination + count - 8), fill);
+        }
+
+        FRAG_TARGET_AVX2 void blendSpanAvx2(uint32_t* destination, size_t count, uint32_t color) {
+            const __m256i zero = _mm256_setzero_si256();
+            const __m256i source = _mm256_set1_epi32(static_cast<int>(color));
+            const __m256i inverseAlpha = _mm256_set1_epi16(static_cast<short>(255 - (color >> 24)));
+
+            for (; count >= 8; count -= 8, destination += 8) {
+                __m256i pixels = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(destination));
+                __m256i low = divideBy255Avx2(_mm256_mullo_epi16(_mm256_unpacklo_epi8(pixels, zero), inverseAlpha));
+                __m256i high = divideBy255Avx2(_mm256_mullo_epi16(_mm256_unpackhi_epi8(pixels, zero), inverseAlpha));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(destination), _mm256_adds_epu8(_mm256_packus_epi16(low, high), source));
+            }
+            blendSpanScalar(destination, count, color);
+        }
+
+        FRAG_TARGET_AVX2 void blendPixelsAvx2(uint32_t* destination, const uint32_t* source, size_t count) {
+            const __m256i zero = _mm256_setzero_si256();
+            const __m256i maxValue = _mm256_set1_epi16(255);
+
+            for (; count >= 8; count -= 8, destination += 8, source += 8) {
+                __m256i colors = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source));
+                __m256i pixels = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(destination));
+                __m256i inverseLow = _mm256_sub_epi16(maxValue, broadcastAlphaAvx2(_mm256_unpacklo_epi8(colors, zero)));
+                __m256i inverseHigh = _mm256_sub_epi16(maxValue, broadcastAlphaAvx2(_mm256_unpackhi_epi8(colors, zero)));
+                __m256i low = divideBy255Avx2(_mm256_mullo_epi16(_mm256_unpacklo_epi8(pixels, zero), inverseLow));
+                __m256i high = divideBy255Avx2(_mm256_mullo_epi16(_mm256_unpackhi_epi8(pixels, zero), inverseHigh));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(destination), _mm256_adds_epu8(_mm256_packus_epi16(low, high), colors));
+            }
+            blendPixelsScalar(destination, source, count);
+        }
+
+        FRAG_TARGET_AVX2 void gradientSpanAvx2(uint32_t* destination, size_t count, uint32_t from, uint32_t to, uint32_t position, uint32_t step) {
+            const __m256i zero = _mm256_setzero_si256();
+            const __m256i start = _mm256_unpacklo_epi8(_mm256_set1_epi32(static_cast<int>(from)), zero);
+            const __m256i end = _mm256_unpacklo_epi8(_mm256_set1_epi32(static_cast<int>(to)), zero);
+            const __m256i advance = _mm256_set1_epi32(static_cast<int>(step * 8));
+            __m256i positions = _mm256_add_epi32(_mm256_set1_epi32(static_cast<int>(position)),
+                _mm256_mullo_epi32(_mm256_set1_epi32(static_cast<int>(step)), _mm256_set_epi32(7, 6, 5, 4, 3, 2, 1, 0)));
+
+            for (; count >= 8; count -= 8, destination += 8, position += step * 8) {
+                // Per 128 bit half like SSE2: [w0 x4, w1 x4 | w4 x4, w5 x4] and [w2, w3 | w6, w7], matching the unpacked pixels
+                __m256i weights = _mm256_srli_epi32(positions, 16);
+                weights = _mm256_packs_epi32(weights, weights);
+                weights = _mm256_unpacklo_epi16(weights, weights);
+                __m256i low = interpolateAvx2(start, end, _mm256_unpacklo_epi32(weights, weights));
+                __m256i high = interpolateAvx2(start, end, _mm256_unpackhi_epi32(weights, weights));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(destination), _mm256_packus_epi16(low, high));
+                positions = _mm256_add_epi32(positions, advance);
+            }
+            gradientSpanScalar(destination, count, from, to, position, step);
+        }
+
+        FRAG_TARGET_AVX2 void swapRedBlueAvx2(uint32_t* destination, const uint32_t* source, size_t count) {
+            const __m256i keep = _mm256_set1_epi32(static_cast<int>(0xFF00FF00));
+            const __m256i lowByte = _mm256_set1_epi32(0xFF);
+
+            for (; count >= 8; count -= 8, destination += 8, source += 8) {
+                __m256i pixels = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source));
+                __m256i swapped = _mm256_or_si256(_mm256_and_si256(_mm256_srli_epi32(pixels, 16), lowByte), _mm256_slli_epi32(_mm256_and_si256(pixels, lowByte), 16));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(destination), _mm256_or_si256(_mm256_and_si256(pixels, keep), swapped));
+            }
+            swapRedBlueScalar(destination, source, count);
+        }
+
+        FRAG_TARGET_AVX2 void premultiplyPixelsAvx2(uint32_t* destination, const uint32_t* source, size_t count) {
+            const __m256i zero = _mm256_setzero_si256();
+            const __m256i alphaLanes = _mm256_set_epi16(-1, 0, 0, 0, -1, 0, 0, 0, -1, 0, 0, 0, -1, 0, 0, 0);
+            const __m256i alphaFactor = _mm256_and_si256(alphaLanes, _mm256_set1_epi16(255));
+
+            for (; count >= 8; count -= 8, destination += 8, source += 8) {
+                __m256i pixels = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source));
+                __m256i low = premultiplyWidenedAvx2(_mm256_unpacklo_epi8(pixels, zero), alphaLanes, alphaFactor);
+                __m256i high = premultiplyWidenedAvx2(_mm256_unpackhi_epi8(pixels, zero), alphaLanes, alphaFactor);
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(destination), _mm256_packus_epi16(low, high));
+            }
+            premultiplyPixelsScalar(destination, source, count);
+        }
+
+#endif
+
+        SimdLevel detectSimdLevel() {
+#if FRAG_SIMD_X86
+    #if defined(__GNUC__) || defined(__clang__)
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx2")) return SimdLevel::AVX2;
+            if (__builtin_cpu_supports("sse2")) return SimdLevel::SSE2;
+    #else
+            int info[4];
+            __cpuid(info, 0);
+            int maxLeaf = info[0];
+            __cpuid(info, 1);
+            bool sse2 = (info[3] & (1 << 26)) != 0;
+            // AVX2 also needs the OS to save the YMM registers (OSXSAVE + XCR0)
+            bool osSavesYmm = (info[2] & (1 << 27)) != 0 && (info[2] & (1 << 28)) != 0 && (_xgetbv(0) & 6) == 6;
+            if (maxLeaf >= 7 && osSavesYmm) {
+                __cpuidex(info, 7, 0);
+                if (info[1] & (1 << 5)) return SimdLevel::AVX2;
+            }
+            if (sse2) return SimdLevel::SSE2;
+    #endif
+#endif
+            return SimdLevel::SCALAR;
+        }
+
+        KernelTable createKernelTable(SimdLevel level) {
+            KernelTable table;
+            table.level = level;
+            table.fillSpan = fillSpanScalar;
+            table.blendSpan = blendSpanScalar;
+            table.blendPixels = blendPixelsScalar;
+            table.gradientSpan = gradientSpanScalar;
+            table.swapRedBlue = swapRedBlueScalar;
+            table.premultiplyPixels = premultiplyPixelsScalar;
+
+#if FRAG_SIMD_X86
+            if (level >= SimdLevel::SSE2) {
+                table.fillSpan = fillSpanSse2;
+                table.blendSpan = blendSpanSse2;
+                table.blendPixels = blendPixelsSse2;
+                table.gradientSpan = gradientSpanSse2;
+                table.swapRedBlue = swapRedBlueSse2;
+                table.premultiplyPixels = premultiplyPixelsSse2;
+            }
+            if (level >= SimdLevel::AVX2) {
+                table.fillSpan = fillSpanAvx2;
+                table.blendSpan = blendSpanAvx2;
+                table.blendPixels = blendPixelsAvx2;
+                table.gradientSpan = gradientSpanAvx2;
+                table.swapRedBlue = swapRedBlueAvx2;
+                table.premultiplyPixels = premultiplyPixelsAvx2;
+            }
+#endif
+            return table;
+        }
+
+        SimdLevel getDetectedSimdLevel() {
+            static const SimdLevel level = detectSimdLevel();
+            return level;
+        }
+
+        KernelTable& getKernels() {
+            static KernelTable kernels = createKernelTable(getDetectedSimdLevel());
+            return kernels;
+        }
+    }
+
+    // ------------------------------------
+    // -- Public Methods Implementation --
+    // ------------------------------------
+
+    SimdLevel getSupportedSimdLevel() {
+        return getDetectedSimdLevel();
+    }
+
+    SimdLevel getSimdLevel() {
+        return getKernels().level;
+    }
+
+    void setSimdLevel(SimdLevel level) {
+        getKernels() = createKernelTable(std::min(level, getDetectedSimdLevel()));
+    }
+
+    const char* getSimdLevelName(SimdLevel level) {
+        switch (level) {
+            case SimdLevel::SCALAR: return "Scalar";
+            case SimdLevel::SSE2:   return "SSE2";
+            case SimdLevel::AVX2:   return "AVX2";
+        }
+        return "Unknown";
+    }
+
+    void fillSpan(uint32_t* destination, size_t count, uint32_t value) {
+        getKernels().fillSpan(destination, count, value);
+    }
+
+    void blendSpan(uint32_t* destination, size_t count, uint32_t premultipliedColor) {
+        getKernels().blendSpan(destination, count, premultipliedColor);
+    }
+
+    void blendPixels(uint32_t* destination, const uint32_t* source, size_t count) {
+        getKernels().blendPixels(destination, source, count);
+    }
+
+    void gradientSpan(uint32_t* destination, size_t count, uint32_t from, uint32_t to, uint32_t position, uint32_t step) {
+        getKernels().gradientSpan(destination, count, from, to, position, step);
+    }
+
+    void convertPixels(uint32_t* destination, const uint32_t* source, size_t count, PixelFormat from, PixelFormat to) {
+        // Every step reads from where the last one wrote to, the first one from the source
+        const uint32_t* input = source;
+        if (isPremultiplied(from) && !isPremultiplied(to)) {
+            unpremultiplyPixels(destination, input, count);
+            input = destination;
+        }
+        if (isBlueFirst(from) != isBlueFirst(to)) {
+            swapRedBlue(destination, input, count);
+            input = destination;
+        }
+        if (!isPremultiplied(from) && isPremultiplied(to)) {
+            premultiplyPixels(destination, input, count);
+            input = destination;
+        }
+        if (input != destination && count > 0) std::memmove(destination, input, count * sizeof(uint32_t));
+    }
+
+    void swapRedBlue(uint32_t* destination, const uint32_t* source, size_t count) {
+        getKernels().swapRedBlue(destination, source, count);
+    }
+
+    void premultiplyPixels(uint32_t* destination, const uint32_t* source, size_t count) {
+        getKernels().premultiplyPixels(destination, source, count);
+    }
+
+    void unpremultiplyPixels(uint32_t* destination, const uint32_t* source, size_t count) {
+        for (size_t i = 0; i < count; i++) {
+            PixelBytes bytes = std::bit_cast<PixelBytes>(source[i]);
+            Color color = Color{ bytes[0], bytes[1], bytes[2], bytes[3] }.unpremultiplied();
+            destination[i] = std::bit_cast<uint32_t>(PixelBytes{ color.r, color.g, color.b, color.a });
+        }
+    }
+
+}
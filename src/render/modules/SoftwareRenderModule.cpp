@@ -0,0 +1,329 @@
+#include <frag/render/modules/SoftwareRenderModule.h>
+
+#include <algorithm>
+#include <format>
+#include <new>
+#include <utility>
+
+#include <frag/Log.h>
+#include <frag/job/JobSystem.h>
+#include <frag/profile/Profiler.h>
+#include <frag/render/SimdKernels.h>
+
+namespace frag {
+
+    namespace {
+        // Start of the content hash of a tile that is filled completely, followed by the color
+        constexpr FragHash FILLED_TILE_HASH = "SoftwareRenderModule::FilledTile"_fh;
+
+        FragHash hashFilledTile(uint32_t value) {
+            return fragHashCombine(FILLED_TILE_HASH, value);
+        }
+    }
+
+    // ------------------------------------
+    // -- Public Methods Implementation --
+    // ------------------------------------
+
+    std::expected<void, std::string> SoftwareRenderModule::init(const RenderSettings& newSettings) {
+        // Larger than that is no real screen anymore, and width * height could overflow
+        constexpr int MAX_SIZE = 16384;
+        if (newSettings.width <= 0 || newSettings.height <= 0 || newSettings.width > MAX_SIZE || newSettings.height > MAX_SIZE) {
+            return std::unexpected(std::format("Invalid framebuffer size {}x{}.", newSettings.width, newSettings.height));
+        }
+
+        constexpr int PIXELS_PER_ROW_ALIGNMENT = (int)(ROW_ALIGNMENT / sizeof(uint32_t));
+        settings = newSettings;
+        pitch = (settings.width + PIXELS_PER_ROW_ALIGNMENT - 1) / PIXELS_PER_ROW_ALIGNMENT * PIXELS_PER_ROW_ALIGNMENT;
+
+        size_t pixelCount = (size_t)pitch * settings.height;
+        frontBuffer = allocatePixels(pixelCount);
+        backBuffer = allocatePixels(pixelCount);
+        // Both start black, so the first frames are the same on every run. The row padding stays black forever.
+        fillSpan(frontBuffer.get(), pixelCount, 0);
+        fillSpan(backBuffer.get(), pixelCount, 0);
+        presentedFrames = 0;
+
+        tileColumns = (settings.width + TILE_SIZE - 1) / TILE_SIZE;
+        tileRows = (settings.height + TILE_SIZE - 1) / TILE_SIZE;
+        tiles.clear();
+        tiles.resize((size_t)tileColumns * tileRows);
+        for (Tile& tile : tiles) {
+            tile.content = hashFilledTile(0);
+            tile.bufferContent[0] = tile.content;
+            tile.bufferContent[1] = tile.content;
+        }
+        tileOps.clear();
+        hasQueuedWork = false;
+        hasFrameWork = false;
+        backIndex = 0;
+        damageRects.clear();
+
+        logInfo(LogChannel::RENDER, "Software renderer: {}x{} framebuffer, {}x{} tiles, {} kernels.", settings.width, settings.height,
+            tileColumns, tileRows, getSimdLevelName(getSimdLevel()));
+        return {};
+    }
+
+    bool SoftwareRenderModule::swapBuffers() {
+        damageRects.clear();
+        if (!hasFrameWork) return false;
+
+        flush();
+        hasFrameWork = false;
+
+        collectDamageRects();
+        if (damageRects.empty()) return false;
+
+        std::swap(frontBuffer, backBuffer);
+        backIndex ^= 1;
+        presentedFrames++;
+
+        // The next frame starts on top of what the new back buffer contains
+        for (Tile& tile : tiles) tile.content = tile.bufferContent[backIndex];
+        return true;
+    }
+
+    void SoftwareRenderModule::fillColor(const Color color) {
+        if (!backBuffer) return;
+
+        // Everything queued so far gets covered anyway
+        uint32_t value = packColor(color);
+        FragHash content = hashFilledTile(value);
+        tileOps.clear();
+        for (Tile& tile : tiles) {
+            tile.ops.clear();
+            tile.cleared = true;
+            tile.clearValue = value;
+            tile.content = content;
+        }
+        hasQueuedWork = true;
+        hasFrameWork = true;
+    }
+
+    void SoftwareRenderModule::fillRect(Color color, int x, int y, int w, int h) {
+        if (!backBuffer) return;
+        queueRect(color, x, y, w, h);
+    }
+
+    void SoftwareRenderModule::fillRects(std::span<const RectInstance> rects) {
+        FRAG_PROFILE_ZONE("SoftwareRenderModule::fillRects");
+        if (!backBuffer) return;
+
+        for (const RectInstance& rect : rects) {
+            queueRect(rect.color, rect.x, rect.y, rect.w, rect.h);
+        }
+    }
+
+    void SoftwareRenderModule::fillGradientRect(Color left, Color right, int x, int y, int w, int h) {
+        if (!backBuffer || w <= 0 || h <= 0) return;
+
+        TileOp op;
+        if (!clipRect(x, y, w, h, op)) return;
+        op.type = OpType::GRADIENT;
+        op.value = packColor(left);
+        op.endValue = packColor(right);
+        op.gradientLeft = x;
+        // Weights go from 0 to 256 << 16 over the whole (unclipped) width
+        op.gradientStep = w > 1 ? (uint32_t)((256u << 16) / (uint32_t)(w - 1)) : 0;
+
+        FragHash opHash = fragHashCombine(hashOpBounds(op, op.value), op.endValue);
+        opHash = fragHashCombine(opHash, (FragHash)(uint32_t)op.gradientLeft << 32 | op.gradientStep);
+        queueOp(op, opHash);
+    }
+
+    void SoftwareRenderModule::flush() {
+        if (!hasQueuedWork) return;
+        FRAG_PROFILE_ZONE("SoftwareRenderModule::flush");
+
+        auto drawTiles = [this](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                drawTile(tiles[i], (int)(i % tileColumns), (int)(i / tileColumns));
+            }
+        };
+
+        if (settings.jobSystem && settings.jobSystem->getThreadCount() > 1) {
+            settings.jobSystem->parallelFor(tiles.size(), 1, drawTiles);
+        }
+        else {
+            drawTiles(0, tiles.size());
+        }
+
+        tileOps.clear();
+        hasQueuedWork = false;
+    }
+
+    uint32_t* SoftwareRenderModule::getBackBuffer() {
+        flush();
+        return backBuffer.get();
+    }
+
+
+
+    // -------------------------------------
+    // -- Private Methods Implementation --
+    // -------------------------------------
+
+    bool SoftwareRenderModule::clipRect(int x, int y, int w, int h, TileOp& op) const {
+        // 64 bit, so x + w can't overflow
+        op.left = (int)std::max<long long>(x, 0);
+        op.top = (int)std::max<long long>(y, 0);
+        op.right = (int)std::min<long long>((long long)x + w, settings.width);
+        op.bottom = (int)std::min<long long>((long long)y + h, settings.height);
+        return op.left < op.right && op.top < op.bottom;
+    }
+
+    FragHash SoftwareRenderModule::hashOpBounds(const TileOp& op, uint32_t value) {
+        // The position is part of the content hash of the tiles, every coordinate is below 2^16
+        return fragHashCombine((FragHash)op.left << 48 | (FragHash)op.top << 32 | (FragHash)op.right << 16 | (FragHash)op.bottom,
+            (FragHash)op.type << 32 | value);
+    }
+
+    void SoftwareRenderModule::queueRect(Color color, int x, int y, int w, int h) {
+        // Fully transparent doesn't change anything
+        if (w <= 0 || h <= 0 || color.a == 0) return;
+
+        TileOp op;
+        if (!clipRect(x, y, w, h, op)) return;
+        op.type = color.isOpaque() ? OpType::FILL : OpType::BLEND;
+        op.value = packColor(color);
+        queueOp(op, hashOpBounds(op, op.value));
+    }
+
+    void SoftwareRenderModule::queueOp(const TileOp& op, FragHash opHash) {
+        uint32_t index = (uint32_t)tileOps.size();
+        tileOps.push_back(op);
+        hasQueuedWork = true;
+        hasFrameWork = true;
+
+        int lastColumn = (op.right - 1) / TILE_SIZE;
+        int lastRow = (op.bottom - 1) / TILE_SIZE;
+        for (int row = op.top / TILE_SIZE; row <= lastRow; row++) {
+            int tileTop = row * TILE_SIZE;
+            int tileBottom = std::min(tileTop + TILE_SIZE, settings.height);
+
+            for (int column = op.left / TILE_SIZE; column <= lastColumn; column++) {
+                Tile& tile = tiles[(size_t)row * tileColumns + column];
+                int tileLeft = column * TILE_SIZE;
+                int tileRight = std::min(tileLeft + TILE_SIZE, settings.width);
+
+                // An opaque fill over the whole tile, nothing that was queued before can be seen anymore
+                if (op.type == OpType::FILL && op.left <= tileLeft && op.top <= tileTop && op.right >= tileRight && op.bottom >= tileBottom) {
+                    tile.ops.clear();
+                    tile.cleared = true;
+                    tile.clearValue = op.value;
+                    tile.content = hashFilledTile(op.value);
+                    continue;
+                }
+                tile.ops.push_back(index);
+                tile.content = fragHashCombine(tile.content, opHash);
+            }
+        }
+    }
+
+    void SoftwareRenderModule::drawTile(Tile& tile, int column, int row) {
+        FragHash& backContent = tile.bufferContent[backIndex];
+        const FragHash frontContent = tile.bufferContent[backIndex ^ 1];
+        if (tile.content == backContent) {
+            // Already shows exactly that
+            tile.ops.clear();
+            tile.cleared = false;
+            return;
+        }
+
+        int tileLeft = column * TILE_SIZE;
+        int tileTop = row * TILE_SIZE;
+        int tileRight = std::min(tileLeft + TILE_SIZE, settings.width);
+        int tileBottom = std::min(tileTop + TILE_SIZE, settings.height);
+        size_t tileOffset = (size_t)tileTop * pitch + tileLeft;
+
+        if (tile.content == frontContent && !tile.ops.empty()) {
+            // Changed back to what the front buffer shows, copying is cheaper than drawing all fills again
+            const uint32_t* source = frontBuffer.get() + tileOffset;
+            uint32_t* pixels = backBuffer.get() + tileOffset;
+            for (int y = tileTop; y < tileBottom; y++, source += pitch, pixels += pitch) {
+                std::copy_n(source, tileRight - tileLeft, pixels);
+            }
+        }
+        else {
+            if (tile.cleared) {
+                uint32_t* pixels = backBuffer.get() + tileOffset;
+                for (int y = tileTop; y < tileBottom; y++, pixels += pitch) {
+                    fillSpan(pixels, (size_t)(tileRight - tileLeft), tile.clearValue);
+                }
+            }
+
+            for (uint32_t index : tile.ops) {
+                const TileOp& op = tileOps[index];
+                int left = std::max(op.left, tileLeft);
+                int top = std::max(op.top, tileTop);
+                int right = std::min(op.right, tileRight);
+                int bottom = std::min(op.bottom, tileBottom);
+
+                uint32_t* pixels = backBuffer.get() + (size_t)top * pitch + left;
+                size_t width = (size_t)(right - left);
+                switch (op.type) {
+                    case OpType::FILL:
+                        for (int y = top; y < bottom; y++, pixels += pitch) fillSpan(pixels, width, op.value);
+                        break;
+                    case OpType::BLEND:
+                        for (int y = top; y < bottom; y++, pixels += pitch) blendSpan(pixels, width, op.value);
+                        break;
+                    case OpType::GRADIENT: {
+                        // + 0.5 so the weight is rounded, the last pixel gets exactly the right color
+                        uint32_t position = (uint32_t)((uint64_t)(left - (long long)op.gradientLeft) * op.gradientStep) + 0x8000;
+                        for (int y = top; y < bottom; y++, pixels += pitch) gradientSpan(pixels, width, op.value, op.endValue, position, op.gradientStep);
+                        break;
+                    }
+                }
+            }
+        }
+
+        backContent = tile.content;
+        tile.ops.clear();
+        tile.cleared = false;
+    }
+
+    void SoftwareRenderModule::collectDamageRects() {
+        // Runs of changed tiles in a row, merged with the run right above if it spans the same columns
+        previousDamageRuns.clear();
+        for (int row = 0; row < tileRows; row++) {
+            damageRuns.clear();
+            const Tile* rowTiles = tiles.data() + (size_t)row * tileColumns;
+
+            for (int column = 0; column < tileColumns;) {
+                if (rowTiles[column].bufferContent[0] == rowTiles[column].bufferContent[1]) {
+                    column++;
+                    continue;
+                }
+                int first = column;
+                while (column < tileColumns && rowTiles[column].bufferContent[0] != rowTiles[column].bufferContent[1]) column++;
+
+                int top = row * TILE_SIZE;
+                int bottom = std::min(top + TILE_SIZE, settings.height);
+                auto above = std::find_if(previousDamageRuns.begin(), previousDamageRuns.end(),
+                    [&](const DamageRun& run) { return run.first == first && run.end == column; });
+
+                if (above != previousDamageRuns.end()) {
+                    damageRects[above->rect].h = bottom - damageRects[above->rect].y;
+                    damageRuns.push_back(*above);
+                }
+                else {
+                    int left = first * TILE_SIZE;
+                    int right = std::min(column * TILE_SIZE, settings.width);
+                    damageRects.push_back({ left, top, right - left, bottom - top });
+                    damageRuns.push_back({ first, column, damageRects.size() - 1 });
+                }
+            }
+            std::swap(damageRuns, previousDamageRuns);
+        }
+    }
+
+    void SoftwareRenderModule::AlignedDeleter::operator()(uint32_t* pixels) const {
+        ::operator delete[](pixels, std::align_val_t(ROW_ALIGNMENT));
+    }
+
+    SoftwareRenderModule::PixelBuffer SoftwareRenderModule::allocatePixels(size_t count) {
+        return PixelBuffer(static_cast<uint32_t*>(::operator new[](count * sizeof(uint32_t), std::align_val_t(ROW_ALIGNMENT))));
+    }
+
+}
@@ -0,0 +1,81 @@
+#include <frag/time/FramePacer.h>
+
+#include <cmath>
+#include <thread>
+
+namespace frag {
+
+    // ------------------------------------
+    // -- Public Methods Implementation --
+    // ------------------------------------
+
+    void FramePacer::setTargetFPS(int targetFPS) {
+        if (targetFPS <= 0) frameTime = Clock::duration::zero();
+        else frameTime = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / targetFPS));
+
+        reset();
+    }
+
+    void FramePacer::reset() {
+        nextFrame = Clock::time_point::min();
+    }
+
+    void FramePacer::waitForNextFrame() {
+        if (frameTime == Clock::duration::zero()) return;
+
+        // First frame, or more than a whole frame behind: there is no point in trying to catch up
+        Clock::time_point now = Clock::now();
+        if (nextFrame == Clock::time_point::min() || now - nextFrame > frameTime) {
+            nextFrame = now;
+        }
+
+        preciseWaitUntil(nextFrame);
+        nextFrame += frameTime;
+    }
+
+
+
+    // -------------------------------------
+    // -- Private Methods Implementation --
+    // -------------------------------------
+
+    static constexpr std::chrono::microseconds SLEEP_STEP = std::chrono::microseconds(1000);
+
+    void FramePacer::preciseWaitUntil(Clock::time_point deadline) {
+        // Sleep phase
+        while (true) {
+            Clock::time_point now = Clock::now();
+            double remaining = std::chrono::duration<double>(deadline - now).count();
+            double sleepCost = std::chrono::duration<double>(SLEEP_STEP).count() + getSleepOvershootEstimate();
+            if (remaining <= sleepCost) break;
+
+            std::this_thread::sleep_for(SLEEP_STEP);
+
+            double slept = std::chrono::duration<double>(Clock::now() - now).count();
+            addSleepSample(slept - std::chrono::duration<double>(SLEEP_STEP).count());
+        }
+
+        // Spin phase, only the last fraction of a millisecond
+        while (Clock::now() < deadline) {
+            std::this_thread::yield();
+        }
+    }
+
+    void FramePacer::addSleepSample(double overshoot) {
+        if (overshoot < 0.0) overshoot = 0.0;
+
+        // Only the recent behaviour matters, so the estimate is limited to a window of samples
+        static constexpr long long MAX_SAMPLES = 1000;
+        if (sleepSamples >= MAX_SAMPLES) {
+            sleepSamples = MAX_SAMPLES / 2;
+            sleepOvershootM2 *= 0.5;
+        }
+
+        sleepSamples++;
+        double delta = overshoot - sleepOvershootMean;
+        sleepOvershootMean += delta / sleepSamples;
+        sleepOvershootM2 += delta * (overshoot - sleepOvershootMean);
+        sleepOvershootDeviation = sleepSamples > 1 ? std::sqrt(sleepOvershootM2 / (sleepSamples - 1)) : 0.0;
+    }
+
+}
@@ -0,0 +1,234 @@
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <frag/job/JobSystem.h>
+#include <frag/render/RenderStructs.h>
+#include <frag/render/SimdKernels.h>
+#include <frag/render/modules/SoftwareRenderModule.h>
+
+/*
+    SimdKernelTests - Checks that every SIMD level produces exactly the pixels of the scalar kernels
+    Usage: SimdKernelTests, returns 1 if anything differs (ctest runs it too)
+
+    Every kernel runs on random pixels with lengths from 0 to 70 and start offsets that break the 16/32 byte alignment,
+    once on the scalar level and once on the level that is tested. The whole buffer is compared, so writes past the
+    end of a span show up as well. At the end a SoftwareRenderModule frame is drawn on every level and thread count.
+*/
+
+namespace {
+    constexpr size_t MAX_LENGTH = 70;
+    constexpr size_t MAX_OFFSET = 7;
+    constexpr size_t BUFFER_SIZE = MAX_LENGTH + MAX_OFFSET + 8;    // Some pixels behind the span that must stay untouched
+    constexpr int CASES_PER_KERNEL = 2000;
+
+    constexpr frag::PixelFormat PIXEL_FORMATS[] = {
+        frag::PixelFormat::RGBA8, frag::PixelFormat::BGRA8, frag::PixelFormat::RGBA8_PREMULTIPLIED, frag::PixelFormat::BGRA8_PREMULTIPLIED
+    };
+
+    int failures = 0;
+
+    using Pixels = std::vector<uint32_t>;
+
+    // The kernel with everything random already picked, gets the destination and source buffer
+    using KernelCall = std::function<void(uint32_t* destination, uint32_t* source)>;
+
+    uint32_t randomPremultiplied(std::mt19937& random) {
+        frag::Color color = { (uint8_t)random(), (uint8_t)random(), (uint8_t)random(), (uint8_t)random() };
+        return color.premultiplied().pack(frag::PixelFormat::RGBA8_PREMULTIPLIED);
+    }
+
+    Pixels randomPixels(std::mt19937& random, bool premultiplied) {
+        Pixels pixels(BUFFER_SIZE);
+        for (uint32_t& pixel : pixels) pixel = premultiplied ? randomPremultiplied(random) : (uint32_t)random();
+        return pixels;
+    }
+
+    // Runs call on copies of the buffers on the scalar level and on level, false if the results differ
+    bool compareWithScalar(frag::SimdLevel level, const std::string& name, const Pixels& destination, const Pixels& source, const KernelCall& call) {
+        Pixels expectedDestination = destination;
+        Pixels expectedSource = source;
+        frag::setSimdLevel(frag::SimdLevel::SCALAR);
+        call(expectedDestination.data(), expectedSource.data());
+
+        Pixels actualDestination = destination;
+        Pixels actualSource = source;
+        frag::setSimdLevel(level);
+        call(actualDestination.data(), actualSource.data());
+
+        for (size_t i = 0; i < BUFFER_SIZE; i++) {
+            if (expectedDestination[i] == actualDestination[i] && expectedSource[i] == actualSource[i]) continue;
+
+            std::printf("FAILED %s/%s: pixel %zu is %08X, the scalar kernel wrote %08X\n", name.c_str(), frag::getSimdLevelName(level), i,
+                expectedDestination[i] == actualDestination[i] ? actualSource[i] : actualDestination[i],
+                expectedDestination[i] == actualDestination[i] ? expectedSource[i] : expectedDestination[i]);
+            failures++;
+            return false;
+        }
+        return true;
+    }
+
+    void testKernels(frag::SimdLevel level) {
+        std::mt19937 random(1234 + (int)level);
+        int failuresBefore = failures;
+
+        for (int i = 0; i < CASES_PER_KERNEL; i++) {
+            size_t count = random() % (MAX_LENGTH + 1);
+            size_t offset = random() % (MAX_OFFSET + 1);
+            size_t sourceOffset = random() % (MAX_OFFSET + 1);
+            Pixels destination = randomPixels(random, true);
+            Pixels source = randomPixels(random, true);
+            Pixels straightSource = randomPixels(random, false);
+
+            uint32_t value = (uint32_t)random();
+            compareWithScalar(level, "fillSpan", destination, source, [=](uint32_t* target, uint32_t*) {
+                frag::fillSpan(target + offset, count, value);
+            });
+
+            uint32_t color = randomPremultiplied(random);
+            compareWithScalar(level, "blendSpan", destination, source, [=](uint32_t* target, uint32_t*) {
+                frag::blendSpan(target + offset, count, color);
+            });
+
+            compareWithScalar(level, "blendPixels", destination, source, [=](uint32_t* target, uint32_t* pixels) {
+                frag::blendPixels(target + offset, pixels + sourceOffset, count);
+            });
+
+            // The weight of the last pixel must not go above 256 (see gradientSpan)
+            uint32_t fromColor = randomPremultiplied(random);
+            uint32_t toColor = randomPremultiplied(random);
+            uint32_t position = random() % ((256u << 16) + 1);
+            uint32_t step = count > 1 ? random() % (((256u << 16) - position) / (uint32_t)(count - 1) + 1) : random() % (1u << 16);
+            compareWithScalar(level, "gradientSpan", destination, source, [=](uint32_t* target, uint32_t*) {
+                frag::gradientSpan(target + offset, count, fromColor, toColor, position, step);
+            });
+
+            compareWithScalar(level, "swapRedBlue", destination, straightSource, [=](uint32_t* target, uint32_t* pixels) {
+                frag::swapRedBlue(target + offset, pixels + sourceOffset, count);
+            });
+            compareWithScalar(level, "swapRedBlue_in_place", destination, straightSource, [=](uint32_t*, uint32_t* pixels) {
+                frag::swapRedBlue(pixels + offset, pixels + offset, count);
+            });
+
+            compareWithScalar(level, "premultiplyPixels", destination, straightSource, [=](uint32_t* target, uint32_t* pixels) {
+                frag::premultiplyPixels(target + offset, pixels + sourceOffset, count);
+            });
+            compareWithScalar(level, "premultiplyPixels_in_place", destination, straightSource, [=](uint32_t*, uint32_t* pixels) {
+                frag::premultiplyPixels(pixels + offset, pixels + offset, count);
+            });
+
+            // Every pair of formats, premultiplied ones only get premultiplied pixels
+            for (frag::PixelFormat from : PIXEL_FORMATS) {
+                for (frag::PixelFormat to : PIXEL_FORMATS) {
+                    const Pixels& pixels = frag::isPremultiplied(from) ? source : straightSource;
+                    std::string name = "convertPixels_" + std::to_string((int)from) + "_to_" + std::to_string((int)to);
+                    compareWithScalar(level, name, destination, pixels, [=](uint32_t* target, uint32_t* input) {
+                        frag::convertPixels(target + offset, input + sourceOffset, count, from, to);
+                    });
+                    compareWithScalar(level, name + "_in_place", destination, pixels, [=](uint32_t*, uint32_t* input) {
+                        frag::convertPixels(input + offset, input + offset, count, from, to);
+                    });
+                }
+            }
+
+            // One failing case is enough to know, the rest would just repeat it
+            if (failures > failuresBefore) break;
+        }
+        std::printf("%-8s kernels: %s\n", frag::getSimdLevelName(level), failures > failuresBefore ? "FAILED" : "ok");
+    }
+
+    // -- SoftwareRenderModule frame --
+
+    constexpr int FRAME_WIDTH = 317;   // Not a multiple of the tile size or of a SIMD register
+    constexpr int FRAME_HEIGHT = 203;
+
+    // Draws the same frame with a fixed seed: opaque, translucent, clipped and gradient fills
+    Pixels renderFrame(frag::SimdLevel level, frag::JobSystem* jobSystem) {
+        frag::setSimdLevel(level);
+        frag::SoftwareRenderModule module;
+        auto result = module.init(frag::RenderSettings{ FRAME_WIDTH, FRAME_HEIGHT, 100, jobSystem });
+        if (!result) {
+            std::printf("FAILED frame/%s: cannot set up the software renderer: %s\n", frag::getSimdLevelName(level), result.error().c_str());
+            failures++;
+            return {};
+        }
+
+        std::mt19937 random(99);
+        auto randomColor = [&random](uint8_t alpha) {
+            return frag::Color{ (uint8_t)random(), (uint8_t)random(), (uint8_t)random(), alpha };
+        };
+
+        module.fillColor(frag::Color{ 30, 40, 50 });
+        for (int i = 0; i < 300; i++) {
+            int x = (int)(random() % (FRAME_WIDTH + 80)) - 40;
+            int y = (int)(random() % (FRAME_HEIGHT + 80)) - 40;
+            int w = 1 + (int)(random() % 90);
+            int h = 1 + (int)(random() % 90);
+            switch (i % 3) {
+                case 0: module.fillRect(randomColor(255), x, y, w, h); break;
+                case 1: module.fillRect(randomColor((uint8_t)random()), x, y, w, h); break;
+                case 2: module.fillGradientRect(randomColor((uint8_t)random()), randomColor((uint8_t)random()), x, y, w, h); break;
+            }
+        }
+        std::vector<frag::RectInstance> rects;
+        for (int i = 0; i < 200; i++) {
+            rects.push_back({ (int)(random() % FRAME_WIDTH) - 8, (int)(random() % FRAME_HEIGHT) - 8, 1 + (int)(random() % 40), 1 + (int)(random() % 40),
+                randomColor(i % 2 == 0 ? 255 : (uint8_t)random()) });
+        }
+        module.fillRects(rects);
+        module.swapBuffers();
+
+        // Only the visible pixels, not the padding of the rows
+        Pixels frame;
+        frame.reserve((size_t)FRAME_WIDTH * FRAME_HEIGHT);
+        for (int y = 0; y < FRAME_HEIGHT; y++) {
+            const uint32_t* row = module.getFrontBuffer() + (size_t)y * module.getPitch();
+            frame.insert(frame.end(), row, row + FRAME_WIDTH);
+        }
+        return frame;
+    }
+
+    void testFrame(frag::SimdLevel level, const Pixels& expected, frag::JobSystem* jobSystem, const char* threads) {
+        Pixels frame = renderFrame(level, jobSystem);
+        if (frame.empty()) return;
+
+        for (size_t i = 0; i < frame.size(); i++) {
+            if (frame[i] == expected[i]) continue;
+            std::printf("FAILED frame/%s/%s: pixel (%zu, %zu) is %08X, the scalar frame has %08X\n", frag::getSimdLevelName(level), threads,
+                i % FRAME_WIDTH, i / FRAME_WIDTH, frame[i], expected[i]);
+            failures++;
+            return;
+        }
+        std::printf("%-8s frame (%s): ok\n", frag::getSimdLevelName(level), threads);
+    }
+}
+
+int main() {
+    frag::SimdLevel supported = frag::getSupportedSimdLevel();
+    std::printf("Supported SIMD level: %s\n", frag::getSimdLevelName(supported));
+
+    for (int level = 0; level <= (int)supported; level++) {
+        testKernels((frag::SimdLevel)level);
+    }
+
+    // Reference is the scalar frame drawn on the calling thread only
+    Pixels expected = renderFrame(frag::SimdLevel::SCALAR, nullptr);
+    if (!expected.empty()) {
+        frag::JobSystem jobSystem{ 4 };
+        for (int level = 0; level <= (int)supported; level++) {
+            testFrame((frag::SimdLevel)level, expected, nullptr, "1 thread");
+            testFrame((frag::SimdLevel)level, expected, &jobSystem, "job system");
+        }
+    }
+
+    frag::setSimdLevel(supported);
+    if (failures > 0) {
+        std::printf("%d check(s) FAILED\n", failures);
+        return 1;
+    }
+    std::printf("All checks passed\n");
+    return 0;
+}